@@ -43,7 +43,7 @@ static void gears_glsm_draincache(gears_glsm_t* self)
 	{
 		v = (cc_vec3f_t*)
 		    cc_list_remove(self->cache_vb, &iter);
-		FREE(v);
+		cc_pool_free(self->pool, v);
 	}
 
 	// empty the nb list
@@ -52,7 +52,7 @@ static void gears_glsm_draincache(gears_glsm_t* self)
 	{
 		v = (cc_vec3f_t*)
 		    cc_list_remove(self->cache_nb, &iter);
-		FREE(v);
+		cc_pool_free(self->pool, v);
 	}
 }
 
@@ -89,6 +89,12 @@ gears_glsm_t* gears_glsm_new(void)
 	self->nb       = NULL;
 	self->status   = GEARS_GLSM_INCOMPLETE;
 
+	self->pool = cc_pool_new(sizeof(cc_vec3f_t), 256);
+	if(self->pool == NULL)
+	{
+		goto fail_pool;
+	}
+
 	self->cache_vb = cc_list_new();
 	if(self->cache_vb == NULL)
 	{
@@ -108,6 +114,8 @@ gears_glsm_t* gears_glsm_new(void)
 	fail_cache_nb:
 		cc_list_delete(&self->cache_vb);
 	fail_cache_vb:
+		cc_pool_delete(&self->pool);
+	fail_pool:
 		FREE(self);
 	return NULL;
 }
@@ -123,6 +131,7 @@ void gears_glsm_delete(gears_glsm_t** _self)
 		gears_glsm_draincache(self);
 		cc_list_delete(&self->cache_vb);
 		cc_list_delete(&self->cache_nb);
+		cc_pool_delete(&self->pool);
 		gears_glsm_freebuffers(self);
 		FREE(self);
 		*_self = NULL;
@@ -166,10 +175,10 @@ void gears_glsm_vertex3f(gears_glsm_t* self, float x, float y, float z)
 	}
 
 	cc_vec3f_t* v;
-	v = (cc_vec3f_t*) CALLOC(1, sizeof(cc_vec3f_t));
+	v = (cc_vec3f_t*) cc_pool_alloc(self->pool);
 	if(v == NULL)
 	{
-		LOGE("CALLOC failed");
+		LOGE("cc_pool_alloc failed");
 		goto fail_malloc_v;
 	}
 	v->x = x;
@@ -183,10 +192,10 @@ void gears_glsm_vertex3f(gears_glsm_t* self, float x, float y, float z)
 	}
 
 	cc_vec3f_t* n;
-	n = (cc_vec3f_t*) CALLOC(1, sizeof(cc_vec3f_t));
+	n = (cc_vec3f_t*) cc_pool_alloc(self->pool);
 	if(n == NULL)
 	{
-		LOGE("CALLOC failed");
+		LOGE("cc_pool_alloc failed");
 		goto fail_malloc_n;
 	}
 	n->x = self->normal.x;
@@ -204,11 +213,11 @@ void gears_glsm_vertex3f(gears_glsm_t* self, float x, float y, float z)
 
 	// failure
 	fail_append_nb:
-		FREE(n);
+		cc_pool_free(self->pool, n);
 	fail_malloc_n:
 		// cache drained below
 	fail_append_vb:
-		FREE(v);
+		cc_pool_free(self->pool, v);
 	fail_malloc_v:
 		gears_glsm_draincache(self);
 		self->status = GEARS_GLSM_ERROR;
@@ -268,8 +277,8 @@ void gears_glsm_end(gears_glsm_t* self)
 		self->nb[3 * vi + 2] = n->z;
 
 		// free the cache as we go
-		FREE(v);
-		FREE(n);
+		cc_pool_free(self->pool, v);
+		cc_pool_free(self->pool, n);
 	}
 
 	// success
@@ -278,7 +287,7 @@ void gears_glsm_end(gears_glsm_t* self)
 
 	// failure
 	fail_norm:
-		FREE(v);
+		cc_pool_free(self->pool, v);
 	fail_vert:
 		gears_glsm_freebuffers(self);
 	fail_malloc:
@@ -28,6 +28,7 @@
 
 #include "libcc/math/cc_vec3f.h"
 #include "libcc/cc_list.h"
+#include "libcc/cc_pool.h"
 
 #define GEARS_GLSM_COMPLETE   0
 #define GEARS_GLSM_INCOMPLETE 1
@@ -39,6 +40,7 @@ typedef struct
 	// state
 	int status;
 	cc_vec3f_t normal;
+	cc_pool_t* pool;       // cache vertex/normal allocator
 	cc_list_t* cache_vb;   // vertex(s)
 	cc_list_t* cache_nb;   // normal(s)
 
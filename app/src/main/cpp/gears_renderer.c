@@ -270,9 +270,10 @@ gears_renderer_newImage(gears_renderer_t* self)
 		return 0;
 	}
 
-	size_t size = 0;
-	void*  data = NULL;
-	if(bfs_file_blobGet(bfs, 0, "textures/lava.png",
+	// decode directly from the store
+	size_t      size = 0;
+	const void* data = NULL;
+	if(bfs_file_blobMap(bfs, 0, "textures/lava.png",
 	                    &size, &data) == 0)
 	{
 		goto fail_get;
@@ -281,11 +282,13 @@ gears_renderer_newImage(gears_renderer_t* self)
 	// check for empty data
 	if(size == 0)
 	{
+		bfs_file_blobUnmap(bfs, 0);
 		goto fail_empty;
 	}
 
 	texgz_tex_t* tex;
 	tex = texgz_png_importd(size, data);
+	bfs_file_blobUnmap(bfs, 0);
 	if(tex == NULL)
 	{
 		goto fail_import;
@@ -309,7 +312,6 @@ gears_renderer_newImage(gears_renderer_t* self)
 	}
 
 	texgz_tex_delete(&tex);
-	FREE(data);
 	bfs_file_close(&bfs);
 
 	// success
@@ -321,7 +323,6 @@ gears_renderer_newImage(gears_renderer_t* self)
 		texgz_tex_delete(&tex);
 	fail_import:
 	fail_empty:
-		FREE(data);
 	fail_get:
 		bfs_file_close(&bfs);
 	return 0;
@@ -31,12 +31,36 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "libbfs/bfs_codec.h"
 #include "libbfs/bfs_file.h"
 #include "libbfs/bfs_util.h"
 
 #define LOG_TAG "bfs"
 #include "libcc/cc_log.h"
 #include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "libcc/cc_workq.h"
+
+typedef struct
+{
+	bfs_file_t* bfs;
+	int         store;
+	bfs_codec_e codec;
+
+	// updated by bfs_import_finish
+	int    files;
+	int    errors;
+	size_t bytes;
+} bfs_import_t;
+
+typedef struct
+{
+	// size is set by bfs_import_run
+	// name is the path relative to the import DIR
+	size_t size;
+	char   path[256];
+	char   name[256];
+} bfs_importFile_t;
 
 /***********************************************************
 * private                                                  *
@@ -56,7 +80,9 @@ static void usage(const char* argv0)
 	LOGE("   blobList");
 	LOGE("   blobGet NAME [OUTPUT]");
 	LOGE("   blobSet NAME [INPUT]");
+	LOGE("   blobStore CODEC NAME [INPUT]");
 	LOGE("   blobClr NAME");
+	LOGE("   import DIR [CODEC]");
 }
 
 static int bfs_mkdir(const char* fname)
@@ -98,6 +124,251 @@ static int bfs_mkdir(const char* fname)
 	return 1;
 }
 
+static void* bfs_readFile(const char* input, size_t* _size)
+{
+	ASSERT(input);
+	ASSERT(_size);
+
+	FILE* f = fopen(input, "r");
+	if(f == NULL)
+	{
+		LOGE("fopen %s failed", input);
+		return NULL;
+	}
+
+	// get file size
+	if(fseek(f, (long) 0, SEEK_END) == -1)
+	{
+		LOGE("fseek failed");
+		goto fail_seek;
+	}
+	size_t size = ftell(f);
+
+	// rewind to start
+	if(fseek(f, 0, SEEK_SET) == -1)
+	{
+		LOGE("fseek failed");
+		goto fail_seek;
+	}
+
+	// allocate buffer
+	void* data = CALLOC(1, size);
+	if(data == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_data;
+	}
+
+	// read data
+	if(fread(data, size, 1, f) != 1)
+	{
+		LOGE("fread failed");
+		goto fail_read;
+	}
+
+	fclose(f);
+
+	*_size = size;
+
+	// success
+	return data;
+
+	// failure
+	fail_read:
+		FREE(data);
+	fail_data:
+	fail_seek:
+		fclose(f);
+	return NULL;
+}
+
+static int bfs_import_run(int tid, void* owner, void* task)
+{
+	ASSERT(owner);
+	ASSERT(task);
+
+	bfs_import_t*     import = (bfs_import_t*) owner;
+	bfs_importFile_t* file   = (bfs_importFile_t*) task;
+
+	// files are read and compressed in parallel while the
+	// writes are serialized by the bfs file
+	size_t size = 0;
+	void*  data = bfs_readFile(file->path, &size);
+	if(data == NULL)
+	{
+		return 0;
+	}
+
+	int ret;
+	if(import->store)
+	{
+		ret = bfs_file_blobStore(import->bfs, file->name,
+		                         import->codec, size, data);
+	}
+	else
+	{
+		ret = bfs_file_blobSet(import->bfs, file->name,
+		                       size, data);
+	}
+	FREE(data);
+
+	file->size = size;
+
+	return ret;
+}
+
+static void
+bfs_import_finish(void* owner, void* task, int status)
+{
+	ASSERT(owner);
+	ASSERT(task);
+
+	bfs_import_t*     import = (bfs_import_t*) owner;
+	bfs_importFile_t* file   = (bfs_importFile_t*) task;
+
+	if(status == CC_WORKQ_STATUS_COMPLETE)
+	{
+		++import->files;
+		import->bytes += file->size;
+	}
+	else
+	{
+		LOGE("import %s failed", file->name);
+		++import->errors;
+	}
+
+	FREE(file);
+}
+
+static int
+bfs_import_walk(bfs_import_t* import, cc_workq_t* workq,
+                const char* path, const char* prefix)
+{
+	ASSERT(import);
+	ASSERT(workq);
+	ASSERT(path);
+	ASSERT(prefix);
+
+	DIR* dir = opendir(path);
+	if(dir == NULL)
+	{
+		LOGE("opendir %s failed", path);
+		return 0;
+	}
+
+	int               ret = 1;
+	struct dirent*    de  = readdir(dir);
+	struct stat       st;
+	bfs_importFile_t* file;
+	char              fpath[256];
+	char              name[256];
+	while(de)
+	{
+		// skip hidden files and directories
+		if(de->d_name[0] == '.')
+		{
+			de = readdir(dir);
+			continue;
+		}
+
+		if((snprintf(fpath, 256, "%s/%s", path,
+		             de->d_name) >= 256) ||
+		   (snprintf(name, 256, "%s%s%s", prefix,
+		             prefix[0] ? "/" : "",
+		             de->d_name) >= 256))
+		{
+			LOGE("invalid %s/%s", path, de->d_name);
+			ret = 0;
+		}
+		else if(stat(fpath, &st) == -1)
+		{
+			LOGE("stat %s failed", fpath);
+			ret = 0;
+		}
+		else if(S_ISDIR(st.st_mode))
+		{
+			ret &= bfs_import_walk(import, workq, fpath, name);
+		}
+		else if(S_ISREG(st.st_mode))
+		{
+			file = (bfs_importFile_t*)
+			       CALLOC(1, sizeof(bfs_importFile_t));
+			if(file == NULL)
+			{
+				LOGE("CALLOC failed");
+				ret = 0;
+				break;
+			}
+			snprintf(file->path, 256, "%s", fpath);
+			snprintf(file->name, 256, "%s", name);
+
+			if(cc_workq_run(workq, (void*) file,
+			                0) == CC_WORKQ_STATUS_ERROR)
+			{
+				FREE(file);
+				ret = 0;
+				break;
+			}
+		}
+
+		de = readdir(dir);
+	}
+
+	closedir(dir);
+
+	return ret;
+}
+
+static int
+bfs_import(bfs_file_t* bfs, const char* path, int store,
+           bfs_codec_e codec)
+{
+	ASSERT(bfs);
+	ASSERT(path);
+
+	bfs_import_t import =
+	{
+		.bfs   = bfs,
+		.store = store,
+		.codec = codec,
+	};
+
+	int nth = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if(nth < 1)
+	{
+		nth = 1;
+	}
+
+	double t0 = cc_timestamp();
+
+	cc_workq_t* workq;
+	workq = cc_workq_new((void*) &import, nth,
+	                     CC_WORKQ_THREAD_PRIORITY_DEFAULT,
+	                     bfs_import_run, bfs_import_finish);
+	if(workq == NULL)
+	{
+		return 0;
+	}
+
+	int ret = bfs_import_walk(&import, workq, path, "");
+	cc_workq_finish(workq);
+	cc_workq_delete(&workq);
+
+	ret &= bfs_file_flush(bfs);
+
+	double dt = cc_timestamp() - t0;
+	printf("imported %i files, %" PRIu64 " bytes, "
+	       "%i threads, %0.3lf seconds\n",
+	       import.files, (uint64_t) import.bytes, nth, dt);
+
+	if(import.errors)
+	{
+		ret = 0;
+	}
+
+	return ret;
+}
+
 static int
 bfs_attr_list(void* priv, const char* key, const char* val)
 {
@@ -319,18 +590,30 @@ int main(int argc, char** argv)
 		fclose(f);
 		FREE(data);
 	}
-	else if(strcmp(cmd, "blobSet") == 0)
+	else if((strcmp(cmd, "blobSet") == 0) ||
+	        (strcmp(cmd, "blobStore") == 0))
 	{
-		char* name  = argv[3];
-		char* input = NULL;
-		if(argc == 5)
+		// blobStore has an additional CODEC argument
+		int         store = (strcmp(cmd, "blobStore") == 0);
+		int         a     = store ? 4 : 3;
+		bfs_codec_e codec = BFS_CODEC_NONE;
+		char*       name  = NULL;
+		char*       input = NULL;
+		if(store &&
+		   ((argc < 5) ||
+		    (bfs_codec_parse(argv[3], &codec) == 0)))
+		{
+			usage(arg0);
+			goto fail_shutdown;
+		}
+		else if(argc == a + 2)
 		{
-			name  = argv[3];
-			input = argv[4];
+			name  = argv[a];
+			input = argv[a + 1];
 		}
-		else if(argc == 4)
+		else if(argc == a + 1)
 		{
-			name  = argv[3];
+			name  = argv[a];
 			input = name;
 		}
 		else
@@ -345,74 +628,90 @@ int main(int argc, char** argv)
 			goto fail_shutdown;
 		}
 
-		FILE* f = fopen(input, "r");
-		if(f == NULL)
+		size_t size = 0;
+		void*  data = bfs_readFile(input, &size);
+		if(data == NULL)
 		{
-			LOGE("fopen %s failed", input);
 			goto fail_cmd;
 		}
 
-		// get file size
-		if(fseek(f, (long) 0, SEEK_END) == -1)
+		int ret;
+		if(store)
 		{
-			LOGE("fseek failed");
-			fclose(f);
-			goto fail_cmd;
+			ret = bfs_file_blobStore(bfs, name, codec,
+			                         size, data);
 		}
-		size_t size = ftell(f);
-
-		// rewind to start
-		if(fseek(f, 0, SEEK_SET) == -1)
+		else
 		{
-			LOGE("fseek failed");
-			fclose(f);
-			goto fail_cmd;
+			ret = bfs_file_blobSet(bfs, name, size, data);
 		}
 
-		// allocate buffer
-		void* data = CALLOC(1, size);
-		if(data == NULL)
+		FREE(data);
+
+		if(ret == 0)
 		{
-			LOGE("CALLOC failed");
-			fclose(f);
 			goto fail_cmd;
 		}
+	}
+	else if(strcmp(cmd, "blobClr") == 0)
+	{
+		if(argc != 4)
+		{
+			usage(arg0);
+			goto fail_shutdown;
+		}
 
-		// read data
-		if(fread(data, size, 1, f) != 1)
+		bfs = bfs_file_open(fname, 1, BFS_MODE_RDWR);
+		if(bfs == NULL)
 		{
-			LOGE("fread failed");
-			FREE(data);
-			fclose(f);
-			goto fail_cmd;
+			goto fail_shutdown;
 		}
 
-		if(bfs_file_blobSet(bfs, name, size, data) == 0)
+		char* name = argv[3];
+		if(bfs_file_blobClr(bfs, name) == 0)
 		{
-			FREE(data);
-			fclose(f);
 			goto fail_cmd;
 		}
-
-		FREE(data);
-		fclose(f);
 	}
-	else if(strcmp(cmd, "blobClr") == 0)
+	else if(strcmp(cmd, "import") == 0)
 	{
-		if(argc != 4)
+		// import stores the files when a CODEC is specified
+		int         store = 0;
+		bfs_codec_e codec = BFS_CODEC_NONE;
+		if(argc == 5)
+		{
+			if(bfs_codec_parse(argv[4], &codec) == 0)
+			{
+				usage(arg0);
+				goto fail_shutdown;
+			}
+			store = 1;
+		}
+		else if(argc != 4)
 		{
 			usage(arg0);
 			goto fail_shutdown;
 		}
 
-		bfs = bfs_file_open(fname, 1, BFS_MODE_RDWR);
+		// names are relative to DIR so trailing slashes are
+		// removed before the paths are joined
+		char path[256];
+		snprintf(path, 256, "%s", argv[3]);
+		size_t len = strlen(path);
+		while((len > 1) && (path[len - 1] == '/'))
+		{
+			path[--len] = '\0';
+		}
+
+		// files are written in batched transactions which
+		// replace the existing names
+		bfs = bfs_file_open(fname, 1, BFS_MODE_STREAM);
 		if(bfs == NULL)
 		{
 			goto fail_shutdown;
 		}
 
-		char* name = argv[3];
-		if(bfs_file_blobClr(bfs, name) == 0)
+		if(bfs_import(bfs, path, store, codec) == 0)
 		{
 			goto fail_cmd;
 		}
@@ -0,0 +1,33 @@
+#!/bin/sh
+# round trip files through import and blobGet where the
+# names are relative to DIR
+
+BFS=$(pwd)/bfs
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+set -e
+mkdir -p "$TMP/dir/sub"
+echo "readme" > "$TMP/dir/readme.txt"
+echo "sub"    > "$TMP/dir/sub/sub.txt"
+
+check()
+{
+	for NAME in readme.txt sub/sub.txt; do
+		"$BFS" "$TMP/test.bfs" blobGet "$NAME" "$TMP/out"
+		cmp "$TMP/dir/$NAME" "$TMP/out"
+	done
+}
+
+# new file imported from the current directory
+cd "$TMP/dir"
+"$BFS" "$TMP/test.bfs" import .
+check
+
+# existing file imported with a codec replaces the names
+echo "changed" > "$TMP/dir/readme.txt"
+cd "$TMP"
+"$BFS" "$TMP/test.bfs" import dir/ zlib
+check
+
+echo "test-import ok"
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define LOG_TAG "bfs"
+#include "../libcc/cc_log.h"
+#include "bfs_codec.h"
+
+// the LZ4 codec uses the LZ4 block format which ends with
+// at least 5 literals and where the last match starts at
+// least 12 bytes before the end of the block
+#define BFS_CODEC_LZ4_HASH_BITS    12
+#define BFS_CODEC_LZ4_MINMATCH     4
+#define BFS_CODEC_LZ4_LASTLITERALS 5
+#define BFS_CODEC_LZ4_MFLIMIT      12
+#define BFS_CODEC_LZ4_MAXOFFSET    65535
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static uint32_t bfs_codec_read32(const uint8_t* p)
+{
+	ASSERT(p);
+
+	uint32_t v;
+	memcpy(&v, p, sizeof(uint32_t));
+	return v;
+}
+
+static size_t
+bfs_codec_lz4Length(uint8_t* dst, size_t len)
+{
+	ASSERT(dst);
+
+	// length extension bytes following the token
+	size_t n = 0;
+	len -= 15;
+	while(len >= 255)
+	{
+		dst[n++] = 255;
+		len     -= 255;
+	}
+	dst[n++] = (uint8_t) len;
+	return n;
+}
+
+static int
+bfs_codec_lz4Sequence(uint8_t* dst, size_t cap,
+                      size_t* _op, const uint8_t* lit,
+                      size_t lit_len, size_t offset,
+                      size_t match_len)
+{
+	ASSERT(dst);
+	ASSERT(_op);
+	ASSERT(lit);
+
+	// worst case size of the sequence
+	size_t op   = *_op;
+	size_t need = 1 + lit_len/255 + 1 + lit_len +
+	              2 + match_len/255 + 1;
+	if(op + need > cap)
+	{
+		return 0;
+	}
+
+	// match_len is 0 for the last sequence
+	size_t   ml    = match_len ? match_len - BFS_CODEC_LZ4_MINMATCH : 0;
+	uint8_t* token = &dst[op++];
+	*token = (uint8_t) (((lit_len < 15) ? lit_len : 15) << 4);
+	if(lit_len >= 15)
+	{
+		op += bfs_codec_lz4Length(&dst[op], lit_len);
+	}
+	memcpy(&dst[op], lit, lit_len);
+	op += lit_len;
+
+	if(match_len)
+	{
+		dst[op++] = (uint8_t) (offset & 0xFF);
+		dst[op++] = (uint8_t) (offset >> 8);
+		*token   |= (uint8_t) ((ml < 15) ? ml : 15);
+		if(ml >= 15)
+		{
+			op += bfs_codec_lz4Length(&dst[op], ml);
+		}
+	}
+
+	*_op = op;
+	return 1;
+}
+
+static size_t
+bfs_codec_lz4Encode(size_t size, const uint8_t* src,
+                    size_t cap, uint8_t* dst)
+{
+	ASSERT(src);
+	ASSERT(dst);
+
+	// false matches from the zero initialized table are
+	// rejected by comparing the data
+	uint32_t table[1 << BFS_CODEC_LZ4_HASH_BITS];
+	memset(table, 0, sizeof(table));
+
+	size_t ip     = 0;
+	size_t op     = 0;
+	size_t anchor = 0;
+	if(size > BFS_CODEC_LZ4_MFLIMIT)
+	{
+		size_t mflimit = size - BFS_CODEC_LZ4_MFLIMIT;
+		size_t mlimit  = size - BFS_CODEC_LZ4_LASTLITERALS;
+		while(ip < mflimit)
+		{
+			uint32_t seq = bfs_codec_read32(&src[ip]);
+			uint32_t h   = (seq*2654435761U) >>
+			               (32 - BFS_CODEC_LZ4_HASH_BITS);
+			size_t   ref = table[h];
+			table[h] = (uint32_t) ip;
+
+			if((ref >= ip) ||
+			   (ip - ref > BFS_CODEC_LZ4_MAXOFFSET) ||
+			   (bfs_codec_read32(&src[ref]) != seq))
+			{
+				++ip;
+				continue;
+			}
+
+			size_t len = BFS_CODEC_LZ4_MINMATCH;
+			while((ip + len < mlimit) &&
+			      (src[ref + len] == src[ip + len]))
+			{
+				++len;
+			}
+
+			if(bfs_codec_lz4Sequence(dst, cap, &op,
+			                         &src[anchor], ip - anchor,
+			                         ip - ref, len) == 0)
+			{
+				return 0;
+			}
+
+			ip    += len;
+			anchor = ip;
+		}
+	}
+
+	if(bfs_codec_lz4Sequence(dst, cap, &op, &src[anchor],
+	                         size - anchor, 0, 0) == 0)
+	{
+		return 0;
+	}
+
+	return op;
+}
+
+static int
+bfs_codec_lz4Extend(size_t csize, const uint8_t* src,
+                    size_t* _ip, size_t* _len)
+{
+	ASSERT(src);
+	ASSERT(_ip);
+	ASSERT(_len);
+
+	size_t  ip = *_ip;
+	uint8_t b;
+	do
+	{
+		if(ip >= csize)
+		{
+			return 0;
+		}
+		b      = src[ip++];
+		*_len += b;
+	} while(b == 255);
+
+	*_ip = ip;
+	return 1;
+}
+
+static int
+bfs_codec_lz4Decode(size_t csize, const uint8_t* src,
+                    size_t size, uint8_t* dst)
+{
+	ASSERT(src);
+	ASSERT(dst);
+
+	size_t ip = 0;
+	size_t op = 0;
+	while(ip < csize)
+	{
+		uint8_t token   = src[ip++];
+		size_t  lit_len = token >> 4;
+		if((lit_len == 15) &&
+		   (bfs_codec_lz4Extend(csize, src, &ip,
+		                        &lit_len) == 0))
+		{
+			return 0;
+		}
+
+		if((lit_len > csize - ip) || (lit_len > size - op))
+		{
+			return 0;
+		}
+		memcpy(&dst[op], &src[ip], lit_len);
+		ip += lit_len;
+		op += lit_len;
+
+		// the last sequence has no match
+		if(ip == csize)
+		{
+			break;
+		}
+		else if(csize - ip < 2)
+		{
+			return 0;
+		}
+
+		size_t offset = ((size_t) src[ip]) |
+		                (((size_t) src[ip + 1]) << 8);
+		ip += 2;
+
+		size_t match_len = token & 0x0F;
+		if((match_len == 15) &&
+		   (bfs_codec_lz4Extend(csize, src, &ip,
+		                        &match_len) == 0))
+		{
+			return 0;
+		}
+		match_len += BFS_CODEC_LZ4_MINMATCH;
+
+		if((offset == 0) || (offset > op) ||
+		   (match_len > size - op))
+		{
+			return 0;
+		}
+
+		// matches may overlap the output
+		const uint8_t* match = &dst[op - offset];
+		if(offset >= match_len)
+		{
+			memcpy(&dst[op], match, match_len);
+		}
+		else
+		{
+			size_t i;
+			for(i = 0; i < match_len; ++i)
+			{
+				dst[op + i] = match[i];
+			}
+		}
+		op += match_len;
+	}
+
+	return (op == size) ? 1 : 0;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+size_t bfs_codec_encode(bfs_codec_e codec, size_t size,
+                        const void* src, void* dst)
+{
+	ASSERT(src);
+	ASSERT(dst);
+
+	// the encoded data must be smaller than the source
+	if(size < 2)
+	{
+		return 0;
+	}
+
+	size_t cap = size - 1;
+	if(codec == BFS_CODEC_ZLIB)
+	{
+		uLongf dst_len = (uLongf) cap;
+		if(compress2((Bytef*) dst, &dst_len,
+		             (const Bytef*) src, (uLong) size,
+		             Z_BEST_COMPRESSION) != Z_OK)
+		{
+			return 0;
+		}
+		return (size_t) dst_len;
+	}
+	else if(codec == BFS_CODEC_LZ4)
+	{
+		return bfs_codec_lz4Encode(size, (const uint8_t*) src,
+		                           cap, (uint8_t*) dst);
+	}
+
+	return 0;
+}
+
+int bfs_codec_decode(bfs_codec_e codec, size_t csize,
+                     const void* src, size_t size,
+                     void* dst)
+{
+	ASSERT(src);
+	ASSERT(dst);
+
+	if(codec == BFS_CODEC_NONE)
+	{
+		if(csize != size)
+		{
+			LOGE("invalid csize=%u, size=%u",
+			     (unsigned int) csize, (unsigned int) size);
+			return 0;
+		}
+		memcpy(dst, src, size);
+		return 1;
+	}
+	else if(codec == BFS_CODEC_ZLIB)
+	{
+		uLongf dst_len = (uLongf) size;
+		if((uncompress((Bytef*) dst, &dst_len,
+		               (const Bytef*) src,
+		               (uLong) csize) != Z_OK) ||
+		   (dst_len != (uLongf) size))
+		{
+			LOGE("uncompress failed");
+			return 0;
+		}
+		return 1;
+	}
+	else if(codec == BFS_CODEC_LZ4)
+	{
+		if(bfs_codec_lz4Decode(csize, (const uint8_t*) src,
+		                       size, (uint8_t*) dst) == 0)
+		{
+			LOGE("invalid lz4 data");
+			return 0;
+		}
+		return 1;
+	}
+
+	LOGE("invalid codec=%i", (int) codec);
+	return 0;
+}
+
+int bfs_codec_parse(const char* str, bfs_codec_e* _codec)
+{
+	ASSERT(str);
+	ASSERT(_codec);
+
+	if(strcmp(str, "none") == 0)
+	{
+		*_codec = BFS_CODEC_NONE;
+	}
+	else if(strcmp(str, "zlib") == 0)
+	{
+		*_codec = BFS_CODEC_ZLIB;
+	}
+	else if(strcmp(str, "lz4") == 0)
+	{
+		*_codec = BFS_CODEC_LZ4;
+	}
+	else
+	{
+		LOGE("invalid codec=%s", str);
+		return 0;
+	}
+
+	return 1;
+}
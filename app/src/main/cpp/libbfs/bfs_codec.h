@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef bfs_codec_H
+#define bfs_codec_H
+
+#include <stddef.h>
+
+#include "bfs_file.h"
+
+/*
+ * codec API
+ */
+
+// dst must contain at least size bytes and the encoded size
+// is returned or 0 when the data was not reduced in size
+size_t bfs_codec_encode(bfs_codec_e codec,
+                        size_t size,
+                        const void* src,
+                        void* dst);
+int    bfs_codec_decode(bfs_codec_e codec,
+                        size_t csize,
+                        const void* src,
+                        size_t size,
+                        void* dst);
+int    bfs_codec_parse(const char* str,
+                       bfs_codec_e* _codec);
+
+#endif
@@ -21,6 +21,8 @@
  *
  */
 
+#include <inttypes.h>
+#include <limits.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,18 +32,52 @@
 #define LOG_TAG "bfs"
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
+#include "../libcc/cc_mumurhash3.h"
 #include "../libsqlite3/sqlite3.h"
+#include "bfs_codec.h"
 #include "bfs_file.h"
 
 #define BATCH_SIZE 10000
 
+// memory map read-only files so that small blobs may be
+// accessed directly from the mapped pages
+#define BFS_MMAP_SIZE 0x10000000
+
+// WAL readers may briefly see SQLITE_BUSY while the WAL is
+// recovered or the writer checkpoints
+#define BFS_BUSY_TIMEOUT 1000
+
+// incremental blob handle which may be opened on tbl_blob
+// or on tbl_data for content stored by bfs_file_blobStore
+typedef struct
+{
+	sqlite3_blob* blob;
+	int           data;
+} bfs_fileBlob_t;
+
 typedef struct bfs_file_s
 {
 	int        nth;
 	bfs_mode_e mode;
 
+	// names are replaced unless a new file is streamed since
+	// it has no names or indices to search
+	int replace;
+
 	sqlite3* db;
 
+	// WAL mode uses the db connection for writes and one
+	// read-only connection per thread for reads
+	// db_read is NULL unless opened with BFS_MODE_WAL
+	sqlite3** db_read;
+
+	// content store (tbl_data/tbl_name) which is created by
+	// the first blobStore (atomic)
+	// store_read is set when the per-thread statements were
+	// prepared with the store
+	int  store;
+	int* store_read;
+
 	// sqlite3 statements
 	int            batch_size;
 	sqlite3_stmt*  stmt_begin;
@@ -52,8 +88,21 @@ typedef struct bfs_file_s
 	sqlite3_stmt*  stmt_attr_clr;
 	sqlite3_stmt*  stmt_blob_list;
 	sqlite3_stmt** stmt_blob_get;
+	sqlite3_stmt** stmt_blob_rowid;
 	sqlite3_stmt*  stmt_blob_set;
 	sqlite3_stmt*  stmt_blob_clr;
+	sqlite3_stmt*  stmt_name_add;
+	sqlite3_stmt*  stmt_name_clr;
+	sqlite3_stmt*  stmt_data_find;
+	sqlite3_stmt*  stmt_data_add;
+
+	// incremental blob handles (per thread)
+	// read-only files keep the handles open between
+	// blobOpen/blobClose so they may be reopened
+	bfs_fileBlob_t* blob;
+
+	// decompressed blobs returned by blobMap (per thread)
+	void** buf;
 
 	// sqlite3 indices
 	int idx_attr_get_key;
@@ -61,9 +110,20 @@ typedef struct bfs_file_s
 	int idx_attr_set_val;
 	int idx_attr_clr_key;
 	int idx_blob_get_name;
+	int idx_blob_rowid_name;
 	int idx_blob_set_name;
 	int idx_blob_set_blob;
 	int idx_blob_clr_name;
+	int idx_name_add_name;
+	int idx_name_add_data;
+	int idx_name_clr_name;
+	int idx_data_find_hash;
+	int idx_data_find_size;
+	int idx_data_find_codec;
+	int idx_data_add_hash;
+	int idx_data_add_size;
+	int idx_data_add_codec;
+	int idx_data_add_blob;
 
 	// locking
 	pthread_mutex_t mutex;
@@ -76,11 +136,28 @@ typedef struct bfs_file_s
 * private                                                  *
 ***********************************************************/
 
+static sqlite3* bfs_file_dbRead(bfs_file_t* self, int tid)
+{
+	ASSERT(self);
+
+	if(self->db_read)
+	{
+		return self->db_read[tid];
+	}
+	return self->db;
+}
+
 static void bfs_file_lockRead(bfs_file_t* self)
 {
 	ASSERT(self);
 	ASSERT(self->mode != BFS_MODE_STREAM);
 
+	if(self->mode == BFS_MODE_WAL)
+	{
+		// readers use a snapshot of their own connection
+		return;
+	}
+
 	pthread_mutex_lock(&self->mutex);
 	while(self->exclusive)
 	{
@@ -95,6 +172,11 @@ static void bfs_file_unlockRead(bfs_file_t* self)
 	ASSERT(self);
 	ASSERT(self->mode != BFS_MODE_STREAM);
 
+	if(self->mode == BFS_MODE_WAL)
+	{
+		return;
+	}
+
 	pthread_mutex_lock(&self->mutex);
 	--self->readers;
 	pthread_cond_broadcast(&self->cond);
@@ -105,13 +187,14 @@ static void bfs_file_lockExclusive(bfs_file_t* self)
 {
 	ASSERT(self);
 
-	if(self->mode == BFS_MODE_STREAM)
+	pthread_mutex_lock(&self->mutex);
+	if((self->mode == BFS_MODE_STREAM) ||
+	   (self->mode == BFS_MODE_WAL))
 	{
-		// ignore
+		// only serialize the writer connection
 		return;
 	}
 
-	pthread_mutex_lock(&self->mutex);
 	++self->exclusive;
 	while(self->readers)
 	{
@@ -123,9 +206,10 @@ static void bfs_file_unlockExclusive(bfs_file_t* self)
 {
 	ASSERT(self);
 
-	if(self->mode == BFS_MODE_STREAM)
+	if((self->mode == BFS_MODE_STREAM) ||
+	   (self->mode == BFS_MODE_WAL))
 	{
-		// ignore
+		pthread_mutex_unlock(&self->mutex);
 		return;
 	}
 
@@ -139,11 +223,13 @@ bfs_file_createIndices(bfs_file_t* self)
 {
 	ASSERT(self);
 
+	// the indices may exist when an existing file is opened
+	// in stream mode
 	const char* sql_init[] =
 	{
-		"CREATE UNIQUE INDEX idx_attr_key"
+		"CREATE UNIQUE INDEX IF NOT EXISTS idx_attr_key"
 		"   ON tbl_attr (key);",
-		"CREATE UNIQUE INDEX idx_blob_name"
+		"CREATE UNIQUE INDEX IF NOT EXISTS idx_blob_name"
 		"   ON tbl_blob (name);",
 		NULL
 	};
@@ -202,6 +288,112 @@ bfs_file_createTables(bfs_file_t* self)
 	return 1;
 }
 
+static int
+bfs_file_createStoreIndices(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	const char* sql_index;
+	sql_index = "CREATE UNIQUE INDEX IF NOT EXISTS idx_name_name"
+	            "   ON tbl_name (name);";
+	if(sqlite3_exec(self->db, sql_index, NULL, NULL,
+	                NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_exec: %s", sqlite3_errmsg(self->db));
+		return 0;
+	}
+
+	return 1;
+}
+
+static int
+bfs_file_createStore(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	// tbl_data holds content by hash which is shared by the
+	// names in tbl_name and the triggers delete the content
+	// when it is no longer referenced
+	const char* sql_init[] =
+	{
+		"CREATE TABLE IF NOT EXISTS tbl_data"
+		"("
+		"   hash  INTEGER NOT NULL,"
+		"   size  INTEGER NOT NULL,"
+		"   codec INTEGER NOT NULL,"
+		"   refs  INTEGER NOT NULL,"
+		"   blob  BLOB"
+		");",
+		"CREATE TABLE IF NOT EXISTS tbl_name"
+		"("
+		"   name TEXT NOT NULL,"
+		"   data INTEGER NOT NULL"
+		");",
+		"CREATE INDEX IF NOT EXISTS idx_data_hash"
+		"   ON tbl_data (hash);",
+		"CREATE TRIGGER IF NOT EXISTS trg_name_add"
+		"   AFTER INSERT ON tbl_name"
+		"   BEGIN"
+		"      UPDATE tbl_data SET refs=refs+1"
+		"         WHERE rowid=NEW.data;"
+		"   END;",
+		"CREATE TRIGGER IF NOT EXISTS trg_name_clr"
+		"   AFTER DELETE ON tbl_name"
+		"   BEGIN"
+		"      UPDATE tbl_data SET refs=refs-1"
+		"         WHERE rowid=OLD.data;"
+		"      DELETE FROM tbl_data"
+		"         WHERE rowid=OLD.data AND refs<=0;"
+		"   END;",
+		NULL
+	};
+
+	// init sqlite3
+	int i = 0;
+	while(sql_init[i])
+	{
+		if(sqlite3_exec(self->db, sql_init[i], NULL, NULL,
+		                NULL) != SQLITE_OK)
+		{
+			LOGE("sqlite3_exec(%i): %s",
+			     i, sqlite3_errmsg(self->db));
+			return 0;
+		}
+		++i;
+	}
+
+	// index creation is faster at close in stream mode
+	if(self->mode == BFS_MODE_STREAM)
+	{
+		return 1;
+	}
+
+	return bfs_file_createStoreIndices(self);
+}
+
+static int bfs_file_hasStore(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	const char* sql_store;
+	sql_store = "SELECT name FROM sqlite_master"
+	            "   WHERE type='table' AND name='tbl_data';";
+
+	sqlite3_stmt* stmt = NULL;
+	if(sqlite3_prepare_v2(self->db, sql_store, -1, &stmt,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		return 0;
+	}
+
+	int store = (sqlite3_step(stmt) == SQLITE_ROW) ? 1 : 0;
+	sqlite3_finalize(stmt);
+
+	return store;
+}
+
 static int
 bfs_file_endTransaction(bfs_file_t* self)
 {
@@ -295,150 +487,728 @@ bfs_file_beginTransaction(bfs_file_t* self)
 	return 0;
 }
 
-static int bfs_fileExists(const char* fname)
+static void bfs_file_mmap(sqlite3* db)
 {
-	ASSERT(fname);
+	ASSERT(db);
 
-	if(access(fname, F_OK) != 0)
+	char sql_mmap[256];
+	snprintf(sql_mmap, 256, "PRAGMA mmap_size=%i;",
+	         BFS_MMAP_SIZE);
+	if(sqlite3_exec(db, sql_mmap, NULL, NULL,
+	                NULL) != SQLITE_OK)
 	{
-		return 0;
+		LOGW("sqlite3_exec: %s", sqlite3_errmsg(db));
 	}
-	return 1;
 }
 
-/***********************************************************
-* public                                                   *
-***********************************************************/
-
-bfs_file_t*
-bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
+static int bfs_file_step(bfs_file_t* self, sqlite3_stmt* stmt)
 {
-	ASSERT(fname);
+	ASSERT(self);
+	ASSERT(stmt);
 
-	int flags  = SQLITE_OPEN_READWRITE;
-	int exists = bfs_fileExists(fname);
-	if(mode == BFS_MODE_RDONLY)
+	int ret = 1;
+	if(sqlite3_step(stmt) != SQLITE_DONE)
 	{
-		// database must exist in read-only mode
-		if(exists == 0)
-		{
-			LOGE("invalid %s", fname);
-			return NULL;
-		}
-
-		flags = SQLITE_OPEN_READONLY;
+		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		ret = 0;
 	}
-	else if(mode == BFS_MODE_STREAM)
+
+	if(sqlite3_reset(stmt) != SQLITE_OK)
 	{
-		if(nth != 1)
-		{
-			LOGE("invalid nth=%i", nth);
-			return NULL;
-		}
+		LOGW("sqlite3_reset failed");
 	}
 
-	// create database if needed
-	if(exists == 0)
+	return ret;
+}
+
+static int
+bfs_file_stepName(bfs_file_t* self, sqlite3_stmt* stmt,
+                  int idx_name, const char* name)
+{
+	ASSERT(self);
+	ASSERT(stmt);
+	ASSERT(name);
+
+	if(sqlite3_bind_text(stmt, idx_name, name, -1,
+	                     SQLITE_TRANSIENT) != SQLITE_OK)
 	{
-		flags |= SQLITE_OPEN_CREATE;
+		LOGE("sqlite3_bind_text: %s", sqlite3_errmsg(self->db));
+		return 0;
 	}
 
-	bfs_file_t* self;
-	self = (bfs_file_t*)
-	       CALLOC(1, sizeof(bfs_file_t));
-	if(self == NULL)
+	return bfs_file_step(self, stmt);
+}
+
+static int bfs_file_beginWrite(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	// writes which update multiple tables use a transaction
+	// unless they are batched by the stream mode
+	if(self->mode == BFS_MODE_STREAM)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		return bfs_file_beginTransaction(self);
 	}
 
-	self->nth  = nth;
-	self->mode = mode;
+	return bfs_file_step(self, self->stmt_begin);
+}
 
-	// sqlite3 must be initialized externally
-	if(sqlite3_open_v2(fname, &self->db, flags,
-	                   NULL) != SQLITE_OK)
+static int bfs_file_endWrite(bfs_file_t* self, int ret)
+{
+	ASSERT(self);
+
+	if(self->mode == BFS_MODE_STREAM)
 	{
-		LOGE("sqlite3_open_v2 %s failed", fname);
-		goto fail_db_open;
+		return ret;
+	}
+	else if(ret && bfs_file_step(self, self->stmt_end))
+	{
+		return 1;
 	}
 
-	if(flags & SQLITE_OPEN_CREATE)
+	if(sqlite3_exec(self->db, "ROLLBACK;", NULL, NULL,
+	                NULL) != SQLITE_OK)
 	{
-		if(bfs_file_createTables(self) == 0)
-		{
-			goto fail_initialize;
-		}
+		LOGW("sqlite3_exec: %s", sqlite3_errmsg(self->db));
+	}
 
-		if(mode == BFS_MODE_STREAM)
+	return 0;
+}
+
+static void* bfs_file_buffer(void** _data, size_t size)
+{
+	ASSERT(_data);
+
+	// allocate, grow or reuse the data buffer
+	void* data = *_data;
+	if(data == NULL)
+	{
+		data = CALLOC(1, size);
+		if(data == NULL)
 		{
-			// index creation is faster at close
+			LOGE("CALLOC failed");
+			return NULL;
 		}
-		else if(bfs_file_createIndices(self) == 0)
+		*_data = data;
+	}
+	else if(MEMSIZEPTR(data) < size)
+	{
+		data = REALLOC(*_data, size);
+		if(data == NULL)
 		{
-			goto fail_initialize;
+			LOGE("REALLOC failed");
+			return NULL;
 		}
+		*_data = data;
 	}
 
-	const char* sql_begin = "BEGIN;";
-	if(sqlite3_prepare_v2(self->db, sql_begin, -1,
-	                      &self->stmt_begin,
-	                      NULL) != SQLITE_OK)
-	{
-		LOGE("sqlite3_prepare_v2: %s",
-		     sqlite3_errmsg(self->db));
-		goto fail_prepare_begin;
+	return data;
+}
+
+static int
+bfs_file_dataFind(bfs_file_t* self, uint32_t hash,
+                  size_t size, bfs_codec_e codec,
+                  size_t bytes, const void* blob,
+                  sqlite3_int64* _rowid)
+{
+	ASSERT(self);
+	ASSERT(blob);
+	ASSERT(_rowid);
+
+	*_rowid = 0;
+
+	// content is only shared when the codec matches so that
+	// the codec of each name is the one requested (e.g. so
+	// that BFS_CODEC_NONE blobs support blobOpen)
+	sqlite3_stmt* stmt = self->stmt_data_find;
+	if((sqlite3_bind_int64(stmt, self->idx_data_find_hash,
+	                       (sqlite3_int64) hash) != SQLITE_OK) ||
+	   (sqlite3_bind_int64(stmt, self->idx_data_find_size,
+	                       (sqlite3_int64) size) != SQLITE_OK) ||
+	   (sqlite3_bind_int(stmt, self->idx_data_find_codec,
+	                     (int) codec) != SQLITE_OK))
+	{
+		LOGE("sqlite3_bind: %s", sqlite3_errmsg(self->db));
+		return 0;
 	}
 
-	const char* sql_end = "END;";
-	if(sqlite3_prepare_v2(self->db, sql_end, -1,
-	                      &self->stmt_end,
-	                      NULL) != SQLITE_OK)
+	// compare the encoded content of each candidate since
+	// the hash is not unique and the codecs are deterministic
+	// (a different codec version only causes a duplicate)
+	int ret  = 1;
+	int step = sqlite3_step(stmt);
+	while(step == SQLITE_ROW)
 	{
-		LOGE("sqlite3_prepare_v2: %s",
-		     sqlite3_errmsg(self->db));
-		goto fail_prepare_end;
+		sqlite3_int64 rowid = sqlite3_column_int64(stmt, 0);
+		const void*   data  = sqlite3_column_blob(stmt, 1);
+		int           count = sqlite3_column_bytes(stmt, 1);
+		if(data && ((size_t) count == bytes) &&
+		   (memcmp(data, blob, bytes) == 0))
+		{
+			*_rowid = rowid;
+			break;
+		}
+		step = sqlite3_step(stmt);
 	}
 
-	const char* sql_attr_list;
-	sql_attr_list = "SELECT key, val FROM tbl_attr;";
-	if(sqlite3_prepare_v2(self->db, sql_attr_list, -1,
-	                      &self->stmt_attr_list,
-	                      NULL) != SQLITE_OK)
-	if(self->stmt_attr_list == NULL)
+	if((step != SQLITE_ROW) && (step != SQLITE_DONE))
 	{
-		LOGE("sqlite3_prepare_v2: %s",
-		     sqlite3_errmsg(self->db));
-		goto fail_prepare_attr_list;
+		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		ret = 0;
 	}
 
-	self->stmt_attr_get = (sqlite3_stmt**)
-	                      CALLOC(nth, sizeof(sqlite3_stmt*));
-	if(self->stmt_attr_get == NULL)
+	if(sqlite3_reset(stmt) != SQLITE_OK)
 	{
-		LOGE("CALLOC failed");
-		goto fail_alloc_attr_get;
+		LOGW("sqlite3_reset failed");
 	}
 
-	int i;
-	for(i = 0; i < nth; ++i)
+	return ret;
+}
+
+static int
+bfs_file_dataAdd(bfs_file_t* self, uint32_t hash,
+                 size_t size, bfs_codec_e codec,
+                 size_t bytes, const void* blob,
+                 sqlite3_int64* _rowid)
+{
+	ASSERT(self);
+	ASSERT(blob);
+	ASSERT(_rowid);
+
+	sqlite3_stmt* stmt = self->stmt_data_add;
+	if((sqlite3_bind_int64(stmt, self->idx_data_add_hash,
+	                       (sqlite3_int64) hash) != SQLITE_OK) ||
+	   (sqlite3_bind_int64(stmt, self->idx_data_add_size,
+	                       (sqlite3_int64) size) != SQLITE_OK) ||
+	   (sqlite3_bind_int(stmt, self->idx_data_add_codec,
+	                     (int) codec) != SQLITE_OK) ||
+	   (sqlite3_bind_blob(stmt, self->idx_data_add_blob,
+	                      blob, bytes,
+	                      SQLITE_STATIC) != SQLITE_OK))
+	{
+		LOGE("sqlite3_bind: %s", sqlite3_errmsg(self->db));
+		return 0;
+	}
+
+	int ret = bfs_file_step(self, stmt);
+	if(ret)
 	{
-		const char* sql_attr_get;
-		sql_attr_get = "SELECT val FROM tbl_attr"
-		               "   WHERE key=@arg_key;";
-		if(sqlite3_prepare_v2(self->db, sql_attr_get, -1,
-		                      &self->stmt_attr_get[i],
-		                      NULL) != SQLITE_OK)
-		{
-			LOGE("sqlite3_prepare_v2: %s",
-			     sqlite3_errmsg(self->db));
-			goto fail_prepare_attr_get;
-		}
+		*_rowid = sqlite3_last_insert_rowid(self->db);
 	}
 
-	const char* sql_attr_set = "REPLACE INTO tbl_attr (key, val)"
-	                           "   VALUES (@arg_key, @arg_val);";
-	if(sqlite3_prepare_v2(self->db, sql_attr_set, -1,
+	// the blob is bound with SQLITE_STATIC
+	sqlite3_clear_bindings(stmt);
+
+	return ret;
+}
+
+static int
+bfs_file_nameAdd(bfs_file_t* self, const char* name,
+                 sqlite3_int64 rowid)
+{
+	ASSERT(self);
+	ASSERT(name);
+
+	sqlite3_stmt* stmt = self->stmt_name_add;
+	if((sqlite3_bind_text(stmt, self->idx_name_add_name,
+	                      name, -1,
+	                      SQLITE_TRANSIENT) != SQLITE_OK) ||
+	   (sqlite3_bind_int64(stmt, self->idx_name_add_data,
+	                       rowid) != SQLITE_OK))
+	{
+		LOGE("sqlite3_bind: %s", sqlite3_errmsg(self->db));
+		return 0;
+	}
+
+	return bfs_file_step(self, stmt);
+}
+
+static void
+bfs_file_dataClr(bfs_file_t* self, sqlite3_int64 rowid)
+{
+	ASSERT(self);
+
+	char sql[256];
+	snprintf(sql, 256,
+	         "DELETE FROM tbl_data WHERE rowid=%lli AND refs<=0;",
+	         (long long) rowid);
+	if(sqlite3_exec(self->db, sql, NULL, NULL,
+	                NULL) != SQLITE_OK)
+	{
+		LOGW("sqlite3_exec: %s", sqlite3_errmsg(self->db));
+	}
+}
+
+static sqlite3_stmt*
+bfs_file_prepare(sqlite3* db, const char* sql)
+{
+	ASSERT(db);
+	ASSERT(sql);
+
+	sqlite3_stmt* stmt = NULL;
+	if(sqlite3_prepare_v2(db, sql, -1, &stmt,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s", sqlite3_errmsg(db));
+		return NULL;
+	}
+
+	return stmt;
+}
+
+static sqlite3_stmt*
+bfs_file_prepareBlobList(bfs_file_t* self, int store)
+{
+	ASSERT(self);
+
+	const char* sql_blob_list;
+	sql_blob_list = "SELECT name, length(blob) FROM tbl_blob;";
+	if(store)
+	{
+		sql_blob_list = "SELECT name, length(blob) FROM tbl_blob"
+		                "   UNION ALL"
+		                "   SELECT tbl_name.name, tbl_data.size"
+		                "      FROM tbl_name JOIN tbl_data"
+		                "      ON tbl_data.rowid=tbl_name.data;";
+	}
+
+	return bfs_file_prepare(self->db, sql_blob_list);
+}
+
+static sqlite3_stmt*
+bfs_file_prepareBlobGet(bfs_file_t* self, int tid, int store)
+{
+	ASSERT(self);
+
+	// each name is either in tbl_blob or tbl_name
+	const char* sql_blob_get;
+	sql_blob_get = "SELECT blob, 0, 0 FROM tbl_blob"
+	               "   WHERE name=@arg_name;";
+	if(store)
+	{
+		sql_blob_get = "SELECT blob, 0, 0 FROM tbl_blob"
+		               "   WHERE name=@arg_name"
+		               "   UNION ALL"
+		               "   SELECT tbl_data.blob, tbl_data.codec,"
+		               "          tbl_data.size"
+		               "      FROM tbl_name JOIN tbl_data"
+		               "      ON tbl_data.rowid=tbl_name.data"
+		               "      WHERE tbl_name.name=@arg_name;";
+	}
+
+	return bfs_file_prepare(bfs_file_dbRead(self, tid),
+	                        sql_blob_get);
+}
+
+static sqlite3_stmt*
+bfs_file_prepareBlobRowid(bfs_file_t* self, int tid,
+                          int store)
+{
+	ASSERT(self);
+
+	const char* sql_blob_rowid;
+	sql_blob_rowid = "SELECT rowid, length(blob), 0, 0"
+	                 "   FROM tbl_blob WHERE name=@arg_name;";
+	if(store)
+	{
+		sql_blob_rowid = "SELECT rowid, length(blob), 0, 0"
+		                 "   FROM tbl_blob WHERE name=@arg_name"
+		                 "   UNION ALL"
+		                 "   SELECT tbl_data.rowid, tbl_data.size,"
+		                 "          tbl_data.codec, 1"
+		                 "      FROM tbl_name JOIN tbl_data"
+		                 "      ON tbl_data.rowid=tbl_name.data"
+		                 "      WHERE tbl_name.name=@arg_name;";
+	}
+
+	return bfs_file_prepare(bfs_file_dbRead(self, tid),
+	                        sql_blob_rowid);
+}
+
+static void bfs_file_finalizeStore(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	sqlite3_finalize(self->stmt_data_add);
+	sqlite3_finalize(self->stmt_data_find);
+	sqlite3_finalize(self->stmt_name_clr);
+	sqlite3_finalize(self->stmt_name_add);
+	self->stmt_data_add  = NULL;
+	self->stmt_data_find = NULL;
+	self->stmt_name_clr  = NULL;
+	self->stmt_name_add  = NULL;
+}
+
+static int bfs_file_prepareStore(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	const char* sql_name_add;
+	sql_name_add = "INSERT INTO tbl_name (name, data)"
+	               "   VALUES (@arg_name, @arg_data);";
+	if(sqlite3_prepare_v2(self->db, sql_name_add, -1,
+	                      &self->stmt_name_add,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare;
+	}
+
+	const char* sql_name_clr;
+	sql_name_clr = "DELETE FROM tbl_name"
+	               "   WHERE name=@arg_name;";
+	if(sqlite3_prepare_v2(self->db, sql_name_clr, -1,
+	                      &self->stmt_name_clr,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare;
+	}
+
+	const char* sql_data_find;
+	sql_data_find = "SELECT rowid, blob FROM tbl_data"
+	                "   WHERE hash=@arg_hash AND size=@arg_size"
+	                "   AND codec=@arg_codec;";
+	if(sqlite3_prepare_v2(self->db, sql_data_find, -1,
+	                      &self->stmt_data_find,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare;
+	}
+
+	const char* sql_data_add;
+	sql_data_add = "INSERT INTO tbl_data"
+	               "   (hash, size, codec, refs, blob)"
+	               "   VALUES (@arg_hash, @arg_size,"
+	               "           @arg_codec, 0, @arg_blob);";
+	if(sqlite3_prepare_v2(self->db, sql_data_add, -1,
+	                      &self->stmt_data_add,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare;
+	}
+
+	self->idx_name_add_name  = sqlite3_bind_parameter_index(self->stmt_name_add,
+	                                                        "@arg_name");
+	self->idx_name_add_data  = sqlite3_bind_parameter_index(self->stmt_name_add,
+	                                                        "@arg_data");
+	self->idx_name_clr_name  = sqlite3_bind_parameter_index(self->stmt_name_clr,
+	                                                        "@arg_name");
+	self->idx_data_find_hash = sqlite3_bind_parameter_index(self->stmt_data_find,
+	                                                        "@arg_hash");
+	self->idx_data_find_size = sqlite3_bind_parameter_index(self->stmt_data_find,
+	                                                        "@arg_size");
+	self->idx_data_find_codec = sqlite3_bind_parameter_index(self->stmt_data_find,
+	                                                         "@arg_codec");
+	self->idx_data_add_hash  = sqlite3_bind_parameter_index(self->stmt_data_add,
+	                                                        "@arg_hash");
+	self->idx_data_add_size  = sqlite3_bind_parameter_index(self->stmt_data_add,
+	                                                        "@arg_size");
+	self->idx_data_add_codec = sqlite3_bind_parameter_index(self->stmt_data_add,
+	                                                        "@arg_codec");
+	self->idx_data_add_blob  = sqlite3_bind_parameter_index(self->stmt_data_add,
+	                                                        "@arg_blob");
+
+	// success
+	return 1;
+
+	// failure
+	fail_prepare:
+		bfs_file_finalizeStore(self);
+	return 0;
+}
+
+static int bfs_file_initStore(bfs_file_t* self)
+{
+	ASSERT(self);
+
+	if(self->store)
+	{
+		return 1;
+	}
+
+	// the store is created by the first blobStore so the
+	// writer statements and the blob list are prepared here
+	// while the per-thread statements are prepared again by
+	// their thread in bfs_file_prepareRead
+	if(bfs_file_beginWrite(self) == 0)
+	{
+		return 0;
+	}
+
+	int ret = bfs_file_createStore(self);
+	if(bfs_file_endWrite(self, ret) == 0)
+	{
+		return 0;
+	}
+
+	sqlite3_stmt* stmt_blob_list;
+	stmt_blob_list = bfs_file_prepareBlobList(self, 1);
+	if(stmt_blob_list == NULL)
+	{
+		goto fail_prepare_blob_list;
+	}
+
+	if(bfs_file_prepareStore(self) == 0)
+	{
+		goto fail_prepare_store;
+	}
+
+	sqlite3_finalize(self->stmt_blob_list);
+	self->stmt_blob_list = stmt_blob_list;
+
+	__atomic_store_n(&self->store, 1, __ATOMIC_RELEASE);
+
+	// success
+	return 1;
+
+	// failure
+	fail_prepare_store:
+		sqlite3_finalize(stmt_blob_list);
+	fail_prepare_blob_list:
+	return 0;
+}
+
+static int bfs_file_prepareRead(bfs_file_t* self, int tid)
+{
+	ASSERT(self);
+
+	// prepare the per-thread statements again when the store
+	// was created after they were prepared
+	if(self->store_read[tid] ||
+	   (__atomic_load_n(&self->store, __ATOMIC_ACQUIRE) == 0))
+	{
+		return 1;
+	}
+
+	sqlite3_stmt* stmt_blob_get;
+	stmt_blob_get = bfs_file_prepareBlobGet(self, tid, 1);
+	if(stmt_blob_get == NULL)
+	{
+		return 0;
+	}
+
+	sqlite3_stmt* stmt_blob_rowid;
+	stmt_blob_rowid = bfs_file_prepareBlobRowid(self, tid, 1);
+	if(stmt_blob_rowid == NULL)
+	{
+		sqlite3_finalize(stmt_blob_get);
+		return 0;
+	}
+
+	sqlite3_finalize(self->stmt_blob_get[tid]);
+	sqlite3_finalize(self->stmt_blob_rowid[tid]);
+	self->stmt_blob_get[tid]   = stmt_blob_get;
+	self->stmt_blob_rowid[tid] = stmt_blob_rowid;
+	self->store_read[tid]      = 1;
+
+	return 1;
+}
+
+static int bfs_fileExists(const char* fname)
+{
+	ASSERT(fname);
+
+	if(access(fname, F_OK) != 0)
+	{
+		return 0;
+	}
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+bfs_file_t*
+bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
+{
+	ASSERT(fname);
+
+	int flags  = SQLITE_OPEN_READWRITE;
+	int exists = bfs_fileExists(fname);
+	if(mode == BFS_MODE_RDONLY)
+	{
+		// database must exist in read-only mode
+		if(exists == 0)
+		{
+			LOGE("invalid %s", fname);
+			return NULL;
+		}
+
+		flags = SQLITE_OPEN_READONLY;
+	}
+	else if(mode == BFS_MODE_STREAM)
+	{
+		if(nth != 1)
+		{
+			LOGE("invalid nth=%i", nth);
+			return NULL;
+		}
+	}
+
+	// create database if needed
+	if(exists == 0)
+	{
+		flags |= SQLITE_OPEN_CREATE;
+	}
+
+	int r = 0;
+
+	bfs_file_t* self;
+	self = (bfs_file_t*)
+	       CALLOC(1, sizeof(bfs_file_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->nth     = nth;
+	self->mode    = mode;
+	self->replace = (mode != BFS_MODE_STREAM) || exists;
+
+	// sqlite3 must be initialized externally
+	if(sqlite3_open_v2(fname, &self->db, flags,
+	                   NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_open_v2 %s failed", fname);
+		goto fail_db_open;
+	}
+
+	// the content store is created by the first blobStore
+	// so that files are not changed unless it is used
+	self->store = bfs_file_hasStore(self);
+
+	if(flags & SQLITE_OPEN_CREATE)
+	{
+		if(bfs_file_createTables(self) == 0)
+		{
+			goto fail_initialize;
+		}
+
+		if(mode == BFS_MODE_STREAM)
+		{
+			// index creation is faster at close
+		}
+		else if(bfs_file_createIndices(self) == 0)
+		{
+			goto fail_initialize;
+		}
+	}
+
+	if(mode == BFS_MODE_RDONLY)
+	{
+		bfs_file_mmap(self->db);
+	}
+	else if(mode == BFS_MODE_WAL)
+	{
+		// commits in WAL mode are durable after a checkpoint
+		// or a power loss may roll back recent commits
+		const char* sql_wal = "PRAGMA journal_mode=WAL;"
+		                      "PRAGMA synchronous=NORMAL;";
+		if(sqlite3_exec(self->db, sql_wal, NULL, NULL,
+		                NULL) != SQLITE_OK)
+		{
+			LOGE("sqlite3_exec: %s", sqlite3_errmsg(self->db));
+			goto fail_wal;
+		}
+		sqlite3_busy_timeout(self->db, BFS_BUSY_TIMEOUT);
+
+		self->db_read = (sqlite3**)
+		                CALLOC(nth, sizeof(sqlite3*));
+		if(self->db_read == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_wal;
+		}
+
+		// each reader connection is only used by one thread
+		for(r = 0; r < nth; ++r)
+		{
+			if(sqlite3_open_v2(fname, &self->db_read[r],
+			                   SQLITE_OPEN_READONLY |
+			                   SQLITE_OPEN_NOMUTEX,
+			                   NULL) != SQLITE_OK)
+			{
+				LOGE("sqlite3_open_v2 %s failed", fname);
+
+				// close db even when open fails
+				++r;
+				goto fail_db_read;
+			}
+			sqlite3_busy_timeout(self->db_read[r],
+			                     BFS_BUSY_TIMEOUT);
+			bfs_file_mmap(self->db_read[r]);
+		}
+	}
+
+	const char* sql_begin = "BEGIN;";
+	if(sqlite3_prepare_v2(self->db, sql_begin, -1,
+	                      &self->stmt_begin,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare_begin;
+	}
+
+	const char* sql_end = "END;";
+	if(sqlite3_prepare_v2(self->db, sql_end, -1,
+	                      &self->stmt_end,
+	                      NULL) != SQLITE_OK)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare_end;
+	}
+
+	const char* sql_attr_list;
+	sql_attr_list = "SELECT key, val FROM tbl_attr;";
+	if(sqlite3_prepare_v2(self->db, sql_attr_list, -1,
+	                      &self->stmt_attr_list,
+	                      NULL) != SQLITE_OK)
+	if(self->stmt_attr_list == NULL)
+	{
+		LOGE("sqlite3_prepare_v2: %s",
+		     sqlite3_errmsg(self->db));
+		goto fail_prepare_attr_list;
+	}
+
+	self->stmt_attr_get = (sqlite3_stmt**)
+	                      CALLOC(nth, sizeof(sqlite3_stmt*));
+	if(self->stmt_attr_get == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_alloc_attr_get;
+	}
+
+	int i;
+	for(i = 0; i < nth; ++i)
+	{
+		const char* sql_attr_get;
+		sql_attr_get = "SELECT val FROM tbl_attr"
+		               "   WHERE key=@arg_key;";
+		if(sqlite3_prepare_v2(bfs_file_dbRead(self, i),
+		                      sql_attr_get, -1,
+		                      &self->stmt_attr_get[i],
+		                      NULL) != SQLITE_OK)
+		{
+			LOGE("sqlite3_prepare_v2: %s",
+			     sqlite3_errmsg(bfs_file_dbRead(self, i)));
+			goto fail_prepare_attr_get;
+		}
+	}
+
+	const char* sql_attr_set = "REPLACE INTO tbl_attr (key, val)"
+	                           "   VALUES (@arg_key, @arg_val);";
+	if(sqlite3_prepare_v2(self->db, sql_attr_set, -1,
 	                      &self->stmt_attr_set,
 	                      NULL) != SQLITE_OK)
 	{
@@ -459,15 +1229,10 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 		goto fail_prepare_attr_clr;
 	}
 
-	const char* sql_blob_list;
-	sql_blob_list = "SELECT name, length(blob) FROM tbl_blob;";
-	if(sqlite3_prepare_v2(self->db, sql_blob_list, -1,
-	                      &self->stmt_blob_list,
-	                      NULL) != SQLITE_OK)
+	self->stmt_blob_list = bfs_file_prepareBlobList(self,
+	                                                self->store);
 	if(self->stmt_blob_list == NULL)
 	{
-		LOGE("sqlite3_prepare_v2: %s",
-		     sqlite3_errmsg(self->db));
 		goto fail_prepare_blob_list;
 	}
 
@@ -482,19 +1247,61 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 	int j;
 	for(j = 0; j < nth; ++j)
 	{
-		const char* sql_blob_get;
-		sql_blob_get = "SELECT blob FROM tbl_blob"
-		               "   WHERE name=@arg_name;";
-		if(sqlite3_prepare_v2(self->db, sql_blob_get, -1,
-		                      &self->stmt_blob_get[j],
-		                      NULL) != SQLITE_OK)
+		self->stmt_blob_get[j] = bfs_file_prepareBlobGet(self, j,
+		                                                 self->store);
+		if(self->stmt_blob_get[j] == NULL)
 		{
-			LOGE("sqlite3_prepare_v2: %s",
-			     sqlite3_errmsg(self->db));
 			goto fail_prepare_blob_get;
 		}
 	}
 
+	self->stmt_blob_rowid = (sqlite3_stmt**)
+	                        CALLOC(nth, sizeof(sqlite3_stmt*));
+	if(self->stmt_blob_rowid == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_alloc_blob_rowid;
+	}
+
+	int k;
+	for(k = 0; k < nth; ++k)
+	{
+		self->stmt_blob_rowid[k] = bfs_file_prepareBlobRowid(self, k,
+		                                                     self->store);
+		if(self->stmt_blob_rowid[k] == NULL)
+		{
+			goto fail_prepare_blob_rowid;
+		}
+	}
+
+	self->blob = (bfs_fileBlob_t*)
+	             CALLOC(nth, sizeof(bfs_fileBlob_t));
+	if(self->blob == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_alloc_blob;
+	}
+
+	self->buf = (void**) CALLOC(nth, sizeof(void*));
+	if(self->buf == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_alloc_buf;
+	}
+
+	self->store_read = (int*) CALLOC(nth, sizeof(int));
+	if(self->store_read == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_alloc_store_read;
+	}
+
+	int s;
+	for(s = 0; s < nth; ++s)
+	{
+		self->store_read[s] = self->store;
+	}
+
 	const char* sql_blob_set = "REPLACE INTO tbl_blob (name, blob)"
 	                           "   VALUES (@arg_name, @arg_blob);";
 	if(sqlite3_prepare_v2(self->db, sql_blob_set, -1,
@@ -518,6 +1325,11 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 		goto fail_prepare_blob_clr;
 	}
 
+	if(self->store && (bfs_file_prepareStore(self) == 0))
+	{
+		goto fail_prepare_store;
+	}
+
 	self->idx_attr_get_key  = sqlite3_bind_parameter_index(self->stmt_attr_get[0],
 	                                                       "@arg_key");
 	self->idx_attr_set_key  = sqlite3_bind_parameter_index(self->stmt_attr_set,
@@ -528,6 +1340,8 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 	                                                       "@arg_key");
 	self->idx_blob_get_name = sqlite3_bind_parameter_index(self->stmt_blob_get[0],
 	                                                       "@arg_name");
+	self->idx_blob_rowid_name = sqlite3_bind_parameter_index(self->stmt_blob_rowid[0],
+	                                                         "@arg_name");
 	self->idx_blob_set_name = sqlite3_bind_parameter_index(self->stmt_blob_set,
 	                                                       "@arg_name");
 	self->idx_blob_set_blob = sqlite3_bind_parameter_index(self->stmt_blob_set,
@@ -555,10 +1369,27 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 	fail_cond:
 		pthread_mutex_destroy(&self->mutex);
 	fail_mutex:
+		bfs_file_finalizeStore(self);
+	fail_prepare_store:
 		sqlite3_finalize(self->stmt_blob_clr);
 	fail_prepare_blob_clr:
 		sqlite3_finalize(self->stmt_blob_set);
 	fail_prepare_blob_set:
+		FREE(self->store_read);
+	fail_alloc_store_read:
+		FREE(self->buf);
+	fail_alloc_buf:
+		FREE(self->blob);
+	fail_alloc_blob:
+	fail_prepare_blob_rowid:
+	{
+		for(t = 0; t < k; ++t)
+		{
+			sqlite3_finalize(self->stmt_blob_rowid[t]);
+		}
+		FREE(self->stmt_blob_rowid);
+	}
+	fail_alloc_blob_rowid:
 	fail_prepare_blob_get:
 	{
 		for(t = 0; t < j; ++t)
@@ -589,6 +1420,20 @@ bfs_file_open(const char* fname, int nth, bfs_mode_e mode)
 	fail_prepare_end:
 		sqlite3_finalize(self->stmt_begin);
 	fail_prepare_begin:
+	fail_db_read:
+	{
+		// sqlite3 must be shutdown externally
+		// close db even when open fails
+		for(t = 0; t < r; ++t)
+		{
+			if(sqlite3_close_v2(self->db_read[t]) != SQLITE_OK)
+			{
+				LOGW("sqlite3_close_v2 failed");
+			}
+		}
+		FREE(self->db_read);
+	}
+	fail_wal:
 	fail_initialize:
 	fail_db_open:
 	{
@@ -618,14 +1463,41 @@ void bfs_file_close(bfs_file_t** _self)
 		if(self->mode == BFS_MODE_STREAM)
 		{
 			bfs_file_createIndices(self);
+			if(self->store)
+			{
+				bfs_file_createStoreIndices(self);
+			}
 		}
 
 		pthread_cond_destroy(&self->cond);
 		pthread_mutex_destroy(&self->mutex);
+		bfs_file_finalizeStore(self);
 		sqlite3_finalize(self->stmt_blob_clr);
 		sqlite3_finalize(self->stmt_blob_set);
 
 		int i;
+		for(i = 0; i < self->nth; ++i)
+		{
+			FREE(self->buf[i]);
+		}
+		FREE(self->buf);
+		FREE(self->store_read);
+
+		for(i = 0; i < self->nth; ++i)
+		{
+			if(self->blob[i].blob)
+			{
+				sqlite3_blob_close(self->blob[i].blob);
+			}
+		}
+		FREE(self->blob);
+
+		for(i = 0; i < self->nth; ++i)
+		{
+			sqlite3_finalize(self->stmt_blob_rowid[i]);
+		}
+		FREE(self->stmt_blob_rowid);
+
 		for(i = 0; i < self->nth; ++i)
 		{
 			sqlite3_finalize(self->stmt_blob_get[i]);
@@ -646,6 +1518,28 @@ void bfs_file_close(bfs_file_t** _self)
 		sqlite3_finalize(self->stmt_end);
 		sqlite3_finalize(self->stmt_begin);
 
+		if(self->db_read)
+		{
+			for(i = 0; i < self->nth; ++i)
+			{
+				if(sqlite3_close_v2(self->db_read[i]) != SQLITE_OK)
+				{
+					LOGW("sqlite3_close_v2 failed");
+				}
+			}
+			FREE(self->db_read);
+
+			// restore the rollback journal which checkpoints
+			// and removes the -wal and -shm files unless the
+			// file is still open by another connection
+			if(sqlite3_exec(self->db,
+			                "PRAGMA journal_mode=DELETE;",
+			                NULL, NULL, NULL) != SQLITE_OK)
+			{
+				LOGW("sqlite3_exec: %s", sqlite3_errmsg(self->db));
+			}
+		}
+
 		// sqlite3 must be shutdown externally
 		if(sqlite3_close_v2(self->db) != SQLITE_OK)
 		{
@@ -659,7 +1553,19 @@ int bfs_file_flush(bfs_file_t* self)
 {
 	ASSERT(self);
 
-	return bfs_file_endTransaction(self);
+	// only the stream mode batches transactions so the lock
+	// is not taken otherwise since the caller may hold a
+	// read lock from blobMap or blobOpen
+	if(self->mode != BFS_MODE_STREAM)
+	{
+		return 1;
+	}
+
+	bfs_file_lockExclusive(self);
+	int ret = bfs_file_endTransaction(self);
+	bfs_file_unlockExclusive(self);
+
+	return ret;
 }
 
 int bfs_file_attrList(bfs_file_t* self, void* priv,
@@ -749,7 +1655,8 @@ int bfs_file_attrGet(bfs_file_t* self, int tid,
 	}
 	else if(step != SQLITE_DONE)
 	{
-		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		LOGE("sqlite3_step: %s",
+		     sqlite3_errmsg(bfs_file_dbRead(self, tid)));
 		ret = 0;
 	}
 
@@ -851,17 +1758,152 @@ int bfs_file_attrClr(bfs_file_t* self, const char* key)
 		LOGW("sqlite3_reset failed");
 	}
 
-	bfs_file_unlockExclusive(self);
+	bfs_file_unlockExclusive(self);
+
+	return ret;
+}
+
+int bfs_file_blobList(bfs_file_t* self, void* priv,
+                      bfs_blob_fn blob_fn)
+{
+	// priv may be NULL
+	ASSERT(self);
+	ASSERT(blob_fn);
+
+	if(self->mode == BFS_MODE_STREAM)
+	{
+		LOGE("invalid mode");
+		return 0;
+	}
+
+	bfs_file_lockExclusive(self);
+
+	int           ret  = 1;
+	sqlite3_stmt* stmt = self->stmt_blob_list;
+	int           step = sqlite3_step(stmt);
+	while(step == SQLITE_ROW)
+	{
+		size_t      size;
+		const char* name;
+		name = (const char*) sqlite3_column_text(stmt, 0);
+		size = (size_t) sqlite3_column_int(stmt, 1);
+		ret &= (*blob_fn)(priv, name, size);
+		step = sqlite3_step(stmt);
+	}
+
+	if(step != SQLITE_DONE)
+	{
+		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		ret = 0;
+	}
+
+	if(sqlite3_reset(stmt) != SQLITE_OK)
+	{
+		LOGW("sqlite3_reset failed");
+	}
+
+	bfs_file_unlockExclusive(self);
+
+	return ret;
+}
+
+int bfs_file_blobGet(bfs_file_t* self, int tid,
+                     const char* name,
+                     size_t* _size, void** _data)
+{
+	ASSERT(self);
+	ASSERT(name);
+	ASSERT(_size);
+	ASSERT(_data);
+
+	// allow return success with empty data
+	*_size = 0;
+
+	if(self->mode == BFS_MODE_STREAM)
+	{
+		LOGE("invalid mode");
+		return 0;
+	}
+
+	bfs_file_lockRead(self);
+
+	if(bfs_file_prepareRead(self, tid) == 0)
+	{
+		bfs_file_unlockRead(self);
+		return 0;
+	}
+
+	int           idx  = self->idx_blob_get_name;
+	sqlite3_stmt* stmt = self->stmt_blob_get[tid];
+	if(sqlite3_bind_text(stmt, idx, name, -1,
+	                     SQLITE_TRANSIENT) != SQLITE_OK)
+	{
+		LOGE("sqlite3_bind_text failed");
+		bfs_file_unlockRead(self);
+		return 0;
+	}
+
+	int ret  = 1;
+	int step = sqlite3_step(stmt);
+	if(step == SQLITE_ROW)
+	{
+		// stored blobs may be compressed
+		const void* blob  = sqlite3_column_blob(stmt, 0);
+		int         bytes = sqlite3_column_bytes(stmt, 0);
+		int         codec = sqlite3_column_int(stmt, 1);
+		size_t      size  = (size_t) bytes;
+		if(codec != BFS_CODEC_NONE)
+		{
+			size = (size_t) sqlite3_column_int64(stmt, 2);
+		}
+
+		if((size == 0) || (blob == NULL))
+		{
+			// empty data
+		}
+		else
+		{
+			void* data = bfs_file_buffer(_data, size);
+			if(data && bfs_codec_decode(codec, bytes, blob,
+			                            size, data))
+			{
+				*_size = size;
+			}
+			else
+			{
+				ret = 0;
+			}
+		}
+	}
+	else if(step != SQLITE_DONE)
+	{
+		LOGE("sqlite3_step: %s",
+		     sqlite3_errmsg(bfs_file_dbRead(self, tid)));
+		ret = 0;
+	}
+
+	if(sqlite3_reset(stmt) != SQLITE_OK)
+	{
+		LOGW("sqlite3_reset failed");
+	}
+
+	bfs_file_unlockRead(self);
 
 	return ret;
 }
 
-int bfs_file_blobList(bfs_file_t* self, void* priv,
-                      bfs_blob_fn blob_fn)
+int bfs_file_blobMap(bfs_file_t* self, int tid,
+                     const char* name,
+                     size_t* _size, const void** _data)
 {
-	// priv may be NULL
 	ASSERT(self);
-	ASSERT(blob_fn);
+	ASSERT(name);
+	ASSERT(_size);
+	ASSERT(_data);
+
+	// allow return success with empty data
+	*_size = 0;
+	*_data = NULL;
 
 	if(self->mode == BFS_MODE_STREAM)
 	{
@@ -869,45 +1911,101 @@ int bfs_file_blobList(bfs_file_t* self, void* priv,
 		return 0;
 	}
 
-	bfs_file_lockExclusive(self);
+	// the read lock and statement are held until
+	// bfs_file_blobUnmap
+	bfs_file_lockRead(self);
 
-	int           ret  = 1;
-	sqlite3_stmt* stmt = self->stmt_blob_list;
-	int           step = sqlite3_step(stmt);
-	while(step == SQLITE_ROW)
+	if(bfs_file_prepareRead(self, tid) == 0)
 	{
-		size_t      size;
-		const char* name;
-		name = (const char*) sqlite3_column_text(stmt, 0);
-		size = (size_t) sqlite3_column_int(stmt, 1);
-		ret &= (*blob_fn)(priv, name, size);
-		step = sqlite3_step(stmt);
+		bfs_file_unlockRead(self);
+		return 0;
 	}
 
-	if(step != SQLITE_DONE)
+	int           idx  = self->idx_blob_get_name;
+	sqlite3_stmt* stmt = self->stmt_blob_get[tid];
+	if(sqlite3_bind_text(stmt, idx, name, -1,
+	                     SQLITE_TRANSIENT) != SQLITE_OK)
 	{
-		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
-		ret = 0;
+		LOGE("sqlite3_bind_text failed");
+		bfs_file_unlockRead(self);
+		return 0;
 	}
 
-	if(sqlite3_reset(stmt) != SQLITE_OK)
+	int step = sqlite3_step(stmt);
+	if(step == SQLITE_ROW)
 	{
-		LOGW("sqlite3_reset failed");
+		// the blob points into the mapped pages when the
+		// blob is contained by a single page and otherwise
+		// into a buffer owned by the statement
+		const void* blob  = sqlite3_column_blob(stmt, 0);
+		int         bytes = sqlite3_column_bytes(stmt, 0);
+		int         codec = sqlite3_column_int(stmt, 1);
+		if((blob == NULL) || (bytes <= 0))
+		{
+			// empty data
+		}
+		else if(codec == BFS_CODEC_NONE)
+		{
+			*_size = bytes;
+			*_data = blob;
+		}
+		else
+		{
+			// compressed blobs are decoded into a buffer
+			// owned by the thread
+			size_t size = (size_t) sqlite3_column_int64(stmt, 2);
+			void*  data = bfs_file_buffer(&self->buf[tid], size);
+			if((data == NULL) ||
+			   (bfs_codec_decode(codec, bytes, blob,
+			                     size, data) == 0))
+			{
+				goto fail_decode;
+			}
+			*_size = size;
+			*_data = data;
+		}
+	}
+	else if(step != SQLITE_DONE)
+	{
+		LOGE("sqlite3_step: %s",
+		     sqlite3_errmsg(bfs_file_dbRead(self, tid)));
+		goto fail_step;
 	}
 
-	bfs_file_unlockExclusive(self);
+	// success
+	return 1;
 
-	return ret;
+	// failure
+	fail_decode:
+	fail_step:
+	{
+		if(sqlite3_reset(stmt) != SQLITE_OK)
+		{
+			LOGW("sqlite3_reset failed");
+		}
+		bfs_file_unlockRead(self);
+	}
+	return 0;
 }
 
-int bfs_file_blobGet(bfs_file_t* self, int tid,
-                     const char* name,
-                     size_t* _size, void** _data)
+void bfs_file_blobUnmap(bfs_file_t* self, int tid)
+{
+	ASSERT(self);
+
+	if(sqlite3_reset(self->stmt_blob_get[tid]) != SQLITE_OK)
+	{
+		LOGW("sqlite3_reset failed");
+	}
+
+	bfs_file_unlockRead(self);
+}
+
+int bfs_file_blobOpen(bfs_file_t* self, int tid,
+                      const char* name, size_t* _size)
 {
 	ASSERT(self);
 	ASSERT(name);
 	ASSERT(_size);
-	ASSERT(_data);
 
 	// allow return success with empty data
 	*_size = 0;
@@ -918,10 +2016,17 @@ int bfs_file_blobGet(bfs_file_t* self, int tid,
 		return 0;
 	}
 
+	// the read lock is held until bfs_file_blobClose
 	bfs_file_lockRead(self);
 
-	int           idx  = self->idx_blob_get_name;
-	sqlite3_stmt* stmt = self->stmt_blob_get[tid];
+	if(bfs_file_prepareRead(self, tid) == 0)
+	{
+		bfs_file_unlockRead(self);
+		return 0;
+	}
+
+	int           idx  = self->idx_blob_rowid_name;
+	sqlite3_stmt* stmt = self->stmt_blob_rowid[tid];
 	if(sqlite3_bind_text(stmt, idx, name, -1,
 	                     SQLITE_TRANSIENT) != SQLITE_OK)
 	{
@@ -930,72 +2035,131 @@ int bfs_file_blobGet(bfs_file_t* self, int tid,
 		return 0;
 	}
 
-	int ret  = 1;
-	int step = sqlite3_step(stmt);
+	sqlite3_int64 rowid = 0;
+	int           size  = 0;
+	int           codec = BFS_CODEC_NONE;
+	int           data  = 0;
+	int           step  = sqlite3_step(stmt);
 	if(step == SQLITE_ROW)
 	{
-		int         size = 0;
-		const void* blob = NULL;
-		void*       data = *_data;
-		size = sqlite3_column_bytes(stmt, 0);
-		blob = sqlite3_column_blob(stmt, 0);
-		if((size == 0) || (blob == NULL))
-		{
-			// empty data
-		}
-		else if(data == NULL)
-		{
-			// allocate data buffer
-			data = CALLOC(1, size);
-			if(data)
-			{
-				memcpy(data, blob, size);
-				*_size = size;
-				*_data = data;
-			}
-			else
-			{
-				LOGE("CALLOC failed");
-				ret = 0;
-			}
-		}
-		else if(MEMSIZEPTR(data) < size)
+		rowid = sqlite3_column_int64(stmt, 0);
+		size  = sqlite3_column_int(stmt, 1);
+		codec = sqlite3_column_int(stmt, 2);
+		data  = sqlite3_column_int(stmt, 3);
+	}
+	else if(step != SQLITE_DONE)
+	{
+		LOGE("sqlite3_step: %s",
+		     sqlite3_errmsg(bfs_file_dbRead(self, tid)));
+	}
+
+	if(sqlite3_reset(stmt) != SQLITE_OK)
+	{
+		LOGW("sqlite3_reset failed");
+	}
+
+	if((step != SQLITE_ROW) && (step != SQLITE_DONE))
+	{
+		bfs_file_unlockRead(self);
+		return 0;
+	}
+	else if(codec != BFS_CODEC_NONE)
+	{
+		// byte ranges of compressed blobs cannot be read
+		LOGE("invalid name=%s, codec=%i", name, codec);
+		bfs_file_unlockRead(self);
+		return 0;
+	}
+	else if(size <= 0)
+	{
+		// empty data so blobRead must not see a cached handle
+		if(self->blob[tid].blob)
 		{
-			// grow data buffer
-			data = REALLOC(*_data, size);
-			if(data)
-			{
-				memcpy(data, blob, size);
-				*_size = size;
-				*_data = data;
-			}
-			else
-			{
-				LOGE("REALLOC failed");
-				ret = 0;
-			}
+			sqlite3_blob_close(self->blob[tid].blob);
+			self->blob[tid].blob = NULL;
 		}
-		else
+		return 1;
+	}
+
+	// reopen the cached handle to avoid preparing a new
+	// statement for each blob when the table matches
+	sqlite3_blob* blob = self->blob[tid].blob;
+	if(blob)
+	{
+		if((self->blob[tid].data == data) &&
+		   (sqlite3_blob_reopen(blob, rowid) == SQLITE_OK))
 		{
-			// reuse data buffer
-			memcpy(data, blob, size);
 			*_size = size;
+			return 1;
 		}
+
+		// the handle is aborted when reopen fails
+		sqlite3_blob_close(blob);
+		self->blob[tid].blob = NULL;
 	}
-	else if(step != SQLITE_DONE)
+
+	sqlite3*    db    = bfs_file_dbRead(self, tid);
+	const char* table = data ? "tbl_data" : "tbl_blob";
+	if(sqlite3_blob_open(db, "main", table, "blob",
+	                     rowid, 0, &blob) != SQLITE_OK)
 	{
-		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
-		ret = 0;
+		LOGE("sqlite3_blob_open: %s", sqlite3_errmsg(db));
+		sqlite3_blob_close(blob);
+		bfs_file_unlockRead(self);
+		return 0;
 	}
+	self->blob[tid].blob = blob;
+	self->blob[tid].data = data;
 
-	if(sqlite3_reset(stmt) != SQLITE_OK)
+	*_size = size;
+
+	return 1;
+}
+
+int bfs_file_blobRead(bfs_file_t* self, int tid,
+                      size_t offset, size_t size,
+                      void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	sqlite3_blob* blob = self->blob[tid].blob;
+	if(size == 0)
 	{
-		LOGW("sqlite3_reset failed");
+		return 1;
+	}
+	else if((blob == NULL) ||
+	        (offset + size > sqlite3_blob_bytes(blob)))
+	{
+		LOGE("invalid offset=%u, size=%u",
+		     (unsigned int) offset, (unsigned int) size);
+		return 0;
 	}
 
-	bfs_file_unlockRead(self);
+	if(sqlite3_blob_read(blob, data, (int) size,
+	                     (int) offset) != SQLITE_OK)
+	{
+		LOGE("sqlite3_blob_read: %s",
+		     sqlite3_errmsg(bfs_file_dbRead(self, tid)));
+		return 0;
+	}
 
-	return ret;
+	return 1;
+}
+
+void bfs_file_blobClose(bfs_file_t* self, int tid)
+{
+	ASSERT(self);
+
+	// the open handle holds a read transaction which would
+	// block writers so it is only cached for read-only files
+	if(self->blob[tid].blob && (self->mode != BFS_MODE_RDONLY))
+	{
+		sqlite3_blob_close(self->blob[tid].blob);
+		self->blob[tid].blob = NULL;
+	}
+
+	bfs_file_unlockRead(self);
 }
 
 int bfs_file_blobSet(bfs_file_t* self, const char* name,
@@ -1011,82 +2175,183 @@ int bfs_file_blobSet(bfs_file_t* self, const char* name,
 	}
 
 	bfs_file_lockExclusive(self);
-	if(bfs_file_beginTransaction(self) == 0)
+	if(bfs_file_beginWrite(self) == 0)
 	{
 		bfs_file_unlockExclusive(self);
 		return 0;
 	}
 
+	// replace the name if it was stored by blobStore
+	int ret = 1;
+	if(self->stmt_name_clr && self->replace)
+	{
+		ret = bfs_file_stepName(self, self->stmt_name_clr,
+		                        self->idx_name_clr_name, name);
+	}
+
 	int           idx_name;
 	int           idx_blob;
 	sqlite3_stmt* stmt;
 	idx_name = self->idx_blob_set_name;
 	idx_blob = self->idx_blob_set_blob;
 	stmt     = self->stmt_blob_set;
-	if((sqlite3_bind_text(stmt, idx_name, name, -1,
-	                      SQLITE_TRANSIENT) != SQLITE_OK) ||
-	   (sqlite3_bind_blob(stmt, idx_blob,
-	                      data, size,
-	                      SQLITE_TRANSIENT) != SQLITE_OK))
+	if(ret == 0)
 	{
-		LOGE("sqlite3_bind_text/sqlite3_bind_blob failed");
-		bfs_file_unlockExclusive(self);
-		return 0;
+		// ignore
 	}
-
-	int ret = 1;
-	if(sqlite3_step(stmt) != SQLITE_DONE)
+	else if((sqlite3_bind_text(stmt, idx_name, name, -1,
+	                           SQLITE_TRANSIENT) != SQLITE_OK) ||
+	        (sqlite3_bind_blob(stmt, idx_blob,
+	                           data, size,
+	                           SQLITE_TRANSIENT) != SQLITE_OK))
 	{
-		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		LOGE("sqlite3_bind_text/sqlite3_bind_blob failed");
 		ret = 0;
 	}
-
-	if(sqlite3_reset(stmt) != SQLITE_OK)
+	else
 	{
-		LOGW("sqlite3_reset failed");
+		ret = bfs_file_step(self, stmt);
 	}
 
+	ret = bfs_file_endWrite(self, ret);
+
 	bfs_file_unlockExclusive(self);
 
 	return ret;
 }
 
-int bfs_file_blobClr(bfs_file_t* self, const char* name)
+int bfs_file_blobStore(bfs_file_t* self, const char* name,
+                       bfs_codec_e codec, size_t size,
+                       const void* data)
 {
+	// data may be NULL
 	ASSERT(self);
 	ASSERT(name);
 
-	bfs_file_lockExclusive(self);
-	if(bfs_file_beginTransaction(self) == 0)
+	if((size == 0) || (data == NULL))
 	{
-		bfs_file_unlockExclusive(self);
+		return bfs_file_blobClr(self, name);
+	}
+	else if(self->mode == BFS_MODE_RDONLY)
+	{
+		LOGE("invalid mode");
+		return 0;
+	}
+	else if(size > INT_MAX)
+	{
+		LOGE("invalid size=%" PRIu64, (uint64_t) size);
 		return 0;
 	}
 
-	int           idx_name;
-	sqlite3_stmt* stmt;
-	idx_name = self->idx_blob_clr_name;
-	stmt     = self->stmt_blob_clr;
-	if(sqlite3_bind_text(stmt, idx_name, name, -1,
-	                     SQLITE_TRANSIENT) != SQLITE_OK)
+	// hash and compress the blob before the exclusive lock
+	// so that multiple threads may store blobs in parallel
+	uint32_t hash;
+	hash = cc_mumurhash3(0, (int) size, (const uint8_t*) data);
+
+	size_t      bytes = size;
+	const void* blob  = data;
+	void*       cdata = NULL;
+	if(codec != BFS_CODEC_NONE)
+	{
+		cdata = MALLOC(size);
+		if(cdata == NULL)
+		{
+			LOGE("MALLOC failed");
+			return 0;
+		}
+
+		bytes = bfs_codec_encode(codec, size, data, cdata);
+		if(bytes)
+		{
+			blob = cdata;
+		}
+		else
+		{
+			// store the blob uncompressed when the codec
+			// does not reduce the size
+			codec = BFS_CODEC_NONE;
+			bytes = size;
+		}
+	}
+
+	bfs_file_lockExclusive(self);
+	if((bfs_file_initStore(self) == 0) ||
+	   (bfs_file_beginWrite(self) == 0))
 	{
-		LOGE("sqlite3_bind_text: %s", sqlite3_errmsg(self->db));
 		bfs_file_unlockExclusive(self);
+		FREE(cdata);
 		return 0;
 	}
 
+	// clear the name before searching for the content since
+	// the content is deleted when it is not referenced
 	int ret = 1;
-	if(sqlite3_step(stmt) != SQLITE_DONE)
+	if(self->replace)
 	{
-		LOGE("sqlite3_step: %s", sqlite3_errmsg(self->db));
+		ret = bfs_file_stepName(self, self->stmt_blob_clr,
+		                        self->idx_blob_clr_name,
+		                        name) &&
+		      bfs_file_stepName(self, self->stmt_name_clr,
+		                        self->idx_name_clr_name,
+		                        name);
+	}
+
+	// share the content with existing names
+	sqlite3_int64 rowid = 0;
+	int           added = 0;
+	ret = ret && bfs_file_dataFind(self, hash, size, codec,
+	                               bytes, blob, &rowid);
+	if(ret && (rowid == 0))
+	{
+		ret = bfs_file_dataAdd(self, hash, size, codec,
+		                       bytes, blob, &rowid);
+		added = ret;
+	}
+
+	// the stream mode cannot roll back the batch so the new
+	// content is removed when the name cannot be added
+	if(ret && (bfs_file_nameAdd(self, name, rowid) == 0))
+	{
+		if(added && (self->mode == BFS_MODE_STREAM))
+		{
+			bfs_file_dataClr(self, rowid);
+		}
 		ret = 0;
 	}
 
-	if(sqlite3_reset(stmt) != SQLITE_OK)
+	ret = bfs_file_endWrite(self, ret);
+
+	bfs_file_unlockExclusive(self);
+
+	FREE(cdata);
+
+	return ret;
+}
+
+int bfs_file_blobClr(bfs_file_t* self, const char* name)
+{
+	ASSERT(self);
+	ASSERT(name);
+
+	bfs_file_lockExclusive(self);
+	if(bfs_file_beginWrite(self) == 0)
 	{
-		LOGW("sqlite3_reset failed");
+		bfs_file_unlockExclusive(self);
+		return 0;
 	}
 
+	int ret = bfs_file_stepName(self, self->stmt_blob_clr,
+	                            self->idx_blob_clr_name,
+	                            name);
+	if(ret && self->stmt_name_clr)
+	{
+		ret = bfs_file_stepName(self, self->stmt_name_clr,
+		                        self->idx_name_clr_name,
+		                        name);
+	}
+
+	ret = bfs_file_endWrite(self, ret);
+
 	bfs_file_unlockExclusive(self);
 
 	return ret;
@@ -44,8 +44,16 @@ typedef enum
 	BFS_MODE_RDONLY = 0,
 	BFS_MODE_RDWR   = 1,
 	BFS_MODE_STREAM = 2,
+	BFS_MODE_WAL    = 3,
 } bfs_mode_e;
 
+typedef enum
+{
+	BFS_CODEC_NONE = 0,
+	BFS_CODEC_ZLIB = 1,
+	BFS_CODEC_LZ4  = 2,
+} bfs_codec_e;
+
 /*
  * opaque objects
  */
@@ -82,10 +90,33 @@ int         bfs_file_blobGet(bfs_file_t* self,
                              const char* name,
                              size_t* _size,
                              void** _data);
+int         bfs_file_blobMap(bfs_file_t* self,
+                             int tid,
+                             const char* name,
+                             size_t* _size,
+                             const void** _data);
+void        bfs_file_blobUnmap(bfs_file_t* self,
+                               int tid);
+int         bfs_file_blobOpen(bfs_file_t* self,
+                              int tid,
+                              const char* name,
+                              size_t* _size);
+int         bfs_file_blobRead(bfs_file_t* self,
+                              int tid,
+                              size_t offset,
+                              size_t size,
+                              void* data);
+void        bfs_file_blobClose(bfs_file_t* self,
+                               int tid);
 int         bfs_file_blobSet(bfs_file_t* self,
                              const char* name,
                              size_t size,
                              const void* data);
+int         bfs_file_blobStore(bfs_file_t* self,
+                               const char* name,
+                               bfs_codec_e codec,
+                               size_t size,
+                               const void* data);
 int         bfs_file_blobClr(bfs_file_t* self,
                              const char* name);
 
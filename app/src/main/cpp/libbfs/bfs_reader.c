@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "bfs"
+#include "../libcc/cc_list.h"
+#include "../libcc/cc_log.h"
+#include "../libcc/cc_map.h"
+#include "../libcc/cc_memory.h"
+#include "../libcc/cc_workq.h"
+#include "bfs_reader.h"
+
+// number of completed requests drained per workq lock
+#define BFS_READER_DRAIN 16
+
+#define BFS_READER_STATE_QUEUED 0
+#define BFS_READER_STATE_READY  1
+
+typedef struct
+{
+	void*         priv;
+	bfs_reader_fn get_fn;
+} bfs_readerWaiter_t;
+
+typedef struct
+{
+	// state is only accessed by the owner thread while the
+	// result (status, size and data) is written by the
+	// workq thread and read by the owner thread after the
+	// request was drained
+	int    state;
+	int    priority;
+	int    status;
+	size_t size;
+	void*  data;
+
+	// waiters are called in the order they were added
+	// prefetched requests are retained in the READY state
+	// until a waiter is added or they are discarded
+	cc_list_t*     list_waiter;
+	cc_listIter_t* iter_ready;
+
+	char name[256];
+} bfs_readerRequest_t;
+
+typedef struct bfs_reader_s
+{
+	bfs_file_t* bfs;
+	int         tid;
+
+	// map from name to request used to coalesce requests
+	cc_map_t* map_request;
+
+	// READY requests which have waiters
+	cc_list_t* list_ready;
+
+	cc_workq_t* workq;
+} bfs_reader_t;
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static bfs_readerRequest_t*
+bfs_readerRequest_new(const char* name, int priority)
+{
+	ASSERT(name);
+
+	bfs_readerRequest_t* self;
+	self = (bfs_readerRequest_t*)
+	       CALLOC(1, sizeof(bfs_readerRequest_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(snprintf(self->name, 256, "%s", name) >= 256)
+	{
+		LOGE("invalid name=%s", name);
+		goto fail_name;
+	}
+
+	self->list_waiter = cc_list_new();
+	if(self->list_waiter == NULL)
+	{
+		goto fail_list_waiter;
+	}
+
+	self->state    = BFS_READER_STATE_QUEUED;
+	self->priority = priority;
+
+	// success
+	return self;
+
+	// failure
+	fail_list_waiter:
+	fail_name:
+		FREE(self);
+	return NULL;
+}
+
+static void
+bfs_readerRequest_delete(bfs_readerRequest_t** _self)
+{
+	ASSERT(_self);
+
+	bfs_readerRequest_t* self = *_self;
+	if(self)
+	{
+		cc_listIter_t*      iter;
+		bfs_readerWaiter_t* waiter;
+		iter = cc_list_head(self->list_waiter);
+		while(iter)
+		{
+			waiter = (bfs_readerWaiter_t*)
+			         cc_list_remove(self->list_waiter, &iter);
+			FREE(waiter);
+		}
+		cc_list_delete(&self->list_waiter);
+
+		FREE(self->data);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+static int
+bfs_reader_run(int tid, void* owner, void* task)
+{
+	ASSERT(owner);
+	ASSERT(task);
+
+	bfs_reader_t*        self = (bfs_reader_t*) owner;
+	bfs_readerRequest_t* req  = (bfs_readerRequest_t*) task;
+
+	req->status = bfs_file_blobGet(self->bfs, self->tid + tid,
+	                               req->name, &req->size,
+	                               &req->data);
+	return req->status;
+}
+
+static void
+bfs_reader_finishFn(void* owner, void* task, int status)
+{
+	// requests which remain in the workq when the reader is
+	// deleted are freed by bfs_reader_delete
+}
+
+static void
+bfs_reader_remove(bfs_reader_t* self,
+                  bfs_readerRequest_t** _req)
+{
+	ASSERT(self);
+	ASSERT(_req);
+
+	bfs_readerRequest_t* req = *_req;
+
+	if(req->iter_ready)
+	{
+		cc_list_remove(self->list_ready, &req->iter_ready);
+	}
+
+	cc_mapIter_t* miter;
+	miter = cc_map_find(self->map_request, req->name);
+	if(miter)
+	{
+		cc_map_remove(self->map_request, &miter);
+	}
+
+	bfs_readerRequest_delete(_req);
+}
+
+static int
+bfs_reader_ready(bfs_reader_t* self,
+                 bfs_readerRequest_t* req)
+{
+	ASSERT(self);
+	ASSERT(req);
+
+	req->state = BFS_READER_STATE_READY;
+
+	// prefetched requests are retained until requested
+	if(req->iter_ready ||
+	   (cc_list_size(req->list_waiter) == 0))
+	{
+		return 1;
+	}
+
+	req->iter_ready = cc_list_append(self->list_ready, NULL,
+	                                 (const void*) req);
+	if(req->iter_ready == NULL)
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+static void
+bfs_reader_complete(bfs_reader_t* self,
+                    bfs_readerRequest_t* req,
+                    int status)
+{
+	ASSERT(self);
+	ASSERT(req);
+
+	if(status != CC_WORKQ_STATUS_COMPLETE)
+	{
+		req->status = 0;
+	}
+
+	if(bfs_reader_ready(self, req) == 0)
+	{
+		// the waiters cannot be delivered so drop the
+		// request and allow it to be requested again
+		bfs_reader_remove(self, &req);
+	}
+}
+
+static void bfs_reader_deliver(bfs_reader_t* self)
+{
+	ASSERT(self);
+
+	cc_listIter_t*       iter;
+	cc_listIter_t*       witer;
+	bfs_readerRequest_t* req;
+	bfs_readerWaiter_t*  waiter;
+	cc_mapIter_t*        miter;
+	iter = cc_list_head(self->list_ready);
+	while(iter)
+	{
+		req = (bfs_readerRequest_t*)
+		      cc_list_remove(self->list_ready, &iter);
+		req->iter_ready = NULL;
+
+		// remove the request from the map before calling
+		// the waiters since they may request the name again
+		miter = cc_map_find(self->map_request, req->name);
+		if(miter)
+		{
+			cc_map_remove(self->map_request, &miter);
+		}
+
+		witer = cc_list_head(req->list_waiter);
+		while(witer)
+		{
+			waiter = (bfs_readerWaiter_t*)
+			         cc_list_remove(req->list_waiter, &witer);
+			(*waiter->get_fn)(waiter->priv, req->name,
+			                  req->status, req->size,
+			                  req->data);
+			FREE(waiter);
+		}
+
+		bfs_readerRequest_delete(&req);
+
+		// the waiters may have added ready requests
+		iter = cc_list_head(self->list_ready);
+	}
+}
+
+static bfs_readerRequest_t*
+bfs_reader_request(bfs_reader_t* self, const char* name,
+                   int priority)
+{
+	ASSERT(self);
+	ASSERT(name);
+
+	// coalesce duplicate requests and raise the priority
+	// of pending requests
+	bfs_readerRequest_t* req;
+	cc_mapIter_t*        miter;
+	miter = cc_map_find(self->map_request, name);
+	if(miter)
+	{
+		req = (bfs_readerRequest_t*) cc_map_val(miter);
+		if((req->state == BFS_READER_STATE_QUEUED) &&
+		   (priority > req->priority))
+		{
+			cc_workq_reprioritize(self->workq, (void*) req,
+			                      priority);
+			req->priority = priority;
+		}
+		return req;
+	}
+
+	req = bfs_readerRequest_new(name, priority);
+	if(req == NULL)
+	{
+		return NULL;
+	}
+
+	miter = cc_map_add(self->map_request, (const void*) req,
+	                   name);
+	if(miter == NULL)
+	{
+		goto fail_map_add;
+	}
+
+	if(cc_workq_run(self->workq, (void*) req,
+	                priority) == CC_WORKQ_STATUS_ERROR)
+	{
+		goto fail_run;
+	}
+
+	// success
+	return req;
+
+	// failure
+	fail_run:
+		cc_map_remove(self->map_request, &miter);
+	fail_map_add:
+		bfs_readerRequest_delete(&req);
+	return NULL;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+bfs_reader_t*
+bfs_reader_new(bfs_file_t* bfs, int tid, int nth)
+{
+	ASSERT(bfs);
+
+	if((tid < 0) || (nth < 1))
+	{
+		LOGE("invalid tid=%i, nth=%i", tid, nth);
+		return NULL;
+	}
+
+	bfs_reader_t* self;
+	self = (bfs_reader_t*) CALLOC(1, sizeof(bfs_reader_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->bfs = bfs;
+	self->tid = tid;
+
+	self->map_request = cc_map_new();
+	if(self->map_request == NULL)
+	{
+		goto fail_map_request;
+	}
+
+	self->list_ready = cc_list_new();
+	if(self->list_ready == NULL)
+	{
+		goto fail_list_ready;
+	}
+
+	self->workq = cc_workq_new((void*) self, nth,
+	                           CC_WORKQ_THREAD_PRIORITY_DEFAULT,
+	                           bfs_reader_run,
+	                           bfs_reader_finishFn);
+	if(self->workq == NULL)
+	{
+		goto fail_workq;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_workq:
+		cc_list_delete(&self->list_ready);
+	fail_list_ready:
+		cc_map_delete(&self->map_request);
+	fail_map_request:
+		FREE(self);
+	return NULL;
+}
+
+void bfs_reader_delete(bfs_reader_t** _self)
+{
+	ASSERT(_self);
+
+	bfs_reader_t* self = *_self;
+	if(self)
+	{
+		// stop the workq threads before the requests are
+		// freed and discard any outstanding waiters
+		cc_workq_delete(&self->workq);
+		cc_list_discard(self->list_ready);
+
+		cc_mapIter_t*        miter;
+		bfs_readerRequest_t* req;
+		miter = cc_map_head(self->map_request);
+		while(miter)
+		{
+			req = (bfs_readerRequest_t*)
+			      cc_map_remove(self->map_request, &miter);
+			bfs_readerRequest_delete(&req);
+		}
+
+		cc_list_delete(&self->list_ready);
+		cc_map_delete(&self->map_request);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int bfs_reader_get(bfs_reader_t* self, const char* name,
+                   int priority, void* priv,
+                   bfs_reader_fn get_fn)
+{
+	// priv may be NULL
+	ASSERT(self);
+	ASSERT(name);
+	ASSERT(get_fn);
+
+	bfs_readerRequest_t* req;
+	req = bfs_reader_request(self, name, priority);
+	if(req == NULL)
+	{
+		return 0;
+	}
+
+	bfs_readerWaiter_t* waiter;
+	waiter = (bfs_readerWaiter_t*)
+	         MALLOC(sizeof(bfs_readerWaiter_t));
+	if(waiter == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+	waiter->priv   = priv;
+	waiter->get_fn = get_fn;
+
+	cc_listIter_t* iter;
+	iter = cc_list_append(req->list_waiter, NULL,
+	                      (const void*) waiter);
+	if(iter == NULL)
+	{
+		goto fail_append;
+	}
+
+	// prefetched requests are delivered by the next flush
+	if((req->state == BFS_READER_STATE_READY) &&
+	   (bfs_reader_ready(self, req) == 0))
+	{
+		goto fail_ready;
+	}
+
+	// success
+	return 1;
+
+	// failure
+	fail_ready:
+		cc_list_remove(req->list_waiter, &iter);
+	fail_append:
+		FREE(waiter);
+	return 0;
+}
+
+int bfs_reader_prefetch(bfs_reader_t* self, int count,
+                        const char** names, int priority)
+{
+	ASSERT(self);
+	ASSERT(names);
+
+	int ret = 1;
+	int i;
+	for(i = 0; i < count; ++i)
+	{
+		if(bfs_reader_request(self, names[i],
+		                      priority) == NULL)
+		{
+			ret = 0;
+		}
+	}
+
+	return ret;
+}
+
+void bfs_reader_flush(bfs_reader_t* self)
+{
+	ASSERT(self);
+
+	// drain completed requests so the waiters may be called
+	// without holding the workq lock
+	void* tasks[BFS_READER_DRAIN];
+	int   status[BFS_READER_DRAIN];
+	int   count;
+	int   i;
+	do
+	{
+		count = cc_workq_drain(self->workq, BFS_READER_DRAIN,
+		                       tasks, status);
+		for(i = 0; i < count; ++i)
+		{
+			bfs_reader_complete(self,
+			                    (bfs_readerRequest_t*) tasks[i],
+			                    status[i]);
+		}
+	} while(count == BFS_READER_DRAIN);
+
+	bfs_reader_deliver(self);
+}
+
+void bfs_reader_finish(bfs_reader_t* self)
+{
+	ASSERT(self);
+
+	// wait for each queued request including requests which
+	// are added by the waiters
+	cc_mapIter_t*        miter;
+	bfs_readerRequest_t* req;
+	int                  status;
+	int                  queued = 1;
+	while(queued)
+	{
+		queued = 0;
+		miter  = cc_map_head(self->map_request);
+		while(miter)
+		{
+			req   = (bfs_readerRequest_t*) cc_map_val(miter);
+			miter = cc_map_next(miter);
+			if(req->state == BFS_READER_STATE_QUEUED)
+			{
+				status = cc_workq_wait(self->workq,
+				                       (void*) req, 1);
+				bfs_reader_complete(self, req, status);
+			}
+		}
+
+		bfs_reader_deliver(self);
+
+		miter = cc_map_head(self->map_request);
+		while(miter)
+		{
+			req = (bfs_readerRequest_t*) cc_map_val(miter);
+			if(req->state == BFS_READER_STATE_QUEUED)
+			{
+				queued = 1;
+				break;
+			}
+			miter = cc_map_next(miter);
+		}
+	}
+}
+
+void bfs_reader_discard(bfs_reader_t* self)
+{
+	ASSERT(self);
+
+	// release prefetched requests which were not requested
+	cc_mapIter_t*        miter;
+	bfs_readerRequest_t* req;
+	miter = cc_map_head(self->map_request);
+	while(miter)
+	{
+		req = (bfs_readerRequest_t*) cc_map_val(miter);
+		if((req->state == BFS_READER_STATE_READY) &&
+		   (cc_list_size(req->list_waiter) == 0))
+		{
+			cc_map_remove(self->map_request, &miter);
+			bfs_readerRequest_delete(&req);
+		}
+		else
+		{
+			miter = cc_map_next(miter);
+		}
+	}
+}
+
+int bfs_reader_pending(bfs_reader_t* self)
+{
+	ASSERT(self);
+
+	return cc_workq_pending(self->workq);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef bfs_reader_H
+#define bfs_reader_H
+
+#include <stddef.h>
+
+#include "bfs_file.h"
+
+/*
+ * callback functions
+ */
+
+// status is 1 when the blob was read successfully and the
+// data is only valid for the duration of the callback
+typedef void (*bfs_reader_fn)(void* priv,
+                              const char* name,
+                              int status,
+                              size_t size,
+                              const void* data);
+
+/*
+ * opaque objects
+ */
+
+typedef struct bfs_reader_s bfs_reader_t;
+
+/*
+ * reader API
+ */
+
+bfs_reader_t* bfs_reader_new(bfs_file_t* bfs,
+                             int tid,
+                             int nth);
+void          bfs_reader_delete(bfs_reader_t** _self);
+int           bfs_reader_get(bfs_reader_t* self,
+                             const char* name,
+                             int priority,
+                             void* priv,
+                             bfs_reader_fn get_fn);
+int           bfs_reader_prefetch(bfs_reader_t* self,
+                                  int count,
+                                  const char** names,
+                                  int priority);
+void          bfs_reader_flush(bfs_reader_t* self);
+void          bfs_reader_finish(bfs_reader_t* self);
+void          bfs_reader_discard(bfs_reader_t* self);
+int           bfs_reader_pending(bfs_reader_t* self);
+
+#endif
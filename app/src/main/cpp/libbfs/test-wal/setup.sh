@@ -0,0 +1,3 @@
+ln -s ../../libbfs
+ln -s ../../libcc
+ln -s ../../libsqlite3
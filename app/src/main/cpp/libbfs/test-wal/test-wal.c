@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LOG_TAG "wal-test"
+#include "libbfs/bfs_file.h"
+#include "libbfs/bfs_util.h"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+
+#define TEST_WAL_READERS 16
+#define TEST_WAL_FNAME   "test-wal.bfs"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct
+{
+	bfs_file_t* bfs;
+	int         blobs;
+	int         size;
+	int         stop;
+} test_state_t;
+
+typedef struct
+{
+	test_state_t* state;
+	int           tid;
+	unsigned int  seed;
+	int           count;
+	int           errors;
+} test_thread_t;
+
+static void test_name(int idx, char* name)
+{
+	ASSERT(name);
+
+	snprintf(name, 256, "tiles/%i.bin", idx);
+}
+
+static void* test_reader(void* arg)
+{
+	ASSERT(arg);
+
+	test_thread_t* self  = (test_thread_t*) arg;
+	test_state_t*  state = self->state;
+
+	char   name[256];
+	size_t size = 0;
+	void*  data = NULL;
+	while(__atomic_load_n(&state->stop, __ATOMIC_ACQUIRE) == 0)
+	{
+		test_name(rand_r(&self->seed)%state->blobs, name);
+		if((bfs_file_blobGet(state->bfs, self->tid, name,
+		                     &size, &data) == 0) ||
+		   (size != state->size))
+		{
+			++self->errors;
+		}
+		++self->count;
+	}
+	FREE(data);
+
+	return NULL;
+}
+
+static void* test_writer(void* arg)
+{
+	ASSERT(arg);
+
+	test_thread_t* self  = (test_thread_t*) arg;
+	test_state_t*  state = self->state;
+
+	char* data = (char*) CALLOC(1, state->size);
+	if(data == NULL)
+	{
+		LOGE("CALLOC failed");
+		++self->errors;
+		return NULL;
+	}
+
+	char name[256];
+	while(__atomic_load_n(&state->stop, __ATOMIC_ACQUIRE) == 0)
+	{
+		test_name(rand_r(&self->seed)%state->blobs, name);
+		memset(data, self->count, state->size);
+		if(bfs_file_blobSet(state->bfs, name, state->size,
+		                    data) == 0)
+		{
+			++self->errors;
+		}
+		++self->count;
+	}
+	FREE(data);
+
+	return NULL;
+}
+
+static int test_create(int blobs, int size)
+{
+	unlink(TEST_WAL_FNAME);
+	unlink(TEST_WAL_FNAME "-wal");
+	unlink(TEST_WAL_FNAME "-shm");
+
+	bfs_file_t* bfs;
+	bfs = bfs_file_open(TEST_WAL_FNAME, 1, BFS_MODE_STREAM);
+	if(bfs == NULL)
+	{
+		return 0;
+	}
+
+	char* data = (char*) CALLOC(1, size);
+	if(data == NULL)
+	{
+		LOGE("CALLOC failed");
+		bfs_file_close(&bfs);
+		return 0;
+	}
+
+	char name[256];
+	int  ret = 1;
+	int  i;
+	for(i = 0; i < blobs; ++i)
+	{
+		test_name(i, name);
+		ret &= bfs_file_blobSet(bfs, name, size, data);
+	}
+
+	FREE(data);
+	bfs_file_close(&bfs);
+
+	return ret;
+}
+
+static int
+test_run(bfs_mode_e mode, int readers, int blobs, int size,
+         double seconds)
+{
+	if(test_create(blobs, size) == 0)
+	{
+		return 0;
+	}
+
+	test_state_t state =
+	{
+		.blobs = blobs,
+		.size  = size,
+	};
+
+	state.bfs = bfs_file_open(TEST_WAL_FNAME, readers, mode);
+	if(state.bfs == NULL)
+	{
+		return 0;
+	}
+
+	pthread_t     threads[TEST_WAL_READERS + 1];
+	test_thread_t thread[TEST_WAL_READERS + 1];
+
+	// the last thread is the writer
+	int n = readers + 1;
+	int i;
+	for(i = 0; i < n; ++i)
+	{
+		thread[i].state  = &state;
+		thread[i].tid    = i;
+		thread[i].seed   = (unsigned int) (i + 1);
+		thread[i].count  = 0;
+		thread[i].errors = 0;
+		if(pthread_create(&threads[i], NULL,
+		                  (i < readers) ? test_reader :
+		                                  test_writer,
+		                  (void*) &thread[i]) != 0)
+		{
+			LOGE("pthread_create failed");
+			n = i;
+			break;
+		}
+	}
+
+	double t0 = cc_timestamp();
+	usleep((useconds_t) (1000000.0*seconds));
+	__atomic_store_n(&state.stop, 1, __ATOMIC_RELEASE);
+
+	int reads  = 0;
+	int writes = 0;
+	int errors = (n == readers + 1) ? 0 : 1;
+	for(i = 0; i < n; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		if(i < readers)
+		{
+			reads += thread[i].count;
+		}
+		else
+		{
+			writes += thread[i].count;
+		}
+		errors += thread[i].errors;
+	}
+	double dt = cc_timestamp() - t0;
+
+	bfs_file_close(&state.bfs);
+
+	LOGI("mode=%s, readers=%i, reads=%.0f/s, writes=%.0f/s, errors=%i",
+	     (mode == BFS_MODE_WAL) ? "WAL" : "RDWR", readers,
+	     ((double) reads)/dt, ((double) writes)/dt, errors);
+
+	return errors ? 0 : 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int    readers = 4;
+	int    blobs   = 1024;
+	int    size    = 16384;
+	double seconds = 2.0;
+	if(argc >= 2)
+	{
+		readers = (int) strtol(argv[1], NULL, 0);
+	}
+	if(argc >= 3)
+	{
+		blobs = (int) strtol(argv[2], NULL, 0);
+	}
+	if(argc >= 4)
+	{
+		size = (int) strtol(argv[3], NULL, 0);
+	}
+
+	if((argc > 4) || (readers < 1) ||
+	   (readers > TEST_WAL_READERS) || (blobs < 1) ||
+	   (size < 1))
+	{
+		LOGE("usage: %s [readers] [blobs] [size]", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if(bfs_util_initialize() == 0)
+	{
+		return EXIT_FAILURE;
+	}
+
+	int ret = 1;
+	int n;
+	for(n = 1; n <= readers; n *= 2)
+	{
+		ret &= test_run(BFS_MODE_RDWR, n, blobs, size, seconds);
+		ret &= test_run(BFS_MODE_WAL, n, blobs, size, seconds);
+	}
+
+	unlink(TEST_WAL_FNAME);
+	bfs_util_shutdown();
+
+	// verify that all buffers were released
+	if((ret == 0) || (cc_memcount() != 0) ||
+	   (cc_memsize() != 0))
+	{
+		MEMINFO();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
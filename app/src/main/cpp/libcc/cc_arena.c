@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_arena.h"
+#include "cc_log.h"
+#include "cc_memory.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define CC_ARENA_ALIGN      16
+#define CC_ARENA_CHUNK_SIZE 65536
+
+static pthread_key_t  cc_arena_key;
+static pthread_once_t cc_arena_once = PTHREAD_ONCE_INIT;
+
+static uintptr_t cc_arena_align(uintptr_t size)
+{
+	return (size + CC_ARENA_ALIGN - 1) &
+	       ~((uintptr_t) CC_ARENA_ALIGN - 1);
+}
+
+static cc_arenaChunk_t* cc_arenaChunk_new(size_t size)
+{
+	// MALLOC does not guarantee CC_ARENA_ALIGN so the data
+	// is aligned after the header
+	cc_arenaChunk_t* self;
+	self = (cc_arenaChunk_t*)
+	       MALLOC(sizeof(cc_arenaChunk_t) +
+	              CC_ARENA_ALIGN - 1 + size);
+	if(self == NULL)
+	{
+		LOGE("MALLOC failed");
+		return NULL;
+	}
+
+	uintptr_t data = (uintptr_t) &self[1];
+
+	self->next = NULL;
+	self->data = (unsigned char*) cc_arena_align(data);
+	self->size = size;
+	self->used = 0;
+
+	return self;
+}
+
+static void cc_arenaChunk_delete(cc_arenaChunk_t** _self)
+{
+	ASSERT(_self);
+
+	cc_arenaChunk_t* self = *_self;
+	if(self)
+	{
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+static void cc_arena_release(cc_arena_t* self,
+                             cc_arenaChunk_t* chunk)
+{
+	ASSERT(self);
+	ASSERT(chunk);
+
+	// retain standard chunks for reuse
+	if(chunk->size == self->chunk_size)
+	{
+		chunk->used = 0;
+		chunk->next = self->free;
+		self->free  = chunk;
+	}
+	else
+	{
+		cc_arenaChunk_delete(&chunk);
+	}
+}
+
+static void cc_arena_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_arena_t* self = (cc_arena_t*) arg;
+	cc_arena_delete(&self);
+}
+
+static void cc_arena_init(void)
+{
+	if(pthread_key_create(&cc_arena_key,
+	                      cc_arena_destruct) != 0)
+	{
+		LOGE("pthread_key_create failed");
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_arena_t* cc_arena_new(size_t chunk_size)
+{
+	cc_arena_t* self;
+	self = (cc_arena_t*) CALLOC(1, sizeof(cc_arena_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(chunk_size == 0)
+	{
+		chunk_size = CC_ARENA_CHUNK_SIZE;
+	}
+	self->chunk_size = cc_arena_align(chunk_size);
+
+	return self;
+}
+
+void cc_arena_delete(cc_arena_t** _self)
+{
+	ASSERT(_self);
+
+	cc_arena_t* self = *_self;
+	if(self)
+	{
+		cc_arena_reset(self, NULL);
+		cc_arena_trim(self);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void* cc_arena_alloc(cc_arena_t* self, size_t size)
+{
+	ASSERT(self);
+
+	size = cc_arena_align(size ? size : 1);
+
+	// bump the current chunk
+	cc_arenaChunk_t* chunk = self->chunks;
+	if(chunk && (chunk->used + size <= chunk->size))
+	{
+		void* ptr = (void*) (chunk->data + chunk->used);
+		chunk->used += size;
+		return ptr;
+	}
+
+	// allocations which do not fit in a standard chunk
+	// have a dedicated chunk
+	if(size > self->chunk_size)
+	{
+		chunk = cc_arenaChunk_new(size);
+	}
+	else if(self->free)
+	{
+		chunk      = self->free;
+		self->free = chunk->next;
+	}
+	else
+	{
+		chunk = cc_arenaChunk_new(self->chunk_size);
+	}
+
+	if(chunk == NULL)
+	{
+		return NULL;
+	}
+
+	chunk->next  = self->chunks;
+	chunk->used  = size;
+	self->chunks = chunk;
+
+	return (void*) chunk->data;
+}
+
+void* cc_arena_calloc(cc_arena_t* self, size_t count,
+                      size_t size)
+{
+	ASSERT(self);
+
+	if(size && (count > SIZE_MAX/size))
+	{
+		LOGE("invalid count=%" PRIu64 ", size=%" PRIu64,
+		     (uint64_t) count, (uint64_t) size);
+		return NULL;
+	}
+
+	void* ptr = cc_arena_alloc(self, count*size);
+	if(ptr)
+	{
+		memset(ptr, 0, count*size);
+	}
+
+	return ptr;
+}
+
+void cc_arena_mark(cc_arena_t* self, cc_arenaMark_t* mark)
+{
+	ASSERT(self);
+	ASSERT(mark);
+
+	mark->chunk = self->chunks;
+	mark->used  = self->chunks ? self->chunks->used : 0;
+}
+
+void cc_arena_reset(cc_arena_t* self, cc_arenaMark_t* mark)
+{
+	// mark may be NULL
+	ASSERT(self);
+
+	// release all chunks allocated after the mark
+	cc_arenaChunk_t* chunk;
+	cc_arenaChunk_t* end = mark ? mark->chunk : NULL;
+	while(self->chunks && (self->chunks != end))
+	{
+		chunk        = self->chunks;
+		self->chunks = chunk->next;
+		cc_arena_release(self, chunk);
+	}
+
+	if(self->chunks)
+	{
+		ASSERT(mark);
+		ASSERT(mark->used <= self->chunks->used);
+		self->chunks->used = mark->used;
+	}
+}
+
+void cc_arena_trim(cc_arena_t* self)
+{
+	ASSERT(self);
+
+	cc_arenaChunk_t* chunk;
+	while(self->free)
+	{
+		chunk      = self->free;
+		self->free = chunk->next;
+		cc_arenaChunk_delete(&chunk);
+	}
+}
+
+cc_arena_t* cc_arena_thread(void)
+{
+	pthread_once(&cc_arena_once, cc_arena_init);
+
+	cc_arena_t* self;
+	self = (cc_arena_t*) pthread_getspecific(cc_arena_key);
+	if(self)
+	{
+		return self;
+	}
+
+	self = cc_arena_new(0);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	if(pthread_setspecific(cc_arena_key, (const void*) self) != 0)
+	{
+		LOGE("pthread_setspecific failed");
+		cc_arena_delete(&self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void cc_arena_threadDelete(void)
+{
+	pthread_once(&cc_arena_once, cc_arena_init);
+
+	// the main thread does not run the key destructor so the
+	// default arena must be deleted before checking memory
+	cc_arena_t* self;
+	self = (cc_arena_t*) pthread_getspecific(cc_arena_key);
+	if(self)
+	{
+		pthread_setspecific(cc_arena_key, NULL);
+		cc_arena_delete(&self);
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_arena_H
+#define cc_arena_H
+
+#include <stddef.h>
+
+typedef struct cc_arenaChunk_s
+{
+	struct cc_arenaChunk_s* next;
+	unsigned char*          data;
+	size_t                  size;
+	size_t                  used;
+} cc_arenaChunk_t;
+
+// arena state which may be restored by cc_arena_reset
+typedef struct
+{
+	cc_arenaChunk_t* chunk;
+	size_t           used;
+} cc_arenaMark_t;
+
+typedef struct
+{
+	size_t chunk_size;
+
+	// chunks are allocated with MALLOC so they are counted by
+	// cc_meminfo and the head is the current chunk
+	cc_arenaChunk_t* chunks;
+
+	// retained chunks which are reused after a reset
+	cc_arenaChunk_t* free;
+} cc_arena_t;
+
+cc_arena_t* cc_arena_new(size_t chunk_size);
+void        cc_arena_delete(cc_arena_t** _self);
+void*       cc_arena_alloc(cc_arena_t* self, size_t size);
+void*       cc_arena_calloc(cc_arena_t* self, size_t count,
+                            size_t size);
+void        cc_arena_mark(cc_arena_t* self,
+                          cc_arenaMark_t* mark);
+void        cc_arena_reset(cc_arena_t* self,
+                           cc_arenaMark_t* mark);
+void        cc_arena_trim(cc_arena_t* self);
+cc_arena_t* cc_arena_thread(void);
+void        cc_arena_threadDelete(void);
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_intern.h"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_mumurhash3.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define CC_INTERN_KEYLEN   256
+#define CC_INTERN_CAPACITY 64
+#define CC_INTERN_SEED     0x9747B28C
+
+static cc_internStr_t* cc_intern_header(const char* istr)
+{
+	ASSERT(istr);
+
+	return (cc_internStr_t*)
+	       (istr - sizeof(cc_internStr_t));
+}
+
+static int
+cc_intern_key(const char* str, uint64_t* key64,
+              const uint8_t** _key8, uint32_t* _hash)
+{
+	ASSERT(str);
+	ASSERT(key64);
+	ASSERT(_key8);
+	ASSERT(_hash);
+
+	int len = strlen(str) + 1;
+	if(len > CC_INTERN_KEYLEN)
+	{
+		LOGE("invalid len=%i", len);
+		return 0;
+	}
+
+	// force 8-byte alignment for cc_mumurhash3
+	const uint8_t* key8 = (const uint8_t*) str;
+	if((((uintptr_t) str) % 8) != 0)
+	{
+		memcpy((void*) key64, (const void*) str, len);
+		key8 = (const uint8_t*) key64;
+	}
+
+	*_key8 = key8;
+	*_hash = cc_mumurhash3(CC_INTERN_SEED, len, key8);
+	return len;
+}
+
+static int
+cc_intern_probe(const cc_intern_t* self, uint32_t hash,
+                int len, const uint8_t* key8)
+{
+	ASSERT(self);
+	ASSERT(key8);
+
+	// returns the slot of the matching string or the empty
+	// slot where the string may be inserted
+	int             mask = self->capacity - 1;
+	int             idx  = (int) (hash & mask);
+	cc_internStr_t* node;
+	while(1)
+	{
+		node = self->table[idx];
+		if((node == NULL) ||
+		   ((node->hash == hash) && (node->len == len) &&
+		    (memcmp((const void*) &node[1],
+		            (const void*) key8, len) == 0)))
+		{
+			return idx;
+		}
+		idx = (idx + 1) & mask;
+	}
+}
+
+static int cc_intern_grow(cc_intern_t* self)
+{
+	ASSERT(self);
+
+	int capacity = 2*self->capacity;
+
+	cc_internStr_t** table;
+	table = (cc_internStr_t**)
+	        CALLOC(capacity, sizeof(cc_internStr_t*));
+	if(table == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	// reinsert the strings using the cached hash
+	int mask = capacity - 1;
+	int i;
+	int idx;
+	for(i = 0; i < self->capacity; ++i)
+	{
+		cc_internStr_t* node = self->table[i];
+		if(node == NULL)
+		{
+			continue;
+		}
+
+		idx = (int) (node->hash & mask);
+		while(table[idx])
+		{
+			idx = (idx + 1) & mask;
+		}
+		table[idx] = node;
+	}
+
+	FREE(self->table);
+	self->capacity = capacity;
+	self->table    = table;
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_intern_t* cc_intern_new(void)
+{
+	cc_intern_t* self;
+	self = (cc_intern_t*) CALLOC(1, sizeof(cc_intern_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->arena = cc_arena_new(4096);
+	if(self->arena == NULL)
+	{
+		goto fail_arena;
+	}
+
+	self->capacity = CC_INTERN_CAPACITY;
+	self->table    = (cc_internStr_t**)
+	                 CALLOC(self->capacity,
+	                        sizeof(cc_internStr_t*));
+	if(self->table == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_table;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_table:
+		cc_arena_delete(&self->arena);
+	fail_arena:
+		FREE(self);
+	return NULL;
+}
+
+void cc_intern_delete(cc_intern_t** _self)
+{
+	ASSERT(_self);
+
+	cc_intern_t* self = *_self;
+	if(self)
+	{
+		FREE(self->table);
+		cc_arena_delete(&self->arena);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int cc_intern_size(const cc_intern_t* self)
+{
+	ASSERT(self);
+
+	return self->count;
+}
+
+const char*
+cc_intern_find(const cc_intern_t* self, const char* str)
+{
+	ASSERT(self);
+	ASSERT(str);
+
+	uint64_t       key64[CC_INTERN_KEYLEN/8];
+	const uint8_t* key8;
+	uint32_t       hash;
+	int len = cc_intern_key(str, key64, &key8, &hash);
+	if(len == 0)
+	{
+		return NULL;
+	}
+
+	int idx = cc_intern_probe(self, hash, len, key8);
+	if(self->table[idx] == NULL)
+	{
+		return NULL;
+	}
+
+	return (const char*) &self->table[idx][1];
+}
+
+const char*
+cc_intern_str(cc_intern_t* self, const char* str)
+{
+	ASSERT(self);
+	ASSERT(str);
+
+	uint64_t       key64[CC_INTERN_KEYLEN/8];
+	const uint8_t* key8;
+	uint32_t       hash;
+	int len = cc_intern_key(str, key64, &key8, &hash);
+	if(len == 0)
+	{
+		return NULL;
+	}
+
+	int idx = cc_intern_probe(self, hash, len, key8);
+	if(self->table[idx])
+	{
+		return (const char*) &self->table[idx][1];
+	}
+
+	// maintain a maximum load factor of 1/2
+	if(2*(self->count + 1) > self->capacity)
+	{
+		if(cc_intern_grow(self) == 0)
+		{
+			return NULL;
+		}
+		idx = cc_intern_probe(self, hash, len, key8);
+	}
+
+	cc_internStr_t* node;
+	node = (cc_internStr_t*)
+	       cc_arena_alloc(self->arena,
+	                      sizeof(cc_internStr_t) + len);
+	if(node == NULL)
+	{
+		return NULL;
+	}
+
+	node->hash = hash;
+	node->id   = self->count;
+	node->len  = len;
+	node->pad  = 0;
+	memcpy((void*) &node[1], (const void*) str, len);
+
+	self->table[idx] = node;
+	++self->count;
+
+	return (const char*) &node[1];
+}
+
+const char*
+cc_intern_strf(cc_intern_t* self, const char* fmt, ...)
+{
+	ASSERT(self);
+	ASSERT(fmt);
+
+	char str[CC_INTERN_KEYLEN];
+	va_list argptr;
+	va_start(argptr, fmt);
+	vsnprintf(str, CC_INTERN_KEYLEN, fmt, argptr);
+	va_end(argptr);
+
+	return cc_intern_str(self, str);
+}
+
+int cc_intern_id(const char* istr)
+{
+	ASSERT(istr);
+
+	return cc_intern_header(istr)->id;
+}
+
+uint32_t cc_intern_hash(const char* istr)
+{
+	ASSERT(istr);
+
+	return cc_intern_header(istr)->hash;
+}
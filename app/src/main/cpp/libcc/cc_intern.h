@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_intern_H
+#define cc_intern_H
+
+#include <stdint.h>
+
+#include "cc_arena.h"
+
+// interned strings are prefixed by a header which caches
+// the hash so that cc_map_findi/cc_map_addi may skip
+// hashing and compare the interned pointer
+typedef struct
+{
+	uint32_t hash;
+	int      id;
+	int      len;
+	int      pad;
+	// char  str[];
+} cc_internStr_t;
+
+typedef struct
+{
+	// interned strings are stored in the arena so the
+	// pointers are stable until the table is deleted
+	cc_arena_t* arena;
+
+	// open addressing table with linear probing
+	int              count;
+	int              capacity;
+	cc_internStr_t** table;
+} cc_intern_t;
+
+// the table is not thread safe and interned strings are
+// only released by cc_intern_delete
+cc_intern_t* cc_intern_new(void);
+void         cc_intern_delete(cc_intern_t** _self);
+int          cc_intern_size(const cc_intern_t* self);
+const char*  cc_intern_find(const cc_intern_t* self,
+                            const char* str);
+const char*  cc_intern_str(cc_intern_t* self,
+                           const char* str);
+const char*  cc_intern_strf(cc_intern_t* self,
+                            const char* fmt, ...);
+int          cc_intern_id(const char* istr);
+uint32_t     cc_intern_hash(const char* istr);
+
+#endif
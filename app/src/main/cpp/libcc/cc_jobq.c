@@ -319,6 +319,53 @@ int cc_jobq_run(cc_jobq_t* self, void* task)
 	return 1;
 }
 
+int cc_jobq_runBatch(cc_jobq_t* self, int count,
+                     void** tasks)
+{
+	ASSERT(self);
+	ASSERT(tasks);
+
+	pthread_mutex_lock(&self->mutex);
+
+	int i;
+	cc_listIter_t* iter;
+	for(i = 0; i < count; ++i)
+	{
+		iter = cc_list_append(self->queue_pending, NULL,
+		                      (const void*) tasks[i]);
+		if(iter == NULL)
+		{
+			goto fail_append;
+		}
+	}
+
+	// wake up jobq threads once for all tasks
+	if(self->state == CC_JOBQ_STATE_RUNNING)
+	{
+		pthread_cond_broadcast(&self->cond_pending);
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	// success
+	return 1;
+
+	// failure
+	fail_append:
+	{
+		// the tasks have not been woken so remove them
+		// from the tail of the pending queue
+		int j;
+		for(j = 0; j < i; ++j)
+		{
+			iter = cc_list_tail(self->queue_pending);
+			cc_list_remove(self->queue_pending, &iter);
+		}
+		pthread_mutex_unlock(&self->mutex);
+	}
+	return 0;
+}
+
 int cc_jobq_pending(cc_jobq_t* self)
 {
 	ASSERT(self);
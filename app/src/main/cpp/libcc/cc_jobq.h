@@ -67,6 +67,8 @@ void        cc_jobq_pause(cc_jobq_t* self);
 void        cc_jobq_resume(cc_jobq_t* self);
 void        cc_jobq_finish(cc_jobq_t* self);
 int         cc_jobq_run(cc_jobq_t* self, void* task);
+int         cc_jobq_runBatch(cc_jobq_t* self, int count,
+                             void** tasks);
 int         cc_jobq_pending(cc_jobq_t* self);
 
 #endif
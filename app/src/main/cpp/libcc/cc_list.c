@@ -21,6 +21,7 @@
  *
  */
 
+#include <inttypes.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,26 +37,65 @@
 * protected - global listIter pool                         *
 ***********************************************************/
 
-#define CC_LISTBLOCK_SIZE 1024
-#define CC_LISTSET_SIZE   32
+#define CC_LISTBLOCK_SIZE  1024
+#define CC_LISTSET_SIZE    32
+#define CC_LISTSET_COUNT   (CC_LISTBLOCK_SIZE/CC_LISTSET_SIZE)
+#define CC_LISTCHUNK_SIZE  1024
+#define CC_LISTTABLE_SIZE  4096
+#define CC_LISTCACHE_SIZE  (4*CC_LISTSET_SIZE)
 
-typedef struct cc_listBlock_s cc_listBlock_t;
+// a set references CC_LISTSET_SIZE free iters and is
+// linked by index into one of the lock-free set stacks
+typedef struct
+{
+	cc_listIter_t* iters;
+	uint32_t       next;
+} cc_listSet_t;
 
-typedef struct cc_listBlock_s
+typedef struct
 {
-	cc_listIter_t   array[CC_LISTBLOCK_SIZE];
-	cc_listBlock_t* next;
+	cc_listIter_t array[CC_LISTBLOCK_SIZE];
+	cc_listSet_t  sets[CC_LISTSET_COUNT];
 } cc_listBlock_t;
 
+// per-thread cache of free iters
+typedef struct
+{
+	uint32_t       generation;
+	int            count;
+	cc_listIter_t* iters;
+} cc_listCache_t;
+
 typedef struct
 {
-	size_t          refcount;
-	size_t          count;
-	cc_listIter_t*  iters; // sll of free iter references
-	cc_listBlock_t* blocks;
+	// number of iters checked out to lists (atomic)
+	size_t refcount;
+
+	// the generation is incremented when the blocks are
+	// freed to invalidate the per-thread caches (atomic)
+	uint32_t generation;
+
+	// lock-free stacks of sets which reference free iters
+	// or which are empty
+	// stack = (tag << 32) | (index + 1) (atomic)
+	uint64_t sets_full;
+	uint64_t sets_empty;
+
+	// block allocation and release requires the mutex
+	uint32_t        block_count;
 	pthread_mutex_t mutex;
 } cc_listPool_t;
 
+// the block table is indexed by the set stacks and grows
+// by chunks of block pointers which are allocated under the
+// pool mutex and never move so lock-free readers remain
+// valid (4M blocks maximum to fit the 32-bit set index)
+static cc_listBlock_t** g_list_blocks[CC_LISTTABLE_SIZE];
+
+static pthread_once_t g_list_once   = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_list_key;
+static int            g_list_key_ok = 0;
+
 // Android does not allow the use of
 // PTHREAD_MUTEX_INITIALIZER due to the Android app life
 // cycle as the mutex is not reinitialized after
@@ -67,7 +107,12 @@ static cc_listPool_t g_list_pool;
 
 int cc_listPool_init(void)
 {
+	// preserve the generation to invalidate any caches
+	// which outlived the previous pool
+	uint32_t generation = g_list_pool.generation;
+
 	memset(&g_list_pool, 0, sizeof(cc_listPool_t));
+	g_list_pool.generation = generation + 1;
 	if(pthread_mutex_init(&g_list_pool.mutex, NULL) != 0)
 	{
 		LOGE("pthread_mutex_init failed");
@@ -92,58 +137,393 @@ static cc_listPool_t g_list_pool =
 * private - global listIter pool                           *
 ***********************************************************/
 
-static cc_listIter_t* cc_listPool_get(void)
+static cc_listSet_t*
+cc_listPool_set(cc_listPool_t* self, uint32_t index)
 {
-	cc_listPool_t* pool = &g_list_pool;
+	ASSERT(self);
+
+	uint32_t        b = index/CC_LISTSET_COUNT;
+	cc_listBlock_t* block;
+	block = g_list_blocks[b/CC_LISTCHUNK_SIZE][b%CC_LISTCHUNK_SIZE];
+	return &block->sets[index%CC_LISTSET_COUNT];
+}
+
+static void
+cc_listPool_push(cc_listPool_t* self, uint64_t* stack,
+                 uint32_t index)
+{
+	ASSERT(self);
+	ASSERT(stack);
+
+	cc_listSet_t* set = cc_listPool_set(self, index);
+
+	// the tag prevents the ABA problem
+	uint64_t old = __atomic_load_n(stack, __ATOMIC_ACQUIRE);
+	uint64_t new;
+	do
+	{
+		__atomic_store_n(&set->next, (uint32_t) old,
+		                 __ATOMIC_RELAXED);
+		new = (((old >> 32) + 1) << 32) |
+		      ((uint64_t) (index + 1));
+	} while(__atomic_compare_exchange_n(stack, &old, new, 1,
+	                                    __ATOMIC_ACQ_REL,
+	                                    __ATOMIC_ACQUIRE) == 0);
+}
+
+static int
+cc_listPool_pop(cc_listPool_t* self, uint64_t* stack,
+                uint32_t* _index)
+{
+	ASSERT(self);
+	ASSERT(stack);
+	ASSERT(_index);
+
+	uint64_t old = __atomic_load_n(stack, __ATOMIC_ACQUIRE);
+	uint64_t new;
+	uint32_t index1;
+	do
+	{
+		index1 = (uint32_t) old;
+		if(index1 == 0)
+		{
+			return 0;
+		}
+
+		// the set may be popped concurrently in which case
+		// next is stale and the tag causes a retry
+		cc_listSet_t* set = cc_listPool_set(self, index1 - 1);
+		uint32_t      next;
+		next = __atomic_load_n(&set->next, __ATOMIC_RELAXED);
+		new  = (((old >> 32) + 1) << 32) | ((uint64_t) next);
+	} while(__atomic_compare_exchange_n(stack, &old, new, 1,
+	                                    __ATOMIC_ACQ_REL,
+	                                    __ATOMIC_ACQUIRE) == 0);
+
+	*_index = index1 - 1;
+	return 1;
+}
+
+static void cc_listPool_release(cc_listPool_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+
+	// the generation must be incremented before checking
+	// the refcount since the cache validation increments
+	// the refcount before checking the generation
+	__atomic_add_fetch(&self->generation, 1,
+	                   __ATOMIC_SEQ_CST);
+
+	// free all blocks when not needed
+	if(__atomic_load_n(&self->refcount,
+	                   __ATOMIC_SEQ_CST) == 0)
+	{
+		uint32_t i;
+		for(i = 0; i < self->block_count; ++i)
+		{
+			FREE(g_list_blocks[i/CC_LISTCHUNK_SIZE]
+			                  [i%CC_LISTCHUNK_SIZE]);
+		}
+
+		for(i = 0; i < CC_LISTTABLE_SIZE; ++i)
+		{
+			FREE(g_list_blocks[i]);
+			g_list_blocks[i] = NULL;
+		}
+		self->block_count = 0;
+		self->sets_full   = 0;
+		self->sets_empty  = 0;
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+}
+
+static void
+cc_listPool_leave(cc_listPool_t* self, size_t count)
+{
+	ASSERT(self);
+
+	if(__atomic_sub_fetch(&self->refcount, count,
+	                      __ATOMIC_SEQ_CST) == 0)
+	{
+		cc_listPool_release(self);
+	}
+}
+
+static void
+cc_listCache_validate(cc_listCache_t* self,
+                      cc_listPool_t* pool)
+{
+	ASSERT(self);
+	ASSERT(pool);
+
+	// discard the cache when the blocks were released
+	// and wait for the release to finish
+	uint32_t generation;
+	generation = __atomic_load_n(&pool->generation,
+	                             __ATOMIC_SEQ_CST);
+	if(self->generation != generation)
+	{
+		pthread_mutex_lock(&pool->mutex);
+		self->generation = pool->generation;
+		self->count      = 0;
+		self->iters      = NULL;
+		pthread_mutex_unlock(&pool->mutex);
+	}
+}
+
+static cc_listIter_t*
+cc_listCache_detach(cc_listCache_t* self)
+{
+	ASSERT(self);
+	ASSERT(self->count >= CC_LISTSET_SIZE);
+
+	int            i;
+	cc_listIter_t* iters = self->iters;
+	cc_listIter_t* tail  = NULL;
+	for(i = 0; i < CC_LISTSET_SIZE; ++i)
+	{
+		tail        = self->iters;
+		self->iters = self->iters->next;
+	}
+	tail->next   = NULL;
+	self->count -= CC_LISTSET_SIZE;
+
+	return iters;
+}
+
+static void
+cc_listCache_spill(cc_listCache_t* self,
+                   cc_listPool_t* pool, int count)
+{
+	ASSERT(self);
+	ASSERT(pool);
+
+	// move sets from the cache to the full stack
+	uint32_t index;
+	while(self->count > count)
+	{
+		if(cc_listPool_pop(pool, &pool->sets_empty,
+		                   &index) == 0)
+		{
+			// empty sets always exist since the number of
+			// sets matches the number of iters
+			LOGE("invalid");
+			return;
+		}
+
+		cc_listSet_t* set = cc_listPool_set(pool, index);
+		set->iters = cc_listCache_detach(self);
+		cc_listPool_push(pool, &pool->sets_full, index);
+	}
+}
+
+static cc_listIter_t*
+cc_listCache_get(cc_listCache_t* self, cc_listPool_t* pool)
+{
+	ASSERT(self);
+	ASSERT(pool);
+
+	cc_listCache_validate(self, pool);
+
+	// get a set of free iters from the cache
+	if(self->count >= CC_LISTSET_SIZE)
+	{
+		return cc_listCache_detach(self);
+	}
+
+	// get a set of free iters from the full stack
+	uint32_t       index;
+	cc_listSet_t*  set;
+	cc_listIter_t* iters;
+	if(cc_listPool_pop(pool, &pool->sets_full, &index))
+	{
+		set   = cc_listPool_set(pool, index);
+		iters = set->iters;
+		cc_listPool_push(pool, &pool->sets_empty, index);
+		return iters;
+	}
 
 	pthread_mutex_lock(&pool->mutex);
 
-	// check if free iters exist
-	if(pool->count < CC_LISTSET_SIZE)
+	// grow the block table
+	uint32_t b = pool->block_count;
+	uint32_t c = b/CC_LISTCHUNK_SIZE;
+	if(c >= CC_LISTTABLE_SIZE)
+	{
+		// silently fail
+		pthread_mutex_unlock(&pool->mutex);
+		return NULL;
+	}
+	else if(g_list_blocks[c] == NULL)
 	{
-		// create a new block
-		cc_listBlock_t* block;
-		block = (cc_listBlock_t*)
-		        CALLOC(1, sizeof(cc_listBlock_t));
-		if(block == NULL)
+		g_list_blocks[c] = (cc_listBlock_t**)
+		                   CALLOC(CC_LISTCHUNK_SIZE,
+		                          sizeof(cc_listBlock_t*));
+		if(g_list_blocks[c] == NULL)
 		{
 			// silently fail
 			pthread_mutex_unlock(&pool->mutex);
 			return NULL;
 		}
+	}
+
+	// create a new block
+	cc_listBlock_t* block;
+	block = (cc_listBlock_t*)
+	        CALLOC(1, sizeof(cc_listBlock_t));
+	if(block == NULL)
+	{
+		// silently fail
+		pthread_mutex_unlock(&pool->mutex);
+		return NULL;
+	}
 
-		// insert block to list
-		block->next  = pool->blocks;
-		pool->blocks = block;
+	g_list_blocks[c][b%CC_LISTCHUNK_SIZE] = block;
+	++pool->block_count;
 
-		// insert iter to list of free iters
-		int i;
-		for(i = 0; i < CC_LISTBLOCK_SIZE; ++i)
+	// split the block into sets of free iters and keep
+	// the first set
+	int i;
+	int j;
+	iters = NULL;
+	for(j = 0; j < CC_LISTSET_COUNT; ++j)
+	{
+		cc_listIter_t* array;
+		array = &block->array[j*CC_LISTSET_SIZE];
+		for(i = 0; i < (CC_LISTSET_SIZE - 1); ++i)
 		{
-			cc_listIter_t* iter;
-			iter        = &block->array[i];
-			iter->next  = pool->iters;
-			pool->iters = iter;
+			array[i].next = &array[i + 1];
 		}
 
-		pool->count += CC_LISTBLOCK_SIZE;
+		index = b*CC_LISTSET_COUNT + j;
+		if(j == 0)
+		{
+			iters = array;
+			cc_listPool_push(pool, &pool->sets_empty, index);
+		}
+		else
+		{
+			block->sets[j].iters = array;
+			cc_listPool_push(pool, &pool->sets_full, index);
+		}
 	}
 
-	// get a set of free iters
-	int i;
-	cc_listIter_t* iters = pool->iters;
-	cc_listIter_t* tail;
-	for(i = 0; i < CC_LISTSET_SIZE; ++i)
+	pthread_mutex_unlock(&pool->mutex);
+
+	return iters;
+}
+
+static void
+cc_listCache_put(cc_listCache_t* self, cc_listPool_t* pool,
+                 cc_listIter_t* iters, cc_listIter_t* tail,
+                 int count)
+{
+	ASSERT(self);
+	ASSERT(pool);
+	ASSERT(iters);
+	ASSERT(tail);
+
+	cc_listCache_validate(self, pool);
+
+	// insert iters into the cache
+	tail->next   = self->iters;
+	self->iters  = iters;
+	self->count += count;
+
+	cc_listCache_spill(self, pool, CC_LISTCACHE_SIZE);
+}
+
+static void cc_listCache_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_listCache_t* self = (cc_listCache_t*) arg;
+	cc_listPool_t*  pool = &g_list_pool;
+
+	// hold a reference while accessing the pool
+	// note that less than CC_LISTSET_SIZE iters remain in
+	// the cache and are reclaimed when the pool is released
+	__atomic_add_fetch(&pool->refcount, 1, __ATOMIC_SEQ_CST);
+	cc_listCache_validate(self, pool);
+	cc_listCache_spill(self, pool, CC_LISTSET_SIZE - 1);
+	cc_listPool_leave(pool, 1);
+
+	free(self);
+}
+
+static void cc_listCache_once(void)
+{
+	if(pthread_key_create(&g_list_key,
+	                      cc_listCache_destruct) == 0)
 	{
-		tail        = pool->iters;
-		pool->iters = pool->iters->next;
+		g_list_key_ok = 1;
 	}
-	tail->next = NULL;
+}
 
-	pool->count    -= CC_LISTSET_SIZE;
-	pool->refcount += CC_LISTSET_SIZE;
+static cc_listCache_t* cc_listCache_thread(void)
+{
+	pthread_once(&g_list_once, cc_listCache_once);
+	if(g_list_key_ok == 0)
+	{
+		return NULL;
+	}
 
-	pthread_mutex_unlock(&pool->mutex);
+	cc_listCache_t* self;
+	self = (cc_listCache_t*) pthread_getspecific(g_list_key);
+	if(self)
+	{
+		return self;
+	}
+
+	// the cache is not tracked by cc_memory since it may
+	// outlive the lists (e.g. the main thread)
+	self = (cc_listCache_t*)
+	       calloc(1, sizeof(cc_listCache_t));
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	// force validation on first use
+	self->generation = __atomic_load_n(&g_list_pool.generation,
+	                                   __ATOMIC_SEQ_CST) - 1;
+	if(pthread_setspecific(g_list_key, (const void*) self) != 0)
+	{
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+static cc_listIter_t* cc_listPool_get(void)
+{
+	cc_listPool_t* pool = &g_list_pool;
+
+	// the refcount must be incremented before accessing
+	// the cache or stacks to prevent a concurrent release
+	__atomic_add_fetch(&pool->refcount, CC_LISTSET_SIZE,
+	                   __ATOMIC_SEQ_CST);
+
+	// the stack cache is a fallback when the thread cache
+	// is unavailable
+	cc_listCache_t  tmp   = { .generation=0 };
+	cc_listCache_t* cache = cc_listCache_thread();
+	if(cache == NULL)
+	{
+		cache = &tmp;
+		cache->generation = __atomic_load_n(&pool->generation,
+		                                    __ATOMIC_SEQ_CST) - 1;
+	}
+
+	cc_listIter_t* iters = cc_listCache_get(cache, pool);
+	if(iters == NULL)
+	{
+		cc_listPool_leave(pool, CC_LISTSET_SIZE);
+	}
 
 	return iters;
 }
@@ -161,7 +541,7 @@ static void cc_listPool_put(cc_listIter_t* iters)
 	}
 
 	// count iters and find tail iter
-	size_t         count = 1;
+	int            count = 1;
 	cc_listIter_t* tail  = iters;
 	while(tail->next)
 	{
@@ -169,29 +549,25 @@ static void cc_listPool_put(cc_listIter_t* iters)
 		tail = tail->next;
 	}
 
-	pthread_mutex_lock(&pool->mutex);
-
-	// insert iters into free iters
-	tail->next   = pool->iters;
-	pool->iters  = iters;
-	pool->count += count;
-
-	// free all blocks when not needed
-	pool->refcount -= count;
-	if(pool->refcount == 0)
+	// the iters which are returned hold the refcount
+	// note that a partial set in the stack cache is
+	// reclaimed when the pool is released
+	cc_listCache_t  tmp   = { .generation=0 };
+	cc_listCache_t* cache = cc_listCache_thread();
+	if(cache == NULL)
 	{
-		pool->iters = NULL;
-
-		cc_listBlock_t* block = pool->blocks;
-		while(block)
-		{
-			pool->blocks = pool->blocks->next;
-			FREE(block);
-			block = pool->blocks;
-		}
+		cache = &tmp;
+		cache->generation = __atomic_load_n(&pool->generation,
+		                                    __ATOMIC_SEQ_CST) - 1;
+		cc_listCache_put(cache, pool, iters, tail, count);
+		cc_listCache_spill(cache, pool, CC_LISTSET_SIZE - 1);
+	}
+	else
+	{
+		cc_listCache_put(cache, pool, iters, tail, count);
 	}
 
-	pthread_mutex_unlock(&pool->mutex);
+	cc_listPool_leave(pool, count);
 }
 
 /***********************************************************
@@ -29,6 +29,7 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#define LOG_TAG "cc"
 #include "cc_log.h"
 
 // Android Systrace
@@ -38,6 +39,204 @@
 static int g_trace_fd = -1;
 #endif
 
+// Linux trace
+// open trace with chrome://tracing or ui.perfetto.dev
+// events are recorded in per-thread ring buffers and the
+// trace is exported to $CC_TRACE_FILE (or trace.json) at
+// exit or on SIGUSR2
+#if !defined(ANDROID) && !defined(__EMSCRIPTEN__)
+	#define CC_TRACE_LINUX
+#endif
+
+#ifdef CC_TRACE_LINUX
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+// must be a power of two
+#define CC_TRACE_COUNT 65536
+
+#define CC_TRACE_BEGIN 0
+#define CC_TRACE_END   1
+
+typedef struct
+{
+	uint64_t    ts;
+	const char* func;
+	int         line;
+	int         type;
+} cc_traceEvent_t;
+
+typedef struct cc_traceThread_s
+{
+	int tid;
+
+	// exited is protected by g_trace_mutex
+	int exited;
+
+	// head is written by the owner only and the ring keeps
+	// the most recent CC_TRACE_COUNT events
+	uint32_t head;
+
+	cc_traceEvent_t events[CC_TRACE_COUNT];
+
+	struct cc_traceThread_s* next;
+} cc_traceThread_t;
+
+static pthread_once_t   g_trace_once    = PTHREAD_ONCE_INIT;
+static pthread_key_t    g_trace_key;
+static pthread_mutex_t  g_trace_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static cc_traceThread_t* g_trace_threads = NULL;
+static int              g_trace_key_ok  = 0;
+static int              g_trace_signal  = 0;
+
+static void cc_trace_signal(int signum)
+{
+	// the trace is exported by the next traced thread since
+	// the export is not async-signal-safe
+	__atomic_store_n(&g_trace_signal, 1, __ATOMIC_RELAXED);
+}
+
+static void cc_trace_exit(void)
+{
+	cc_trace_export(NULL);
+}
+
+static void cc_trace_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_traceThread_t* thread = (cc_traceThread_t*) arg;
+
+	// thread buffers are retained after the thread exits so
+	// that its events are included in the export until the
+	// buffer is reused by a new thread which bounds the
+	// memory by the peak number of traced threads
+	pthread_mutex_lock(&g_trace_mutex);
+	thread->exited = 1;
+	pthread_mutex_unlock(&g_trace_mutex);
+}
+
+static void cc_trace_once(void)
+{
+	if(pthread_key_create(&g_trace_key,
+	                      cc_trace_destruct) != 0)
+	{
+		return;
+	}
+	g_trace_key_ok = 1;
+
+	atexit(cc_trace_exit);
+
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(struct sigaction));
+	sa.sa_handler = cc_trace_signal;
+	sa.sa_flags   = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGUSR2, &sa, NULL);
+}
+
+static cc_traceThread_t* cc_trace_thread(void)
+{
+	pthread_once(&g_trace_once, cc_trace_once);
+	if(g_trace_key_ok == 0)
+	{
+		return NULL;
+	}
+
+	cc_traceThread_t* thread;
+	thread = (cc_traceThread_t*) pthread_getspecific(g_trace_key);
+	if(thread)
+	{
+		return thread;
+	}
+
+	pthread_mutex_lock(&g_trace_mutex);
+
+	// reuse the buffer of an exited thread
+	thread = g_trace_threads;
+	while(thread)
+	{
+		if(thread->exited)
+		{
+			break;
+		}
+		thread = thread->next;
+	}
+
+	if(thread)
+	{
+		if(pthread_setspecific(g_trace_key,
+		                       (const void*) thread) != 0)
+		{
+			pthread_mutex_unlock(&g_trace_mutex);
+			return NULL;
+		}
+
+		thread->tid    = (int) syscall(SYS_gettid);
+		thread->exited = 0;
+		__atomic_store_n(&thread->head, 0, __ATOMIC_RELEASE);
+
+		pthread_mutex_unlock(&g_trace_mutex);
+		return thread;
+	}
+
+	// untracked memory since cc_memory depends on cc_log
+	thread = (cc_traceThread_t*)
+	         calloc(1, sizeof(cc_traceThread_t));
+	if(thread == NULL)
+	{
+		pthread_mutex_unlock(&g_trace_mutex);
+		return NULL;
+	}
+	thread->tid = (int) syscall(SYS_gettid);
+
+	if(pthread_setspecific(g_trace_key, (const void*) thread) != 0)
+	{
+		pthread_mutex_unlock(&g_trace_mutex);
+		free(thread);
+		return NULL;
+	}
+
+	thread->next    = g_trace_threads;
+	g_trace_threads = thread;
+	pthread_mutex_unlock(&g_trace_mutex);
+
+	return thread;
+}
+
+static void
+cc_trace_record(const char* func, int line, int type)
+{
+	cc_traceThread_t* thread = cc_trace_thread();
+	if(thread == NULL)
+	{
+		return;
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	uint32_t head = thread->head;
+	cc_traceEvent_t* e = &thread->events[head & (CC_TRACE_COUNT - 1)];
+	e->ts   = 1000000000ULL*((uint64_t) ts.tv_sec) +
+	          (uint64_t) ts.tv_nsec;
+	e->func = func;
+	e->line = line;
+	e->type = type;
+	__atomic_store_n(&thread->head, head + 1, __ATOMIC_RELEASE);
+
+	if(__atomic_load_n(&g_trace_signal, __ATOMIC_RELAXED) &&
+	   __atomic_exchange_n(&g_trace_signal, 0, __ATOMIC_RELAXED))
+	{
+		cc_trace_export(NULL);
+	}
+}
+
+#endif
+
 void cc_log(const char* func, int line, int type,
             const char* tag, const char* fmt, ...)
 {
@@ -100,6 +299,8 @@ void cc_trace_init(void)
 			g_trace_fd = open("/sys/kernel/debug/tracing/trace_marker",
 			                  O_WRONLY);
 		}
+	#elif defined(CC_TRACE_LINUX)
+		cc_trace_thread();
 	#endif
 }
 
@@ -113,6 +314,8 @@ void cc_trace_begin(const char* func, int line)
 			                   getpid(), func, line);
 			write(g_trace_fd, buf, len);
 		}
+	#elif defined(CC_TRACE_LINUX)
+		cc_trace_record(func, line, CC_TRACE_BEGIN);
 	#endif
 }
 
@@ -124,9 +327,93 @@ void cc_trace_end(void)
 			char c = 'E';
 			write(g_trace_fd, &c, 1);
 		}
+	#elif defined(CC_TRACE_LINUX)
+		cc_trace_record(NULL, 0, CC_TRACE_END);
 	#endif
 }
 
+int cc_trace_export(const char* fname)
+{
+	#ifdef CC_TRACE_LINUX
+		if(fname == NULL)
+		{
+			fname = getenv("CC_TRACE_FILE");
+			if(fname == NULL)
+			{
+				fname = "trace.json";
+			}
+		}
+
+		pthread_mutex_lock(&g_trace_mutex);
+
+		if(g_trace_threads == NULL)
+		{
+			pthread_mutex_unlock(&g_trace_mutex);
+			return 1;
+		}
+
+		FILE* f = fopen(fname, "w");
+		if(f == NULL)
+		{
+			pthread_mutex_unlock(&g_trace_mutex);
+			LOGE("fopen %s failed", fname);
+			return 0;
+		}
+
+		// events of running threads may be overwritten while
+		// exporting so the trace is only exact for threads
+		// which are idle or have exited
+		int      pid   = (int) getpid();
+		int      first = 1;
+		uint32_t head;
+		uint32_t tail;
+		cc_traceEvent_t*  e;
+		cc_traceThread_t* thread = g_trace_threads;
+		fprintf(f, "{\"traceEvents\":[");
+		while(thread)
+		{
+			head = __atomic_load_n(&thread->head, __ATOMIC_ACQUIRE);
+			tail = 0;
+			if(head > CC_TRACE_COUNT)
+			{
+				tail = head - CC_TRACE_COUNT;
+			}
+
+			while(tail != head)
+			{
+				e = &thread->events[tail & (CC_TRACE_COUNT - 1)];
+				if(e->type == CC_TRACE_BEGIN)
+				{
+					fprintf(f, "%s\n{\"name\":\"%s@%i\",\"ph\":\"B\","
+					        "\"ts\":%" PRIu64 ".%03i,"
+					        "\"pid\":%i,\"tid\":%i}",
+					        first ? "" : ",", e->func, e->line,
+					        e->ts/1000, (int) (e->ts%1000),
+					        pid, thread->tid);
+				}
+				else
+				{
+					fprintf(f, "%s\n{\"ph\":\"E\","
+					        "\"ts\":%" PRIu64 ".%03i,"
+					        "\"pid\":%i,\"tid\":%i}",
+					        first ? "" : ",",
+					        e->ts/1000, (int) (e->ts%1000),
+					        pid, thread->tid);
+				}
+				first = 0;
+				++tail;
+			}
+			thread = thread->next;
+		}
+		fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+		fclose(f);
+
+		pthread_mutex_unlock(&g_trace_mutex);
+	#endif
+
+	return 1;
+}
+
 void cc_assert(const char* func, int line,
                const char* tag, const char* expr)
 {
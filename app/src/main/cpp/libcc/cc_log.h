@@ -58,10 +58,12 @@ void cc_log(const char* func, int line, int type,
 void cc_assert(const char* func, int line,
                const char* tag, const char* expr);
 
-// tracing using Android Systrace
+// tracing using Android Systrace or the Linux trace
+// recorder which exports Chrome/Perfetto trace JSON
 void cc_trace_init(void);
 void cc_trace_begin(const char* func, int line);
 void cc_trace_end(void);
+int  cc_trace_export(const char* fname);
 
 #ifndef LOGD
 	#ifdef LOG_DEBUG
@@ -30,12 +30,20 @@
 #include <string.h>
 
 #define LOG_TAG "cc"
+#include "cc_intern.h"
 #include "cc_map.h"
 #include "cc_memory.h"
 #include "cc_mumurhash3.h"
 #include "cc_log.h"
 
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+#endif
+
 #define CC_MAP_FLAG_CMALLOC 1
+#define CC_MAP_FLAG_FLAT    2
 
 #define CC_MAP_KEYLEN 256
 
@@ -43,6 +51,16 @@
 
 #define CC_MAP_IDX(map, hash) (hash/map->elements)
 
+// flat (open addressing) engine
+// control bytes are probed one group at a time and a FULL
+// control byte holds the low 7 bits of the hash (h2)
+#define CC_MAP_GROUP         16
+#define CC_MAP_CTRL_EMPTY    0x80
+#define CC_MAP_CTRL_DELETED  0xFE
+#define CC_MAP_FLAT_KEYLEN   40
+#define CC_MAP_FLAT_H1(hash) ((hash) >> 7)
+#define CC_MAP_FLAT_H2(hash) ((uint8_t) ((hash) & 0x7F))
+
 // protected
 cc_list_t* cc_list_newCMalloc(void);
 
@@ -235,6 +253,405 @@ cc_mapNode_cmp(cc_mapNode_t* self,
 	return 0;
 }
 
+/***********************************************************
+* private - flat engine                                    *
+***********************************************************/
+
+// keys up to CC_MAP_FLAT_KEYLEN are stored inline after
+// the node header while longer keys use a heap node
+// the iter is the first member so the slot may be used
+// interchangeably with the cc_mapIter_t
+typedef struct
+{
+	cc_listIter_t iter;
+	uint64_t      node[(sizeof(cc_mapNode_t) +
+	                    CC_MAP_FLAT_KEYLEN + 7)/8];
+} cc_mapSlot_t;
+
+static cc_mapNode_t* cc_mapSlot_inline(cc_mapSlot_t* self)
+{
+	ASSERT(self);
+
+	return (cc_mapNode_t*) self->node;
+}
+
+static uint32_t
+cc_mapGroup_match(const uint8_t* ctrl, uint8_t c)
+{
+	ASSERT(ctrl);
+
+	#if defined(__SSE2__)
+		__m128i g = _mm_loadu_si128((const __m128i*) ctrl);
+		__m128i m = _mm_cmpeq_epi8(g, _mm_set1_epi8((char) c));
+		return (uint32_t) _mm_movemask_epi8(m);
+	#elif defined(__ARM_NEON) && defined(__aarch64__)
+		static const uint8_t bits[16] =
+		{
+			1, 2, 4, 8, 16, 32, 64, 128,
+			1, 2, 4, 8, 16, 32, 64, 128,
+		};
+		uint8x16_t g = vld1q_u8(ctrl);
+		uint8x16_t m = vandq_u8(vceqq_u8(g, vdupq_n_u8(c)),
+		                        vld1q_u8(bits));
+		return ((uint32_t) vaddv_u8(vget_low_u8(m))) |
+		       (((uint32_t) vaddv_u8(vget_high_u8(m))) << 8);
+	#else
+		uint32_t mask = 0;
+		int      i;
+		for(i = 0; i < CC_MAP_GROUP; ++i)
+		{
+			if(ctrl[i] == c)
+			{
+				mask |= (1 << i);
+			}
+		}
+		return mask;
+	#endif
+}
+
+static uint32_t cc_mapGroup_matchFree(const uint8_t* ctrl)
+{
+	ASSERT(ctrl);
+
+	// EMPTY and DELETED have the high bit set
+	#if defined(__SSE2__)
+		__m128i g = _mm_loadu_si128((const __m128i*) ctrl);
+		return (uint32_t) _mm_movemask_epi8(g);
+	#else
+		return cc_mapGroup_match(ctrl, CC_MAP_CTRL_EMPTY) |
+		       cc_mapGroup_match(ctrl, CC_MAP_CTRL_DELETED);
+	#endif
+}
+
+static cc_mapSlot_t*
+cc_map_flatSlot(const cc_map_t* self, int idx)
+{
+	ASSERT(self);
+
+	return &((cc_mapSlot_t*) self->slots)[idx];
+}
+
+static int
+cc_map_flatFind(const cc_map_t* self, uint32_t hash,
+                int len, const uint8_t* key)
+{
+	ASSERT(self);
+	ASSERT(key);
+
+	uint8_t  h2     = CC_MAP_FLAT_H2(hash);
+	uint32_t groups = self->capacity/CC_MAP_GROUP;
+	uint32_t g      = CC_MAP_FLAT_H1(hash) & (groups - 1);
+
+	// triangular probing visits every group since the
+	// group count is a power of two
+	uint32_t i;
+	for(i = 0; i < groups; ++i)
+	{
+		const uint8_t* ctrl = &self->ctrl[CC_MAP_GROUP*g];
+
+		uint32_t mask = cc_mapGroup_match(ctrl, h2);
+		while(mask)
+		{
+			int idx = CC_MAP_GROUP*g + __builtin_ctz(mask);
+
+			cc_mapNode_t* node;
+			node = (cc_mapNode_t*)
+			       cc_map_flatSlot(self, idx)->iter.data;
+			if((node->hash == hash) && (node->len == len) &&
+			   (memcmp(cc_mapNode_key(node), key, len) == 0))
+			{
+				return idx;
+			}
+
+			mask &= mask - 1;
+		}
+
+		// the key does not exist if the group has an
+		// empty slot
+		if(cc_mapGroup_match(ctrl, CC_MAP_CTRL_EMPTY))
+		{
+			return -1;
+		}
+
+		g = (g + i + 1) & (groups - 1);
+	}
+
+	return -1;
+}
+
+static int
+cc_map_flatFree(const cc_map_t* self, uint32_t hash)
+{
+	ASSERT(self);
+
+	uint32_t groups = self->capacity/CC_MAP_GROUP;
+	uint32_t g      = CC_MAP_FLAT_H1(hash) & (groups - 1);
+
+	uint32_t i;
+	for(i = 0; i < groups; ++i)
+	{
+		const uint8_t* ctrl = &self->ctrl[CC_MAP_GROUP*g];
+
+		uint32_t mask = cc_mapGroup_matchFree(ctrl);
+		if(mask)
+		{
+			return CC_MAP_GROUP*g + __builtin_ctz(mask);
+		}
+
+		g = (g + i + 1) & (groups - 1);
+	}
+
+	// table is full
+	return -1;
+}
+
+static void
+cc_map_flatLink(cc_map_t* self, cc_listIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(iter);
+
+	iter->prev = self->tail;
+	iter->next = NULL;
+	if(self->tail)
+	{
+		self->tail->next = iter;
+	}
+	else
+	{
+		self->head = iter;
+	}
+	self->tail = iter;
+}
+
+static void
+cc_map_flatUnlink(cc_map_t* self, cc_listIter_t* iter)
+{
+	ASSERT(self);
+	ASSERT(iter);
+
+	if(iter->prev)
+	{
+		iter->prev->next = iter->next;
+	}
+	else
+	{
+		self->head = iter->next;
+	}
+
+	if(iter->next)
+	{
+		iter->next->prev = iter->prev;
+	}
+	else
+	{
+		self->tail = iter->prev;
+	}
+
+	iter->next = NULL;
+	iter->prev = NULL;
+}
+
+static int
+cc_map_flatAlloc(cc_map_t* self, int capacity)
+{
+	ASSERT(self);
+
+	uint8_t* ctrl;
+	ctrl = (uint8_t*) MALLOC(capacity*sizeof(uint8_t));
+	if(ctrl == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+
+	cc_mapSlot_t* slots;
+	slots = (cc_mapSlot_t*)
+	        MALLOC(capacity*sizeof(cc_mapSlot_t));
+	if(slots == NULL)
+	{
+		LOGE("MALLOC failed");
+		FREE(ctrl);
+		return 0;
+	}
+
+	memset((void*) ctrl, CC_MAP_CTRL_EMPTY,
+	       capacity*sizeof(uint8_t));
+
+	self->capacity   = capacity;
+	self->tombstones = 0;
+	self->ctrl       = ctrl;
+	self->slots      = (void*) slots;
+	return 1;
+}
+
+static void
+cc_map_flatRehash(cc_map_t* self, int capacity)
+{
+	ASSERT(self);
+
+	uint8_t*       ctrl  = self->ctrl;
+	void*          slots = self->slots;
+	cc_listIter_t* iter  = self->head;
+	if(cc_map_flatAlloc(self, capacity) == 0)
+	{
+		// continue with the existing table
+		return;
+	}
+
+	// reinsert the slots in iteration order
+	self->head = NULL;
+	self->tail = NULL;
+	while(iter)
+	{
+		cc_mapSlot_t* src  = (cc_mapSlot_t*) iter;
+		cc_mapNode_t* node = (cc_mapNode_t*) iter->data;
+		int           idx  = cc_map_flatFree(self, node->hash);
+		cc_mapSlot_t* dst  = cc_map_flatSlot(self, idx);
+
+		self->ctrl[idx] = CC_MAP_FLAT_H2(node->hash);
+		if(node == cc_mapSlot_inline(src))
+		{
+			memcpy((void*) dst->node, (const void*) src->node,
+			       sizeof(cc_mapNode_t) + node->len);
+			dst->iter.data = (const void*) dst->node;
+		}
+		else
+		{
+			dst->iter.data = (const void*) node;
+		}
+
+		iter = iter->next;
+		cc_map_flatLink(self, &dst->iter);
+	}
+
+	FREE(slots);
+	FREE(ctrl);
+}
+
+static cc_mapIter_t*
+cc_map_flatAdd(cc_map_t* self, uint32_t hash,
+               const void* val, int len, const uint8_t* key)
+{
+	ASSERT(self);
+	ASSERT(val);
+	ASSERT(key);
+
+	if(cc_map_flatFind(self, hash, len, key) >= 0)
+	{
+		return NULL;
+	}
+
+	// maintain a maximum load factor of 7/8 and grow when
+	// the table is more than 7/16 full after the rehash
+	int used = self->count + self->tombstones + 1;
+	if(8*used > 7*self->capacity)
+	{
+		int capacity = self->capacity;
+		if(16*(self->count + 1) > 7*capacity)
+		{
+			capacity *= 2;
+		}
+		cc_map_flatRehash(self, capacity);
+	}
+
+	// the table may be full if the rehash failed
+	int idx = cc_map_flatFree(self, hash);
+	if(idx < 0)
+	{
+		return NULL;
+	}
+
+	cc_mapSlot_t* slot = cc_map_flatSlot(self, idx);
+
+	cc_mapNode_t* node;
+	if(len <= CC_MAP_FLAT_KEYLEN)
+	{
+		node       = cc_mapSlot_inline(slot);
+		node->val  = val;
+		node->hash = hash;
+		node->len  = len;
+		memcpy((void*) cc_mapNode_key(node),
+		       (const void*) key, len);
+	}
+	else
+	{
+		node = cc_mapNode_new(self, val, hash, 0, len, key);
+		if(node == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	if(self->ctrl[idx] == CC_MAP_CTRL_DELETED)
+	{
+		--self->tombstones;
+	}
+	self->ctrl[idx] = CC_MAP_FLAT_H2(hash);
+	++self->count;
+
+	slot->iter.data = (const void*) node;
+	cc_map_flatLink(self, &slot->iter);
+
+	return &slot->iter;
+}
+
+static const void*
+cc_map_flatRemove(cc_map_t* self, cc_mapIter_t** _miter)
+{
+	ASSERT(self);
+	ASSERT(_miter);
+	ASSERT(*_miter);
+
+	cc_mapIter_t* miter = *_miter;
+	cc_mapIter_t* next  = miter->next;
+	cc_mapSlot_t* slot  = (cc_mapSlot_t*) miter;
+	cc_mapNode_t* node  = (cc_mapNode_t*) miter->data;
+	const void*   val   = node->val;
+
+	int idx = (int) (slot - (cc_mapSlot_t*) self->slots);
+
+	cc_map_flatUnlink(self, miter);
+	if(node != cc_mapSlot_inline(slot))
+	{
+		cc_mapNode_delete(&node, self);
+	}
+	miter->data = NULL;
+
+	// a probe sequence never passed through a group which
+	// has an empty slot so the slot may be emptied
+	int      g    = idx/CC_MAP_GROUP;
+	uint8_t* ctrl = &self->ctrl[CC_MAP_GROUP*g];
+	if(cc_mapGroup_match(ctrl, CC_MAP_CTRL_EMPTY))
+	{
+		self->ctrl[idx] = CC_MAP_CTRL_EMPTY;
+	}
+	else
+	{
+		self->ctrl[idx] = CC_MAP_CTRL_DELETED;
+		++self->tombstones;
+	}
+	--self->count;
+
+	*_miter = next;
+	return val;
+}
+
+static void cc_map_flatDiscard(cc_map_t* self)
+{
+	ASSERT(self);
+
+	cc_mapIter_t* miter = self->head;
+	while(miter)
+	{
+		cc_map_flatRemove(self, &miter);
+	}
+
+	memset((void*) self->ctrl, CC_MAP_CTRL_EMPTY,
+	       self->capacity*sizeof(uint8_t));
+	self->tombstones = 0;
+}
+
 /***********************************************************
 * private                                                  *
 ***********************************************************/
@@ -259,6 +676,18 @@ static cc_map_t* cc_map_newFlags(int flags)
 
 	self->flags    = flags;
 	self->seed     = random();
+
+	if(flags & CC_MAP_FLAG_FLAT)
+	{
+		if(cc_map_flatAlloc(self, CC_MAP_GROUP) == 0)
+		{
+			FREE(self);
+			return NULL;
+		}
+
+		return self;
+	}
+
 	self->capacity = CC_MAP_CAPACITY;
 	self->elements = (uint32_t)
 	                 (((uint64_t) UINT_MAX + 1)/
@@ -476,6 +905,117 @@ cc_map_addAt(cc_map_t* self, cc_mapIter_t* miter_at,
 	return NULL;
 }
 
+static cc_mapIter_t*
+cc_map_findHash(const cc_map_t* self, uint32_t hash,
+                int len, const uint8_t* key8)
+{
+	ASSERT(self);
+	ASSERT(key8);
+
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		int fidx = cc_map_flatFind(self, hash, len, key8);
+		if(fidx < 0)
+		{
+			return NULL;
+		}
+		return &cc_map_flatSlot(self, fidx)->iter;
+	}
+
+	int idx = CC_MAP_IDX(self, hash);
+
+	cc_mapIter_t* miter = self->buckets[idx];
+	while(miter)
+	{
+		cc_mapNode_t* node;
+		node = (cc_mapNode_t*)
+		       cc_list_peekIter(miter);
+		if(CC_MAP_IDX(self, node->hash) != idx)
+		{
+			return NULL;
+		}
+
+		int cmp = cc_mapNode_cmp(node, hash, len, key8);
+		if(cmp == 0)
+		{
+			return miter;
+		}
+		else if(cmp > 0)
+		{
+			return NULL;
+		}
+
+		miter = cc_list_next(miter);
+	}
+
+	return NULL;
+}
+
+static cc_mapIter_t*
+cc_map_addHash(cc_map_t* self, uint32_t hash,
+               const void* val, int len, const uint8_t* key8)
+{
+	ASSERT(self);
+	ASSERT(val);
+	ASSERT(key8);
+
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		return cc_map_flatAdd(self, hash, val, len, key8);
+	}
+
+	int idx = CC_MAP_IDX(self, hash);
+
+	// add node to existing bucket
+	cc_mapIter_t* miter = self->buckets[idx];
+	if(miter)
+	{
+		while(miter)
+		{
+			cc_mapNode_t* node;
+			node = (cc_mapNode_t*) cc_list_peekIter(miter);
+			if(CC_MAP_IDX(self, node->hash) != idx)
+			{
+				return cc_map_addAt(self, miter, hash, idx,
+				                    val, len, key8);
+			}
+
+			int cmp = cc_mapNode_cmp(node, hash, len, key8);
+			if(cmp == 0)
+			{
+				return NULL;
+			}
+			else if(cmp > 0)
+			{
+				return cc_map_addAt(self, miter, hash, idx,
+				                    val, len, key8);
+			}
+
+			miter = cc_list_next(miter);
+		}
+
+		return cc_map_addAt(self, miter, hash, idx,
+		                    val, len, key8);
+	}
+
+	// add node to an empty bucket
+	// find insert position from next used bucket
+	int i;
+	for(i = idx + 1; i < self->capacity; ++i)
+	{
+		miter = self->buckets[i];
+		if(miter)
+		{
+			return cc_map_addAt(self, miter, hash, idx,
+			                    val, len, key8);
+		}
+	}
+
+	miter = NULL;
+	return cc_map_addAt(self, miter, hash, idx,
+	                    val, len, key8);
+}
+
 /***********************************************************
 * protected                                                *
 ***********************************************************/
@@ -497,6 +1037,11 @@ cc_map_t* cc_map_new(void)
 	return cc_map_newFlags(0);
 }
 
+cc_map_t* cc_map_newFlat(void)
+{
+	return cc_map_newFlags(CC_MAP_FLAG_FLAT);
+}
+
 void cc_map_delete(cc_map_t** _self)
 {
 	ASSERT(_self);
@@ -504,6 +1049,22 @@ void cc_map_delete(cc_map_t** _self)
 	cc_map_t* self = *_self;
 	if(self)
 	{
+		if(self->flags & CC_MAP_FLAG_FLAT)
+		{
+			if(self->count > 0)
+			{
+				LOGE("memory leak detected: size=%i",
+				     self->count);
+				cc_map_flatDiscard(self);
+			}
+
+			FREE(self->slots);
+			FREE(self->ctrl);
+			FREE(self);
+			*_self = NULL;
+			return;
+		}
+
 		cc_list_delete(&self->nodes);
 		if(self->flags & CC_MAP_FLAG_CMALLOC)
 		{
@@ -523,6 +1084,12 @@ void cc_map_discard(cc_map_t* self)
 {
 	ASSERT(self);
 
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		cc_map_flatDiscard(self);
+		return;
+	}
+
 	size_t size = self->capacity*sizeof(cc_listIter_t*);
 	memset((void*) self->buckets, 0, size);
 
@@ -540,6 +1107,11 @@ int cc_map_size(const cc_map_t* self)
 {
 	ASSERT(self);
 
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		return self->count;
+	}
+
 	return cc_list_size(self->nodes);
 }
 
@@ -549,6 +1121,15 @@ size_t cc_map_sizeof(const cc_map_t* self)
 
 	// sizeof map + nodes + buckets + list
 	size_t size = sizeof(cc_map_t);
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		// sizeof map + heap nodes + ctrl + slots
+		size += self->nodes_size;
+		size += self->capacity*(sizeof(uint8_t) +
+		                        sizeof(cc_mapSlot_t));
+		return size;
+	}
+
 	size += self->nodes_size;
 	size += self->capacity*sizeof(cc_listIter_t*);
 	size += cc_list_sizeof(self->nodes);
@@ -560,6 +1141,11 @@ cc_map_head(const cc_map_t* self)
 {
 	ASSERT(self);
 
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		return self->head;
+	}
+
 	return cc_list_head(self->nodes);
 }
 
@@ -622,33 +1208,7 @@ cc_map_findp(const cc_map_t* self, int len, const void* key)
 
 	uint32_t seed = self->seed;
 	uint32_t hash = cc_mumurhash3(seed, len, key8);
-	int      idx  = CC_MAP_IDX(self, hash);
-
-	cc_mapIter_t* miter = self->buckets[idx];
-	while(miter)
-	{
-		cc_mapNode_t* node;
-		node = (cc_mapNode_t*)
-		       cc_list_peekIter(miter);
-		if(CC_MAP_IDX(self, node->hash) != idx)
-		{
-			return NULL;
-		}
-
-		int cmp = cc_mapNode_cmp(node, hash, len, key8);
-		if(cmp == 0)
-		{
-			return miter;
-		}
-		else if(cmp > 0)
-		{
-			return NULL;
-		}
-
-		miter = cc_list_next(miter);
-	}
-
-	return NULL;
+	return cc_map_findHash(self, hash, len, key8);
 }
 
 cc_mapIter_t*
@@ -677,6 +1237,19 @@ cc_map_findf(const cc_map_t* self, const char* fmt, ...)
 	return cc_map_findp(self, len, (const void*) key);
 }
 
+cc_mapIter_t*
+cc_map_findi(const cc_map_t* self, const char* istr)
+{
+	ASSERT(self);
+	ASSERT(istr);
+
+	// the interned pointer is the key and the hash is
+	// cached by the intern table
+	return cc_map_findHash(self, cc_intern_hash(istr),
+	                       sizeof(const char*),
+	                       (const uint8_t*) &istr);
+}
+
 cc_mapIter_t*
 cc_map_addp(cc_map_t* self, const void* val,
             int len, const void* key)
@@ -708,56 +1281,7 @@ cc_map_addp(cc_map_t* self, const void* val,
 
 	uint32_t seed = self->seed;
 	uint32_t hash = cc_mumurhash3(seed, len, key8);
-	int      idx  = CC_MAP_IDX(self, hash);
-
-	// add node to existing bucket
-	cc_mapIter_t* miter = self->buckets[idx];
-	if(miter)
-	{
-		while(miter)
-		{
-			cc_mapNode_t* node;
-			node = (cc_mapNode_t*) cc_list_peekIter(miter);
-			if(CC_MAP_IDX(self, node->hash) != idx)
-			{
-				return cc_map_addAt(self, miter, hash, idx,
-				                    val, len, key8);
-			}
-
-			int cmp = cc_mapNode_cmp(node, hash, len, key8);
-			if(cmp == 0)
-			{
-				return NULL;
-			}
-			else if(cmp > 0)
-			{
-				return cc_map_addAt(self, miter, hash, idx,
-				                    val, len, key8);
-			}
-
-			miter = cc_list_next(miter);
-		}
-
-		return cc_map_addAt(self, miter, hash, idx,
-		                    val, len, key8);
-	}
-
-	// add node to an empty bucket
-	// find insert position from next used bucket
-	int i;
-	for(i = idx + 1; i < self->capacity; ++i)
-	{
-		miter = self->buckets[i];
-		if(miter)
-		{
-			return cc_map_addAt(self, miter, hash, idx,
-			                    val, len, key8);
-		}
-	}
-
-	miter = NULL;
-	return cc_map_addAt(self, miter, hash, idx,
-	                    val, len, key8);
+	return cc_map_addHash(self, hash, val, len, key8);
 }
 
 cc_mapIter_t*
@@ -790,6 +1314,19 @@ cc_map_addf(cc_map_t* self,
 	return cc_map_addp(self, val, len, (const void*) key);
 }
 
+cc_mapIter_t*
+cc_map_addi(cc_map_t* self,
+            const void* val, const char* istr)
+{
+	ASSERT(self);
+	ASSERT(val);
+	ASSERT(istr);
+
+	return cc_map_addHash(self, cc_intern_hash(istr), val,
+	                      sizeof(const char*),
+	                      (const uint8_t*) &istr);
+}
+
 const void*
 cc_map_remove(cc_map_t* self, cc_mapIter_t** _miter)
 {
@@ -797,6 +1334,11 @@ cc_map_remove(cc_map_t* self, cc_mapIter_t** _miter)
 	ASSERT(_miter);
 	ASSERT(*_miter);
 
+	if(self->flags & CC_MAP_FLAG_FLAT)
+	{
+		return cc_map_flatRemove(self, _miter);
+	}
+
 	cc_mapIter_t* miter;
 	cc_mapNode_t* node;
 	const void*   val;
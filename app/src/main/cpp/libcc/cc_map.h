@@ -43,9 +43,28 @@ typedef struct
 	// nodes
 	size_t     nodes_size;
 	cc_list_t* nodes;
+
+	// flat (open addressing) engine
+	// slots are linked in insertion order for iteration
+	int            count;
+	int            tombstones;
+	uint8_t*       ctrl;
+	void*          slots;
+	cc_listIter_t* head;
+	cc_listIter_t* tail;
 } cc_map_t;
 
+// the findi/addi functions are keyed by strings which were
+// interned by cc_intern so lookups compare the interned
+// pointer and entries added with cc_map_addi may only be
+// found with cc_map_findi
+//
+// the flat map stores keys inline in an open addressing
+// table which is faster for lookups but cc_map_add*
+// may invalidate existing iterators (cc_map_remove does
+// not invalidate other iterators)
 cc_map_t*     cc_map_new(void);
+cc_map_t*     cc_map_newFlat(void);
 void          cc_map_delete(cc_map_t** _self);
 void          cc_map_discard(cc_map_t* self);
 int           cc_map_size(const cc_map_t* self);
@@ -62,6 +81,8 @@ cc_mapIter_t* cc_map_find(const cc_map_t* self,
                          const char* key);
 cc_mapIter_t* cc_map_findf(const cc_map_t* self,
                            const char* fmt, ...);
+cc_mapIter_t* cc_map_findi(const cc_map_t* self,
+                           const char* istr);
 cc_mapIter_t* cc_map_addp(cc_map_t* self,
                           const void* val,
                           int len,
@@ -72,6 +93,9 @@ cc_mapIter_t* cc_map_add(cc_map_t* self,
 cc_mapIter_t* cc_map_addf(cc_map_t* self,
                           const void* val,
                           const char* fmt, ...);
+cc_mapIter_t* cc_map_addi(cc_map_t* self,
+                          const void* val,
+                          const char* istr);
 const void*   cc_map_remove(cc_map_t* self,
                             cc_mapIter_t** _miter);
 
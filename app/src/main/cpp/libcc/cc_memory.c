@@ -23,6 +23,7 @@
 
 #include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
 #define LOG_TAG "cc"
@@ -38,14 +39,335 @@ typedef struct
 	size_t size;
 } cc_memory_t;
 
+// MEMORY_SAMPLE replaces the MEMORY_DEBUG allocation tracking
+// with a sampling heap profiler where MEMORY_SAMPLE may
+// optionally specify the mean sampling period in bytes
+// sampled allocations are flagged in the cc_memory_t size
+#if defined(MEMORY_DEBUG) && defined(MEMORY_SAMPLE)
+	#define CC_MEMORY_SAMPLING
+	#define CC_MEMORY_SAMPLED ((size_t) 1 << (8*sizeof(size_t) - 1))
+	#if MEMORY_SAMPLE > 1
+		#define CC_MEMORY_SAMPLE_PERIOD MEMORY_SAMPLE
+	#else
+		#define CC_MEMORY_SAMPLE_PERIOD 524288
+	#endif
+	#define CC_MEMORY_SAMPLE_COUNT 256
+#else
+	#define CC_MEMORY_SAMPLED ((size_t) 0)
+#endif
+
 pthread_mutex_t memory_mutex = PTHREAD_MUTEX_INITIALIZER;
 size_t          memory_count = 0;
 size_t          memory_size  = 0;
 
+/***********************************************************
+* private - cc_memoryThread                                *
+***********************************************************/
+
+// small allocations are rounded up to a size class and
+// recycled through a per-thread cache so that MALLOC/FREE
+// do not need to take a global lock
+#define CC_MEMORY_CLASS_SIZE  16
+#define CC_MEMORY_CLASS_COUNT 32
+#define CC_MEMORY_CLASS_MAX   (CC_MEMORY_CLASS_SIZE*CC_MEMORY_CLASS_COUNT)
+#define CC_MEMORY_CACHE_DEPTH 32
+
+typedef struct cc_memoryBlock_s
+{
+	struct cc_memoryBlock_s* next;
+} cc_memoryBlock_t;
+
+#ifdef CC_MEMORY_SAMPLING
+// sampled alloc/free event where seq orders the events
+// recorded by different threads and carry flags a free
+// which was carried over from a previous drain
+typedef struct
+{
+	uint64_t    seq;
+	void*       ptr;
+	const char* func;
+	int         line;
+	int         carry;
+	size_t      size;
+} cc_memorySample_t;
+#endif
+
+typedef struct cc_memoryThread_s
+{
+	// counters are written by the owning thread and are
+	// aggregated lazily by cc_memcount/cc_memsize/cc_meminfo
+	// note that counters may become negative when memory
+	// is freed by a different thread than allocated it
+	int64_t count;
+	int64_t size;
+
+	// size class cache
+	int               cache_count[CC_MEMORY_CLASS_COUNT];
+	cc_memoryBlock_t* cache[CC_MEMORY_CLASS_COUNT];
+
+	#ifdef CC_MEMORY_SAMPLING
+	// sampled events are written by the owning thread to a
+	// ring buffer which is drained with memory_mutex locked
+	int64_t           sample_bytes;
+	uint64_t          sample_rng;
+	uint32_t          sample_head;
+	uint32_t          sample_tail;
+	uint32_t          sample_snap;
+	cc_memorySample_t samples[CC_MEMORY_SAMPLE_COUNT];
+	#endif
+
+	// list of registered threads
+	struct cc_memoryThread_s* prev;
+	struct cc_memoryThread_s* next;
+} cc_memoryThread_t;
+
+static pthread_once_t     memory_once    = PTHREAD_ONCE_INIT;
+static pthread_key_t      memory_key;
+static int                memory_key_ok  = 0;
+static cc_memoryThread_t* memory_threads = NULL;
+
+// counters for exited threads
+static int64_t memory_retired_count = 0;
+static int64_t memory_retired_size  = 0;
+
+static size_t cc_memory_class(size_t size)
+{
+	// class 0 holds sizes 1-16, class 1 holds 17-32, etc.
+	ASSERT(size && (size <= CC_MEMORY_CLASS_MAX));
+
+	return (size - 1)/CC_MEMORY_CLASS_SIZE;
+}
+
+static size_t cc_memory_capacity(size_t size)
+{
+	// blocks in the size class range are always allocated
+	// with the full class capacity so they may be recycled
+	if((size == 0) || (size > CC_MEMORY_CLASS_MAX))
+	{
+		return size;
+	}
+
+	return CC_MEMORY_CLASS_SIZE*(cc_memory_class(size) + 1);
+}
+
+static size_t cc_memory_size(cc_memory_t* mem)
+{
+	ASSERT(mem);
+
+	return mem->size & ~CC_MEMORY_SAMPLED;
+}
+
+#ifdef CC_MEMORY_SAMPLING
+static void cc_memory_sampleDrainLocked(void);
+#endif
+
+static void cc_memoryThread_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	cc_memoryThread_t* self = (cc_memoryThread_t*) arg;
+
+	// free the cache
+	int i;
+	cc_memoryBlock_t* block;
+	for(i = 0; i < CC_MEMORY_CLASS_COUNT; ++i)
+	{
+		block = self->cache[i];
+		while(block)
+		{
+			self->cache[i] = block->next;
+			free(((void*) block) - sizeof(cc_memory_t));
+			block = self->cache[i];
+		}
+	}
+
+	// retire the counters and unregister the thread
+	pthread_mutex_lock(&memory_mutex);
+	#ifdef CC_MEMORY_SAMPLING
+	cc_memory_sampleDrainLocked();
+	#endif
+	memory_retired_count += self->count;
+	memory_retired_size  += self->size;
+	if(self->prev)
+	{
+		self->prev->next = self->next;
+	}
+	else
+	{
+		memory_threads = self->next;
+	}
+	if(self->next)
+	{
+		self->next->prev = self->prev;
+	}
+	pthread_mutex_unlock(&memory_mutex);
+
+	free(self);
+}
+
+static void cc_memoryThread_once(void)
+{
+	if(pthread_key_create(&memory_key,
+	                      cc_memoryThread_destruct) == 0)
+	{
+		memory_key_ok = 1;
+	}
+}
+
+static cc_memoryThread_t* cc_memoryThread_get(void)
+{
+	pthread_once(&memory_once, cc_memoryThread_once);
+	if(memory_key_ok == 0)
+	{
+		return NULL;
+	}
+
+	cc_memoryThread_t* self;
+	self = (cc_memoryThread_t*)
+	       pthread_getspecific(memory_key);
+	if(self)
+	{
+		return self;
+	}
+
+	// the thread state must not use the tracked allocator
+	self = (cc_memoryThread_t*)
+	       calloc(1, sizeof(cc_memoryThread_t));
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	if(pthread_setspecific(memory_key, (const void*) self) != 0)
+	{
+		free(self);
+		return NULL;
+	}
+
+	// register the thread
+	pthread_mutex_lock(&memory_mutex);
+	self->next = memory_threads;
+	if(memory_threads)
+	{
+		memory_threads->prev = self;
+	}
+	memory_threads = self;
+	pthread_mutex_unlock(&memory_mutex);
+
+	return self;
+}
+
+static void
+cc_memoryThread_update(cc_memoryThread_t* self,
+                       int64_t count, int64_t size)
+{
+	// self may be NULL
+
+	if(self)
+	{
+		// only the owning thread writes the counters
+		// so the atomics are only needed for readers
+		__atomic_store_n(&self->count, self->count + count,
+		                 __ATOMIC_RELAXED);
+		__atomic_store_n(&self->size, self->size + size,
+		                 __ATOMIC_RELAXED);
+	}
+	else
+	{
+		// fallback when the thread state is unavailable
+		pthread_mutex_lock(&memory_mutex);
+		memory_count += count;
+		memory_size  += size;
+		pthread_mutex_unlock(&memory_mutex);
+	}
+}
+
+static cc_memory_t*
+cc_memoryThread_alloc(cc_memoryThread_t* self, size_t size)
+{
+	// self may be NULL
+
+	if((self == NULL) || (size == 0) ||
+	   (size > CC_MEMORY_CLASS_MAX))
+	{
+		return NULL;
+	}
+
+	size_t            idx   = cc_memory_class(size);
+	cc_memoryBlock_t* block = self->cache[idx];
+	if(block == NULL)
+	{
+		return NULL;
+	}
+
+	self->cache[idx] = block->next;
+	--self->cache_count[idx];
+
+	return (cc_memory_t*) (((void*) block) -
+	                       sizeof(cc_memory_t));
+}
+
+static int
+cc_memoryThread_free(cc_memoryThread_t* self,
+                     cc_memory_t* mem)
+{
+	// self may be NULL
+	ASSERT(mem);
+
+	size_t size = cc_memory_size(mem);
+	if((self == NULL) || (size == 0) ||
+	   (size > CC_MEMORY_CLASS_MAX))
+	{
+		return 0;
+	}
+
+	size_t idx = cc_memory_class(size);
+	if(self->cache_count[idx] >= CC_MEMORY_CACHE_DEPTH)
+	{
+		return 0;
+	}
+
+	cc_memoryBlock_t* block;
+	block = (cc_memoryBlock_t*)
+	        (((void*) mem) + sizeof(cc_memory_t));
+	block->next      = self->cache[idx];
+	self->cache[idx] = block;
+	++self->cache_count[idx];
+
+	return 1;
+}
+
+static void cc_memory_totals(size_t* _count, size_t* _size)
+{
+	ASSERT(_count);
+	ASSERT(_size);
+
+	pthread_mutex_lock(&memory_mutex);
+
+	int64_t count = memory_retired_count +
+	                (int64_t) memory_count;
+	int64_t size  = memory_retired_size +
+	                (int64_t) memory_size;
+
+	cc_memoryThread_t* thread = memory_threads;
+	while(thread)
+	{
+		count += __atomic_load_n(&thread->count,
+		                         __ATOMIC_RELAXED);
+		size  += __atomic_load_n(&thread->size,
+		                         __ATOMIC_RELAXED);
+		thread = thread->next;
+	}
+
+	pthread_mutex_unlock(&memory_mutex);
+
+	*_count = (size_t) count;
+	*_size  = (size_t) size;
+}
+
 #ifdef MEMORY_DEBUG
 
 #include <stdio.h>
-#include <string.h>
 #include "cc_map.h"
 
 /***********************************************************
@@ -82,6 +404,346 @@ typedef struct
 
 cc_meminfo_t* memory_meminfo = NULL;
 
+#ifdef CC_MEMORY_SAMPLING
+
+/***********************************************************
+* private - cc_memorySample                                *
+***********************************************************/
+
+#include <math.h>
+
+// estimated allocations per call site
+typedef struct
+{
+	const char* func;
+	int         line;
+	double      count;
+	double      size;
+} cc_memorySite_t;
+
+// maps from ptr to the live sampled allocation
+static cc_map_t* memory_sample_map = NULL;
+static uint64_t  memory_sample_seq = 0;
+
+// unmatched free events carried over to the next drain
+static int                memory_sample_carry_count = 0;
+static cc_memorySample_t* memory_sample_carry       = NULL;
+
+static int64_t cc_memory_sampleNext(cc_memoryThread_t* thread)
+{
+	ASSERT(thread);
+
+	// xorshift64*
+	uint64_t x = thread->sample_rng;
+	if(x == 0)
+	{
+		x = ((uint64_t) (uintptr_t) thread) ^
+		    0x9E3779B97F4A7C15ULL;
+	}
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	thread->sample_rng = x;
+
+	// the distance between samples is exponentially
+	// distributed so allocations are sampled as a Poisson
+	// process over the bytes allocated
+	double u = ((double) ((x*0x2545F4914F6CDD1DULL) >> 11))/
+	           9007199254740992.0;
+	double d = -log(1.0 - u)*CC_MEMORY_SAMPLE_PERIOD;
+	return (d < 1.0) ? 1 : (int64_t) d;
+}
+
+static void
+cc_memory_sampleRecord(cc_memoryThread_t* thread,
+                       const char* func, int line,
+                       void* ptr, size_t size)
+{
+	ASSERT(thread);
+	ASSERT(func);
+	ASSERT(ptr);
+
+	uint32_t head = thread->sample_head;
+	uint32_t tail = __atomic_load_n(&thread->sample_tail,
+	                                __ATOMIC_ACQUIRE);
+	if(head - tail >= CC_MEMORY_SAMPLE_COUNT)
+	{
+		pthread_mutex_lock(&memory_mutex);
+		cc_memory_sampleDrainLocked();
+		pthread_mutex_unlock(&memory_mutex);
+	}
+
+	// a size of zero records a free event
+	cc_memorySample_t* sample;
+	sample = &thread->samples[head%CC_MEMORY_SAMPLE_COUNT];
+	sample->seq   = __atomic_fetch_add(&memory_sample_seq, 1,
+	                                   __ATOMIC_RELAXED);
+	sample->ptr   = ptr;
+	sample->func  = func;
+	sample->line  = line;
+	sample->carry = 0;
+	sample->size  = size;
+	__atomic_store_n(&thread->sample_head, head + 1,
+	                 __ATOMIC_RELEASE);
+}
+
+static int cc_memory_sampleCompare(const void* a, const void* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	const cc_memorySample_t* sa = (const cc_memorySample_t*) a;
+	const cc_memorySample_t* sb = (const cc_memorySample_t*) b;
+	if(sa->seq < sb->seq)
+	{
+		return -1;
+	}
+	return (sa->seq > sb->seq) ? 1 : 0;
+}
+
+// returns 0 for a free event without a live allocation
+static int cc_memory_sampleApply(cc_memorySample_t* sample)
+{
+	ASSERT(sample);
+
+	cc_memorySample_t* live;
+	cc_mapIter_t*      miter;
+	miter = cc_map_findp(memory_sample_map, 0, sample->ptr);
+	if(miter)
+	{
+		// ignore a stale event which was drained after a
+		// later alloc for a reused ptr
+		live = (cc_memorySample_t*) cc_map_val(miter);
+		if(live->seq > sample->seq)
+		{
+			return 1;
+		}
+
+		cc_map_remove(memory_sample_map, &miter);
+		free(live);
+	}
+	else if(sample->size == 0)
+	{
+		return 0;
+	}
+
+	if(sample->size == 0)
+	{
+		return 1;
+	}
+
+	live = (cc_memorySample_t*)
+	       malloc(sizeof(cc_memorySample_t));
+	if(live == NULL)
+	{
+		LOGE("malloc failed");
+		return 1;
+	}
+	*live = *sample;
+
+	if(cc_map_addp(memory_sample_map, (const void*) live,
+	               0, live->ptr) == NULL)
+	{
+		free(live);
+	}
+
+	return 1;
+}
+
+static void cc_memory_sampleDrainLocked(void)
+{
+	if(memory_sample_map == NULL)
+	{
+		memory_sample_map = cc_map_newCMalloc();
+		if(memory_sample_map == NULL)
+		{
+			return;
+		}
+	}
+
+	// the ring heads are snapshot one thread at a time so a
+	// free recorded by one thread may be drained before the
+	// alloc of the same ptr recorded by another thread
+	// however the alloc was published before the free was
+	// recorded so an unmatched free is carried over once and
+	// is merged by seq with the alloc on the next drain
+	uint32_t           head;
+	int                count  = memory_sample_carry_count;
+	cc_memoryThread_t* thread = memory_threads;
+	while(thread)
+	{
+		head = __atomic_load_n(&thread->sample_head,
+		                       __ATOMIC_ACQUIRE);
+		thread->sample_snap = head;
+		count += (int) (head - thread->sample_tail);
+		thread = thread->next;
+	}
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	cc_memorySample_t* samples;
+	samples = (cc_memorySample_t*)
+	          malloc(count*sizeof(cc_memorySample_t));
+	if(samples == NULL)
+	{
+		LOGE("malloc failed");
+		return;
+	}
+
+	int i;
+	int n = 0;
+	for(i = 0; i < memory_sample_carry_count; ++i)
+	{
+		samples[n++] = memory_sample_carry[i];
+	}
+	free(memory_sample_carry);
+	memory_sample_carry       = NULL;
+	memory_sample_carry_count = 0;
+
+	uint32_t tail;
+	thread = memory_threads;
+	while(thread)
+	{
+		tail = thread->sample_tail;
+		while(tail != thread->sample_snap)
+		{
+			samples[n++] =
+				thread->samples[tail%CC_MEMORY_SAMPLE_COUNT];
+			++tail;
+		}
+		__atomic_store_n(&thread->sample_tail, tail,
+		                 __ATOMIC_RELEASE);
+		thread = thread->next;
+	}
+
+	qsort(samples, n, sizeof(cc_memorySample_t),
+	      cc_memory_sampleCompare);
+
+	// compact the unmatched frees to the front of samples
+	// and discard those which were already carried over
+	int carry = 0;
+	for(i = 0; i < n; ++i)
+	{
+		if((cc_memory_sampleApply(&samples[i]) == 0) &&
+		   (samples[i].carry == 0))
+		{
+			samples[carry]       = samples[i];
+			samples[carry].carry = 1;
+			++carry;
+		}
+	}
+
+	if(carry)
+	{
+		memory_sample_carry       = samples;
+		memory_sample_carry_count = carry;
+	}
+	else
+	{
+		free(samples);
+	}
+}
+
+static int cc_memory_siteCompare(const void* a, const void* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	const cc_memorySample_t* sa;
+	const cc_memorySample_t* sb;
+	sa = *((const cc_memorySample_t**) a);
+	sb = *((const cc_memorySample_t**) b);
+	if(sa->func != sb->func)
+	{
+		return (sa->func < sb->func) ? -1 : 1;
+	}
+	return sa->line - sb->line;
+}
+
+static cc_memorySite_t*
+cc_memory_sampleSitesLocked(int* _count)
+{
+	ASSERT(_count);
+
+	*_count = 0;
+
+	cc_memory_sampleDrainLocked();
+	if(memory_sample_map == NULL)
+	{
+		return NULL;
+	}
+
+	int count = cc_map_size(memory_sample_map);
+	if(count == 0)
+	{
+		return NULL;
+	}
+
+	// sort the live samples by call site
+	cc_memorySample_t** samples;
+	samples = (cc_memorySample_t**)
+	          malloc(count*sizeof(cc_memorySample_t*));
+	if(samples == NULL)
+	{
+		LOGE("malloc failed");
+		return NULL;
+	}
+
+	int i = 0;
+	cc_mapIter_t* miter = cc_map_head(memory_sample_map);
+	while(miter)
+	{
+		samples[i++] = (cc_memorySample_t*) cc_map_val(miter);
+		miter = cc_map_next(miter);
+	}
+	qsort(samples, count, sizeof(cc_memorySample_t*),
+	      cc_memory_siteCompare);
+
+	cc_memorySite_t* sites;
+	sites = (cc_memorySite_t*)
+	        calloc(count, sizeof(cc_memorySite_t));
+	if(sites == NULL)
+	{
+		LOGE("calloc failed");
+		free(samples);
+		return NULL;
+	}
+
+	// an allocation of size s is sampled with probability
+	// 1 - exp(-s/period) so each sample is weighted by the
+	// inverse probability
+	int    n = 0;
+	double p;
+	double size;
+	cc_memorySite_t* site = NULL;
+	for(i = 0; i < count; ++i)
+	{
+		if((site == NULL) ||
+		   (site->func != samples[i]->func) ||
+		   (site->line != samples[i]->line))
+		{
+			site       = &sites[n++];
+			site->func = samples[i]->func;
+			site->line = samples[i]->line;
+		}
+
+		size = (double) samples[i]->size;
+		p    = 1.0 - exp(-size/CC_MEMORY_SAMPLE_PERIOD);
+		site->count += 1.0/p;
+		site->size  += size/p;
+	}
+
+	free(samples);
+
+	*_count = n;
+	return sites;
+}
+
+#endif
+
 /***********************************************************
 * private - cc_ator                                        *
 ***********************************************************/
@@ -390,6 +1052,31 @@ cc_memory_add(const char* func, int line, void* ptr,
 		return;
 	}
 
+	#ifdef CC_MEMORY_SAMPLING
+	cc_memoryThread_t* thread = cc_memoryThread_get();
+	if((thread == NULL) || (size == 0))
+	{
+		return;
+	}
+
+	if(thread->sample_bytes == 0)
+	{
+		thread->sample_bytes = cc_memory_sampleNext(thread);
+	}
+
+	thread->sample_bytes -= (int64_t) size;
+	if(thread->sample_bytes > 0)
+	{
+		return;
+	}
+	thread->sample_bytes = cc_memory_sampleNext(thread);
+
+	cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+	mem->size |= CC_MEMORY_SAMPLED;
+	cc_memory_sampleRecord(thread, func, line, ptr, size);
+	return;
+	#endif
+
 	pthread_mutex_lock(&memory_mutex);
 
 	if(cc_meminfo_init() == NULL)
@@ -414,6 +1101,25 @@ cc_memory_rem(const char* func, int line, void* ptr)
 		return;
 	}
 
+	#ifdef CC_MEMORY_SAMPLING
+	cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+	if(mem->size & CC_MEMORY_SAMPLED)
+	{
+		mem->size &= ~CC_MEMORY_SAMPLED;
+
+		cc_memoryThread_t* thread = cc_memoryThread_get();
+		if(thread)
+		{
+			cc_memory_sampleRecord(thread, func, line, ptr, 0);
+		}
+		else
+		{
+			LOGW("invalid %s@%i ptr=%p", func, line, ptr);
+		}
+	}
+	return;
+	#endif
+
 	pthread_mutex_lock(&memory_mutex);
 
 	if(cc_meminfo_init() == NULL)
@@ -438,6 +1144,11 @@ cc_memory_memcheckptr(const char* func, int line, void* ptr)
 		return 1;
 	}
 
+	#ifdef CC_MEMORY_SAMPLING
+	// unsampled allocations are not tracked
+	return 1;
+	#endif
+
 	pthread_mutex_lock(&memory_mutex);
 
 	if(cc_meminfo_init() == NULL)
@@ -458,6 +1169,24 @@ static void cc_memory_meminfo(void)
 {
 	pthread_mutex_lock(&memory_mutex);
 
+	#ifdef CC_MEMORY_SAMPLING
+	int count;
+	cc_memorySite_t* sites;
+	sites = cc_memory_sampleSitesLocked(&count);
+
+	int i;
+	for(i = 0; i < count; ++i)
+	{
+		LOGI("name=%s@%i, cnt_est=%.0f, size_est=%.0f",
+		     sites[i].func, sites[i].line,
+		     sites[i].count, sites[i].size);
+	}
+	free(sites);
+
+	pthread_mutex_unlock(&memory_mutex);
+	return;
+	#endif
+
 	if(cc_meminfo_init() == NULL)
 	{
 		pthread_mutex_unlock(&memory_mutex);
@@ -469,6 +1198,58 @@ static void cc_memory_meminfo(void)
 	pthread_mutex_unlock(&memory_mutex);
 }
 
+static int cc_memory_profile(const char* fname)
+{
+	ASSERT(fname);
+
+	FILE* f = fopen(fname, "w");
+	if(f == NULL)
+	{
+		LOGE("fopen %s failed", fname);
+		return 0;
+	}
+
+	pthread_mutex_lock(&memory_mutex);
+
+	// the profile uses the flamegraph collapsed stack format
+	// where the call site is the only frame
+	#ifdef CC_MEMORY_SAMPLING
+	int count;
+	cc_memorySite_t* sites;
+	sites = cc_memory_sampleSitesLocked(&count);
+
+	int i;
+	for(i = 0; i < count; ++i)
+	{
+		fprintf(f, "%s@%i %" PRIu64 "\n",
+		        sites[i].func, sites[i].line,
+		        (uint64_t) (sites[i].size + 0.5));
+	}
+	free(sites);
+	#else
+	if(cc_meminfo_init())
+	{
+		cc_mapIter_t* miter;
+		miter = cc_map_head(memory_meminfo->map_ator);
+		while(miter)
+		{
+			cc_ator_t* ator = (cc_ator_t*) cc_map_val(miter);
+			if(ator->size)
+			{
+				fprintf(f, "%s %" PRIu64 "\n",
+				        ator->name, (uint64_t) ator->size);
+			}
+			miter = cc_map_next(miter);
+		}
+	}
+	#endif
+
+	pthread_mutex_unlock(&memory_mutex);
+
+	fclose(f);
+	return 1;
+}
+
 /***********************************************************
 * public - debug                                           *
 ***********************************************************/
@@ -523,6 +1304,11 @@ int cc_memcheckptr_debug(const char* func, int line,
 	return cc_memory_memcheckptr(func, line, ptr);
 }
 
+int cc_memprofile_debug(const char* fname)
+{
+	return cc_memory_profile(fname);
+}
+
 #endif // MEMORY_DEBUG
 
 /***********************************************************
@@ -531,42 +1317,53 @@ int cc_memcheckptr_debug(const char* func, int line,
 
 void* cc_malloc(size_t size)
 {
+	cc_memoryThread_t* thread = cc_memoryThread_get();
+
 	cc_memory_t* mem;
-	mem = (cc_memory_t*)
-	      malloc(size + sizeof(cc_memory_t));
+	mem = cc_memoryThread_alloc(thread, size);
 	if(mem == NULL)
 	{
-		return NULL;
+		mem = (cc_memory_t*)
+		      malloc(cc_memory_capacity(size) +
+		             sizeof(cc_memory_t));
+		if(mem == NULL)
+		{
+			return NULL;
+		}
 	}
 	mem->size = size;
 
-	pthread_mutex_lock(&memory_mutex);
-	++memory_count;
-	memory_size += mem->size;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem, (int) mem->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memoryThread_update(thread, 1, (int64_t) size);
+	LOGD("mem=%p, size=%i", mem, (int) mem->size);
 
 	return (void*) mem + sizeof(cc_memory_t);
 }
 
 void* cc_calloc(size_t count, size_t size)
 {
+	cc_memoryThread_t* thread = cc_memoryThread_get();
+
+	size_t       total = count*size;
 	cc_memory_t* mem;
-	mem = (cc_memory_t*)
-	      calloc(1, count*size + sizeof(cc_memory_t));
-	if(mem == NULL)
+	mem = cc_memoryThread_alloc(thread, total);
+	if(mem)
 	{
-		return NULL;
+		memset((void*) mem + sizeof(cc_memory_t), 0, total);
 	}
-	mem->size = count*size;
+	else
+	{
+		mem = (cc_memory_t*)
+		      calloc(1, cc_memory_capacity(total) +
+		                sizeof(cc_memory_t));
+		if(mem == NULL)
+		{
+			return NULL;
+		}
+	}
+	mem->size = total;
 
-	pthread_mutex_lock(&memory_mutex);
-	++memory_count;
-	memory_size += mem->size;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem, (int) mem->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memoryThread_update(thread, 1, (int64_t) total);
+	LOGD("mem=%p, size=%i", mem, (int) mem->size);
 
 	return (void*) mem + sizeof(cc_memory_t);
 }
@@ -580,22 +1377,30 @@ void* cc_realloc(void* ptr, size_t size)
 
 	cc_memory_t* mem1  = (cc_memory_t*)
 	                     (ptr - sizeof(cc_memory_t));
-	size_t       size1 = mem1->size;
+	size_t       size1 = cc_memory_size(mem1);
+
+	// reuse the block when the size class is unchanged
+	if(cc_memory_capacity(size) == cc_memory_capacity(size1))
+	{
+		mem1->size = size;
+		cc_memoryThread_update(cc_memoryThread_get(), 0,
+		                       (int64_t) size - (int64_t) size1);
+		return ptr;
+	}
 
 	cc_memory_t* mem2;
 	mem2 = (cc_memory_t*)
-	       realloc((void*) mem1, size + sizeof(cc_memory_t));
+	       realloc((void*) mem1, cc_memory_capacity(size) +
+	                             sizeof(cc_memory_t));
 	if(mem2 == NULL)
 	{
 		return NULL;
 	}
 	mem2->size = size;
 
-	pthread_mutex_lock(&memory_mutex);
-	memory_size += mem2->size - size1;
-	LOGD("mem=%p, size=%i, memory_size=%i",
-	     mem2, (int) mem2->size, memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memoryThread_update(cc_memoryThread_get(), 0,
+	                       (int64_t) size - (int64_t) size1);
+	LOGD("mem=%p, size=%i", mem2, (int) mem2->size);
 
 	return (void*) mem2 + sizeof(cc_memory_t);
 }
@@ -604,42 +1409,43 @@ void cc_free(void* ptr)
 {
 	if(ptr)
 	{
-		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+		cc_memoryThread_t* thread = cc_memoryThread_get();
 
-		pthread_mutex_lock(&memory_mutex);
-		--memory_count;
-		memory_size -= mem->size;
-		LOGD("mem=%p, size=%i, memory_size=%i",
-		     mem, (int) mem->size, memory_size);
-		pthread_mutex_unlock(&memory_mutex);
+		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
+		mem->size = cc_memory_size(mem);
+		cc_memoryThread_update(thread, -1,
+		                       -((int64_t) mem->size));
+		LOGD("mem=%p, size=%i", mem, (int) mem->size);
 
-		free(mem);
+		if(cc_memoryThread_free(thread, mem) == 0)
+		{
+			free(mem);
+		}
 	}
 }
 
 size_t cc_memcount(void)
 {
 	size_t count;
-	pthread_mutex_lock(&memory_mutex);
-	count = memory_count;
-	pthread_mutex_unlock(&memory_mutex);
+	size_t size;
+	cc_memory_totals(&count, &size);
 	return count;
 }
 
 void cc_meminfo(void)
 {
-	pthread_mutex_lock(&memory_mutex);
+	size_t count;
+	size_t size;
+	cc_memory_totals(&count, &size);
 	LOGI("count=%i, size=%" PRIu64,
-	     (int) memory_count, (uint64_t) memory_size);
-	pthread_mutex_unlock(&memory_mutex);
+	     (int) count, (uint64_t) size);
 }
 
 size_t cc_memsize(void)
 {
+	size_t count;
 	size_t size;
-	pthread_mutex_lock(&memory_mutex);
-	size = memory_size;
-	pthread_mutex_unlock(&memory_mutex);
+	cc_memory_totals(&count, &size);
 	return size;
 }
 
@@ -649,7 +1455,7 @@ size_t cc_memsizeptr(void* ptr)
 	if(ptr)
 	{
 		cc_memory_t* mem = ptr - sizeof(cc_memory_t);
-		size = mem->size;
+		size = cc_memory_size(mem);
 	}
 
 	return size;
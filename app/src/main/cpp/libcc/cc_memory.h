@@ -34,6 +34,7 @@ void* cc_realloc_debug(const char* func, int line,
 void  cc_free_debug(const char* func, int line, void* ptr);
 int   cc_memcheckptr_debug(const char* func, int line, void* ptr);
 void  cc_meminfo_debug(void);
+int   cc_memprofile_debug(const char* fname);
 #endif
 
 void*  cc_malloc(size_t size);
@@ -97,6 +98,14 @@ size_t cc_memsizeptr(void* ptr);
 	#endif
 #endif
 
+#ifndef MEMPROFILE
+	#ifdef MEMORY_DEBUG
+		#define MEMPROFILE(...) (cc_memprofile_debug(__VA_ARGS__))
+	#else
+		#define MEMPROFILE(...)
+	#endif
+#endif
+
 #ifndef MEMSIZE
 	#define MEMSIZE(...) (cc_memsize())
 #endif
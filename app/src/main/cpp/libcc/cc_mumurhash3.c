@@ -22,6 +22,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "cc_mumurhash3.h"
 
@@ -40,10 +41,14 @@
 
 // Block read - if your platform needs to do endian-swapping
 // or can only handle aligned reads, do the conversion here
+// memcpy allows keys with any alignment and compiles to a
+// single load on platforms which support unaligned reads
 FORCE_INLINE uint32_t
 getblock32 ( const uint32_t * p, int i )
 {
-  return p[i];
+  uint32_t k;
+  memcpy(&k, (const uint8_t*) p + 4*i, sizeof(uint32_t));
+  return k;
 }
 
 // Finalization mix - force all bits of a hash block to
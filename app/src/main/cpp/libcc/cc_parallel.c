@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_parallel.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// the loop is shared with the jobq threads and is freed
+// by the last reference since helper tasks may still be
+// pending in the jobq after all chunks are complete
+typedef struct
+{
+	int refcount;
+
+	// chunk [begin + i*grain, begin + (i + 1)*grain)
+	// is processed by the thread which claims index i
+	int begin;
+	int end;
+	int grain;
+	int count;
+	int next;
+	int complete;
+
+	// for_fn or reduce_fn
+	cc_parallelFor_fn    for_fn;
+	cc_parallelReduce_fn reduce_fn;
+	size_t               size;
+	char*                partials;
+	void*                priv;
+
+	// helper tasks (trailing array)
+	void** tasks;
+} cc_parallelLoop_t;
+
+static cc_parallelLoop_t*
+cc_parallelLoop_new(cc_parallel_t* parallel,
+                    int begin, int end, int grain)
+{
+	ASSERT(parallel);
+	ASSERT(begin < end);
+	ASSERT(grain > 0);
+
+	int64_t range = (int64_t) end - (int64_t) begin;
+	int     count = (int) ((range + grain - 1)/grain);
+
+	// the calling thread processes one chunk
+	int helpers = count - 1;
+	if(helpers > parallel->thread_count)
+	{
+		helpers = parallel->thread_count;
+	}
+
+	size_t size = sizeof(cc_parallelLoop_t) +
+	              helpers*sizeof(void*);
+
+	cc_parallelLoop_t* self;
+	self = (cc_parallelLoop_t*) CALLOC(1, size);
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->refcount = helpers + 1;
+	self->begin    = begin;
+	self->end      = end;
+	self->grain    = grain;
+	self->count    = count;
+	self->tasks    = (void**) &self[1];
+
+	int i;
+	for(i = 0; i < helpers; ++i)
+	{
+		self->tasks[i] = (void*) self;
+	}
+
+	return self;
+}
+
+static void cc_parallelLoop_decref(cc_parallelLoop_t** _self)
+{
+	ASSERT(_self);
+
+	cc_parallelLoop_t* self = *_self;
+	if(self)
+	{
+		if(__atomic_sub_fetch(&self->refcount, 1,
+		                      __ATOMIC_ACQ_REL) == 0)
+		{
+			FREE(self);
+		}
+		*_self = NULL;
+	}
+}
+
+static void
+cc_parallelLoop_exec(cc_parallelLoop_t* self,
+                     cc_parallel_t* parallel)
+{
+	ASSERT(self);
+	ASSERT(parallel);
+
+	int     i;
+	int64_t begin;
+	int64_t end;
+	char*   partial;
+	while(1)
+	{
+		// claim the next chunk
+		i = __atomic_fetch_add(&self->next, 1,
+		                       __ATOMIC_RELAXED);
+		if(i >= self->count)
+		{
+			return;
+		}
+
+		begin = (int64_t) self->begin +
+		        (int64_t) i*self->grain;
+		end   = begin + self->grain;
+		if(end > self->end)
+		{
+			end = self->end;
+		}
+
+		if(self->reduce_fn)
+		{
+			partial = &self->partials[i*self->size];
+			(*self->reduce_fn)(self->priv,
+			                   (int) begin, (int) end,
+			                   (void*) partial);
+		}
+		else
+		{
+			(*self->for_fn)(self->priv,
+			                (int) begin, (int) end);
+		}
+
+		// signal the calling thread after the last chunk
+		if(__atomic_add_fetch(&self->complete, 1,
+		                      __ATOMIC_ACQ_REL) == self->count)
+		{
+			pthread_mutex_lock(&parallel->mutex);
+			pthread_cond_broadcast(&parallel->cond_complete);
+			pthread_mutex_unlock(&parallel->mutex);
+		}
+	}
+}
+
+static void
+cc_parallel_runJob(int tid, void* owner, void* task)
+{
+	ASSERT(owner);
+	ASSERT(task);
+
+	cc_parallel_t*     self = (cc_parallel_t*) owner;
+	cc_parallelLoop_t* loop = (cc_parallelLoop_t*) task;
+
+	cc_parallelLoop_exec(loop, self);
+	cc_parallelLoop_decref(&loop);
+}
+
+static void
+cc_parallel_run(cc_parallel_t* self, cc_parallelLoop_t* loop)
+{
+	ASSERT(self);
+	ASSERT(loop);
+
+	// submit the helper tasks to the jobq
+	int helpers = loop->refcount - 1;
+	if(helpers &&
+	   (cc_jobq_runBatch(self->jobq, helpers,
+	                     loop->tasks) == 0))
+	{
+		// the calling thread processes all chunks
+		__atomic_sub_fetch(&loop->refcount, helpers,
+		                   __ATOMIC_ACQ_REL);
+	}
+
+	// the calling thread participates in the loop
+	cc_parallelLoop_exec(loop, self);
+
+	// wait for chunks claimed by the jobq threads
+	pthread_mutex_lock(&self->mutex);
+	while(__atomic_load_n(&loop->complete, __ATOMIC_ACQUIRE) <
+	      loop->count)
+	{
+		pthread_cond_wait(&self->cond_complete, &self->mutex);
+	}
+	pthread_mutex_unlock(&self->mutex);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_parallel_t* cc_parallel_new(int thread_count,
+                               int thread_priority)
+{
+	ASSERT(thread_count >= 0);
+
+	cc_parallel_t* self;
+	self = (cc_parallel_t*) CALLOC(1, sizeof(cc_parallel_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->thread_count = thread_count;
+
+	// PTHREAD_MUTEX_DEFAULT is not re-entrant
+	if(pthread_mutex_init(&self->mutex, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		goto fail_mutex_init;
+	}
+
+	if(pthread_cond_init(&self->cond_complete, NULL) != 0)
+	{
+		LOGE("pthread_cond_init failed");
+		goto fail_cond_complete;
+	}
+
+	if(thread_count)
+	{
+		self->jobq = cc_jobq_new((void*) self, thread_count,
+		                         thread_priority,
+		                         cc_parallel_runJob);
+		if(self->jobq == NULL)
+		{
+			goto fail_jobq;
+		}
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_jobq:
+		pthread_cond_destroy(&self->cond_complete);
+	fail_cond_complete:
+		pthread_mutex_destroy(&self->mutex);
+	fail_mutex_init:
+		FREE(self);
+	return NULL;
+}
+
+void cc_parallel_delete(cc_parallel_t** _self)
+{
+	ASSERT(_self);
+
+	cc_parallel_t* self = *_self;
+	if(self)
+	{
+		// finish any helper tasks which are still pending
+		cc_jobq_delete(&self->jobq);
+		pthread_cond_destroy(&self->cond_complete);
+		pthread_mutex_destroy(&self->mutex);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int cc_parallel_for(cc_parallel_t* self,
+                    int begin, int end, int grain,
+                    cc_parallelFor_fn for_fn,
+                    void* priv)
+{
+	// priv may be NULL
+	ASSERT(self);
+	ASSERT(grain > 0);
+	ASSERT(for_fn);
+
+	if(begin >= end)
+	{
+		return 1;
+	}
+
+	cc_parallelLoop_t* loop;
+	loop = cc_parallelLoop_new(self, begin, end, grain);
+	if(loop == NULL)
+	{
+		return 0;
+	}
+
+	loop->for_fn = for_fn;
+	loop->priv   = priv;
+
+	cc_parallel_run(self, loop);
+	cc_parallelLoop_decref(&loop);
+
+	return 1;
+}
+
+int cc_parallel_reduce(cc_parallel_t* self,
+                       int begin, int end,
+                       int grain, size_t size,
+                       void* result,
+                       cc_parallelReduce_fn reduce_fn,
+                       cc_parallelJoin_fn join_fn,
+                       void* priv)
+{
+	// priv may be NULL
+	ASSERT(self);
+	ASSERT(grain > 0);
+	ASSERT(size > 0);
+	ASSERT(result);
+	ASSERT(reduce_fn);
+	ASSERT(join_fn);
+
+	if(begin >= end)
+	{
+		return 1;
+	}
+
+	cc_parallelLoop_t* loop;
+	loop = cc_parallelLoop_new(self, begin, end, grain);
+	if(loop == NULL)
+	{
+		return 0;
+	}
+
+	// each chunk has a partial result so the join order
+	// does not depend on the thread count or scheduling
+	char* partials;
+	partials = (char*) CALLOC(loop->count, size);
+	if(partials == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_partials;
+	}
+
+	loop->reduce_fn = reduce_fn;
+	loop->size      = size;
+	loop->partials  = partials;
+	loop->priv      = priv;
+
+	cc_parallel_run(self, loop);
+
+	int i;
+	for(i = 0; i < loop->count; ++i)
+	{
+		(*join_fn)(priv, result,
+		           (const void*) &partials[i*size]);
+	}
+
+	FREE(partials);
+	cc_parallelLoop_decref(&loop);
+
+	// success
+	return 1;
+
+	// failure
+	fail_partials:
+		// the helper references are only released by the
+		// jobq threads so free the unsubmitted loop directly
+		FREE(loop);
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_parallel_H
+#define cc_parallel_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "cc_jobq.h"
+
+// called from the jobq threads and the calling thread
+// to process the chunk [begin, end)
+typedef void (*cc_parallelFor_fn)(void* priv,
+                                  int begin, int end);
+
+// partial is zero initialized per chunk
+typedef void (*cc_parallelReduce_fn)(void* priv,
+                                     int begin, int end,
+                                     void* partial);
+
+// called from the calling thread to join the partial
+// results in chunk order
+typedef void (*cc_parallelJoin_fn)(void* priv,
+                                   void* result,
+                                   const void* partial);
+
+typedef struct
+{
+	// jobq threads are shared by all parallel loops and the
+	// jobq is NULL when the thread_count is zero
+	int        thread_count;
+	cc_jobq_t* jobq;
+
+	// loop completion
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond_complete;
+} cc_parallel_t;
+
+cc_parallel_t* cc_parallel_new(int thread_count,
+                               int thread_priority);
+void           cc_parallel_delete(cc_parallel_t** _self);
+int            cc_parallel_for(cc_parallel_t* self,
+                               int begin, int end,
+                               int grain,
+                               cc_parallelFor_fn for_fn,
+                               void* priv);
+int            cc_parallel_reduce(cc_parallel_t* self,
+                                  int begin, int end,
+                                  int grain, size_t size,
+                                  void* result,
+                                  cc_parallelReduce_fn reduce_fn,
+                                  cc_parallelJoin_fn join_fn,
+                                  void* priv);
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_pool.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define CC_POOL_ALIGN    8
+#define CC_POOL_MAGAZINE 32
+
+// per-thread magazine of slots for a threaded pool
+// magazines are allocated with calloc since they are
+// released after check_memory when threads exit
+typedef struct cc_poolMagazine_s
+{
+	cc_pool_t* pool;
+	int        serial;
+	int        count;
+	void*      slots[CC_POOL_MAGAZINE];
+
+	struct cc_poolMagazine_s* next;
+} cc_poolMagazine_t;
+
+// registry of threaded pools which are alive
+static pthread_mutex_t cc_pool_mutex  = PTHREAD_MUTEX_INITIALIZER;
+static cc_pool_t*      cc_pool_live   = NULL;
+static int             cc_pool_serial = 0;
+static pthread_key_t   cc_pool_key;
+static pthread_once_t  cc_pool_once   = PTHREAD_ONCE_INIT;
+
+static size_t cc_pool_align(size_t size)
+{
+	return (size + CC_POOL_ALIGN - 1) &
+	       ~((size_t) CC_POOL_ALIGN - 1);
+}
+
+static void* cc_pool_allocLocked(cc_pool_t* self)
+{
+	ASSERT(self);
+
+	void* ptr = self->free;
+	if(ptr)
+	{
+		self->free = *((void**) ptr);
+		return ptr;
+	}
+
+	if(self->bump == self->bump_end)
+	{
+		size_t header = cc_pool_align(sizeof(cc_poolSlab_t));
+
+		cc_poolSlab_t* slab;
+		slab = (cc_poolSlab_t*)
+		       MALLOC(header + self->slab_count*self->size);
+		if(slab == NULL)
+		{
+			LOGE("MALLOC failed");
+			return NULL;
+		}
+
+		slab->next     = self->slabs;
+		self->slabs    = slab;
+		self->bump     = ((unsigned char*) slab) + header;
+		self->bump_end = self->bump +
+		                 self->slab_count*self->size;
+	}
+
+	ptr         = (void*) self->bump;
+	self->bump += self->size;
+	return ptr;
+}
+
+static void cc_pool_freeLocked(cc_pool_t* self, void* ptr)
+{
+	ASSERT(self);
+	ASSERT(ptr);
+
+	*((void**) ptr) = self->free;
+	self->free      = ptr;
+}
+
+static int cc_pool_isLive(cc_pool_t* pool, int serial)
+{
+	ASSERT(pool);
+
+	// cc_pool_mutex must be locked
+	cc_pool_t* iter = cc_pool_live;
+	while(iter)
+	{
+		if((iter == pool) && (iter->serial == serial))
+		{
+			return 1;
+		}
+		iter = iter->next;
+	}
+	return 0;
+}
+
+static void
+cc_poolMagazine_release(cc_poolMagazine_t* self)
+{
+	ASSERT(self);
+
+	// cc_pool_mutex must be locked
+	cc_pool_t* pool = self->pool;
+	if(cc_pool_isLive(pool, self->serial))
+	{
+		pthread_mutex_lock(&pool->mutex);
+		int i;
+		for(i = 0; i < self->count; ++i)
+		{
+			cc_pool_freeLocked(pool, self->slots[i]);
+		}
+		pthread_mutex_unlock(&pool->mutex);
+	}
+	free(self);
+}
+
+static void cc_pool_destruct(void* arg)
+{
+	ASSERT(arg);
+
+	// return the magazine slots to the pools which are alive
+	cc_poolMagazine_t* head = (cc_poolMagazine_t*) arg;
+	cc_poolMagazine_t* next;
+	pthread_mutex_lock(&cc_pool_mutex);
+	while(head)
+	{
+		next = head->next;
+		cc_poolMagazine_release(head);
+		head = next;
+	}
+	pthread_mutex_unlock(&cc_pool_mutex);
+}
+
+static void cc_pool_init(void)
+{
+	if(pthread_key_create(&cc_pool_key,
+	                      cc_pool_destruct) != 0)
+	{
+		LOGE("pthread_key_create failed");
+	}
+}
+
+static cc_poolMagazine_t* cc_pool_magazine(cc_pool_t* self)
+{
+	ASSERT(self);
+
+	pthread_once(&cc_pool_once, cc_pool_init);
+
+	// find the magazine and move it to the head
+	cc_poolMagazine_t* head;
+	cc_poolMagazine_t* prev = NULL;
+	cc_poolMagazine_t* iter;
+	head = (cc_poolMagazine_t*) pthread_getspecific(cc_pool_key);
+	iter = head;
+	while(iter)
+	{
+		if((iter->pool == self) && (iter->serial == self->serial))
+		{
+			if(prev)
+			{
+				prev->next = iter->next;
+				iter->next = head;
+				pthread_setspecific(cc_pool_key,
+				                    (const void*) iter);
+			}
+			return iter;
+		}
+		prev = iter;
+		iter = iter->next;
+	}
+
+	// discard the magazines of deleted pools
+	pthread_mutex_lock(&cc_pool_mutex);
+	cc_poolMagazine_t** _iter = &head;
+	while(*_iter)
+	{
+		iter = *_iter;
+		if(cc_pool_isLive(iter->pool, iter->serial))
+		{
+			_iter = &iter->next;
+		}
+		else
+		{
+			*_iter = iter->next;
+			free(iter);
+		}
+	}
+	pthread_mutex_unlock(&cc_pool_mutex);
+
+	iter = (cc_poolMagazine_t*)
+	       calloc(1, sizeof(cc_poolMagazine_t));
+	if(iter == NULL)
+	{
+		LOGE("calloc failed");
+		pthread_setspecific(cc_pool_key, (const void*) head);
+		return NULL;
+	}
+
+	iter->pool   = self;
+	iter->serial = self->serial;
+	iter->next   = head;
+	if(pthread_setspecific(cc_pool_key, (const void*) iter) != 0)
+	{
+		LOGE("pthread_setspecific failed");
+		free(iter);
+		pthread_setspecific(cc_pool_key, (const void*) head);
+		return NULL;
+	}
+
+	return iter;
+}
+
+static cc_pool_t*
+cc_pool_newFlags(size_t size, int slab_count, int threaded)
+{
+	ASSERT(size > 0);
+	ASSERT(slab_count > 0);
+
+	cc_pool_t* self;
+	self = (cc_pool_t*) CALLOC(1, sizeof(cc_pool_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	// free slots store the freelist pointer
+	if(size < sizeof(void*))
+	{
+		size = sizeof(void*);
+	}
+
+	self->size       = cc_pool_align(size);
+	self->slab_count = slab_count;
+	self->threaded   = threaded;
+
+	if(threaded)
+	{
+		// PTHREAD_MUTEX_DEFAULT is not re-entrant
+		if(pthread_mutex_init(&self->mutex, NULL) != 0)
+		{
+			LOGE("pthread_mutex_init failed");
+			goto fail_mutex_init;
+		}
+
+		pthread_mutex_lock(&cc_pool_mutex);
+		self->serial = ++cc_pool_serial;
+		self->next   = cc_pool_live;
+		cc_pool_live = self;
+		pthread_mutex_unlock(&cc_pool_mutex);
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_mutex_init:
+		FREE(self);
+	return NULL;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_pool_t* cc_pool_new(size_t size, int slab_count)
+{
+	return cc_pool_newFlags(size, slab_count, 0);
+}
+
+cc_pool_t* cc_pool_newThreaded(size_t size, int slab_count)
+{
+	return cc_pool_newFlags(size, slab_count, 1);
+}
+
+void cc_pool_delete(cc_pool_t** _self)
+{
+	ASSERT(_self);
+
+	cc_pool_t* self = *_self;
+	if(self)
+	{
+		if(self->threaded)
+		{
+			// magazines of other threads become stale and
+			// are discarded without accessing the pool
+			pthread_mutex_lock(&cc_pool_mutex);
+			cc_pool_t** _iter = &cc_pool_live;
+			while(*_iter)
+			{
+				if(*_iter == self)
+				{
+					*_iter = self->next;
+					break;
+				}
+				_iter = &(*_iter)->next;
+			}
+			pthread_mutex_unlock(&cc_pool_mutex);
+
+			pthread_mutex_destroy(&self->mutex);
+		}
+
+		cc_poolSlab_t* slab;
+		while(self->slabs)
+		{
+			slab        = self->slabs;
+			self->slabs = slab->next;
+			FREE(slab);
+		}
+
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void* cc_pool_alloc(cc_pool_t* self)
+{
+	ASSERT(self);
+
+	if(self->threaded == 0)
+	{
+		return cc_pool_allocLocked(self);
+	}
+
+	cc_poolMagazine_t* magazine = cc_pool_magazine(self);
+	if(magazine == NULL)
+	{
+		pthread_mutex_lock(&self->mutex);
+		void* ptr = cc_pool_allocLocked(self);
+		pthread_mutex_unlock(&self->mutex);
+		return ptr;
+	}
+
+	// refill half of the magazine
+	if(magazine->count == 0)
+	{
+		void* ptr;
+		pthread_mutex_lock(&self->mutex);
+		while(magazine->count < CC_POOL_MAGAZINE/2)
+		{
+			ptr = cc_pool_allocLocked(self);
+			if(ptr == NULL)
+			{
+				break;
+			}
+			magazine->slots[magazine->count++] = ptr;
+		}
+		pthread_mutex_unlock(&self->mutex);
+
+		if(magazine->count == 0)
+		{
+			return NULL;
+		}
+	}
+
+	return magazine->slots[--magazine->count];
+}
+
+void cc_pool_free(cc_pool_t* self, void* ptr)
+{
+	// ptr may be NULL
+	ASSERT(self);
+
+	if(ptr == NULL)
+	{
+		return;
+	}
+	else if(self->threaded == 0)
+	{
+		cc_pool_freeLocked(self, ptr);
+		return;
+	}
+
+	cc_poolMagazine_t* magazine = cc_pool_magazine(self);
+	if(magazine == NULL)
+	{
+		pthread_mutex_lock(&self->mutex);
+		cc_pool_freeLocked(self, ptr);
+		pthread_mutex_unlock(&self->mutex);
+		return;
+	}
+
+	// spill half of the magazine
+	if(magazine->count == CC_POOL_MAGAZINE)
+	{
+		pthread_mutex_lock(&self->mutex);
+		while(magazine->count > CC_POOL_MAGAZINE/2)
+		{
+			cc_pool_freeLocked(self,
+			                   magazine->slots[--magazine->count]);
+		}
+		pthread_mutex_unlock(&self->mutex);
+	}
+
+	magazine->slots[magazine->count++] = ptr;
+}
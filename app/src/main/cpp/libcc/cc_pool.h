@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_pool_H
+#define cc_pool_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+typedef struct cc_poolSlab_s
+{
+	struct cc_poolSlab_s* next;
+} cc_poolSlab_t;
+
+typedef struct cc_pool_s
+{
+	// slots have a fixed size and are allocated from slabs
+	// of slab_count slots
+	size_t size;
+	int    slab_count;
+
+	// slabs are allocated with MALLOC so they are counted by
+	// cc_meminfo and slots are only released by delete
+	cc_poolSlab_t* slabs;
+	void*          free;
+	unsigned char* bump;
+	unsigned char* bump_end;
+
+	// threaded pools are protected by the mutex and each
+	// thread has a magazine of slots
+	int               threaded;
+	int               serial;
+	pthread_mutex_t   mutex;
+	struct cc_pool_s* next;
+} cc_pool_t;
+
+cc_pool_t* cc_pool_new(size_t size, int slab_count);
+cc_pool_t* cc_pool_newThreaded(size_t size, int slab_count);
+void       cc_pool_delete(cc_pool_t** _self);
+void*      cc_pool_alloc(cc_pool_t* self);
+void       cc_pool_free(cc_pool_t* self, void* ptr);
+
+#endif
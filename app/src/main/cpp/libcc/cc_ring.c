@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <limits.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_ring.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// waiters poll with a cpu relax hint for CC_RING_SPIN
+// iterations and then yield for CC_RING_YIELD iterations
+// before they sleep
+#define CC_RING_SPIN  64
+#define CC_RING_YIELD 16
+
+#if defined(__x86_64__) || defined(__i386__)
+	#define CC_RING_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define CC_RING_RELAX() __asm__ __volatile__("yield")
+#else
+	#define CC_RING_RELAX()
+#endif
+
+static int cc_ring_backoff(int* _spin)
+{
+	ASSERT(_spin);
+
+	int spin = *_spin;
+	if(spin < CC_RING_SPIN)
+	{
+		CC_RING_RELAX();
+	}
+	else if(spin < CC_RING_SPIN + CC_RING_YIELD)
+	{
+		sched_yield();
+	}
+	else
+	{
+		// sleep
+		return 0;
+	}
+
+	*_spin = spin + 1;
+	return 1;
+}
+
+static void cc_ring_sleep(uint32_t* sleep)
+{
+	ASSERT(sleep);
+
+	// returns immediately if the waker cleared sleep
+	syscall(SYS_futex, sleep, FUTEX_WAIT_PRIVATE, 1,
+	        NULL, NULL, 0);
+}
+
+static void cc_ring_wakeSleep(uint32_t* sleep)
+{
+	ASSERT(sleep);
+
+	// the fence orders the publish before the sleep check
+	// and pairs with the store of sleep in the wait functions
+	// so a waiter cannot miss the wake
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	// only the thread which clears sleep makes the syscall
+	if(__atomic_load_n(sleep, __ATOMIC_RELAXED) &&
+	   __atomic_exchange_n(sleep, 0, __ATOMIC_SEQ_CST))
+	{
+		syscall(SYS_futex, sleep, FUTEX_WAKE_PRIVATE, INT_MAX,
+		        NULL, NULL, 0);
+	}
+}
+
+static int cc_ring_pushSPSC(cc_ring_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	// only reload the consumer head when the cached head
+	// indicates that the ring is full
+	uint32_t tail = self->tail;
+	if(tail - self->cache_head > self->mask)
+	{
+		self->cache_head = __atomic_load_n(&self->head,
+		                                   __ATOMIC_ACQUIRE);
+		if(tail - self->cache_head > self->mask)
+		{
+			return 0;
+		}
+	}
+
+	self->slots[tail & self->mask].data = data;
+	__atomic_store_n(&self->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+static const void* cc_ring_popSPSC(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	// only reload the producer tail when the cached tail
+	// indicates that the ring is empty
+	uint32_t head = self->head;
+	if(head == self->cache_tail)
+	{
+		self->cache_tail = __atomic_load_n(&self->tail,
+		                                   __ATOMIC_ACQUIRE);
+		if(head == self->cache_tail)
+		{
+			return NULL;
+		}
+	}
+
+	const void* data = self->slots[head & self->mask].data;
+	__atomic_store_n(&self->head, head + 1, __ATOMIC_RELEASE);
+
+	return data;
+}
+
+static int cc_ring_pushMPSC(cc_ring_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	// producers claim a slot by advancing the tail when the
+	// slot seq shows that the consumer has released it
+	cc_ringSlot_t* slot;
+	uint32_t       seq;
+	int32_t        dif;
+	uint32_t       tail = __atomic_load_n(&self->tail,
+	                                      __ATOMIC_RELAXED);
+	while(1)
+	{
+		slot = &self->slots[tail & self->mask];
+		seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		dif  = (int32_t) (seq - tail);
+		if(dif == 0)
+		{
+			if(__atomic_compare_exchange_n(&self->tail, &tail,
+			                               tail + 1, 1,
+			                               __ATOMIC_RELAXED,
+			                               __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if(dif < 0)
+		{
+			// full
+			return 0;
+		}
+		else
+		{
+			tail = __atomic_load_n(&self->tail,
+			                       __ATOMIC_RELAXED);
+		}
+	}
+
+	// publish the slot to the consumer
+	slot->data = data;
+	__atomic_store_n(&slot->seq, tail + 1, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+static const void* cc_ring_popMPSC(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	uint32_t       head = self->head;
+	cc_ringSlot_t* slot = &self->slots[head & self->mask];
+	uint32_t       seq  = __atomic_load_n(&slot->seq,
+	                                      __ATOMIC_ACQUIRE);
+	if(seq != head + 1)
+	{
+		// empty or the producer has not published the slot
+		return NULL;
+	}
+
+	// release the slot to the producers for the next lap
+	const void* data = slot->data;
+	__atomic_store_n(&slot->seq, head + self->mask + 1,
+	                 __ATOMIC_RELEASE);
+	__atomic_store_n(&self->head, head + 1, __ATOMIC_RELEASE);
+
+	return data;
+}
+
+static cc_ring_t* cc_ring_newMode(int capacity, int mpsc)
+{
+	ASSERT(capacity > 0);
+
+	if(capacity > (1 << 30))
+	{
+		LOGE("invalid capacity=%i", capacity);
+		return NULL;
+	}
+
+	// round the capacity up to a power of two
+	uint32_t count = 1;
+	while(count < (uint32_t) capacity)
+	{
+		count <<= 1;
+	}
+
+	cc_ring_t* self;
+	self = (cc_ring_t*) CALLOC(1, sizeof(cc_ring_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->slots = (cc_ringSlot_t*)
+	              CALLOC(count, sizeof(cc_ringSlot_t));
+	if(self->slots == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_slots;
+	}
+
+	self->mpsc = mpsc;
+	self->mask = count - 1;
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		self->slots[i].seq = i;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_slots:
+		FREE(self);
+	return NULL;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_ring_t* cc_ring_new(int capacity)
+{
+	ASSERT(capacity > 0);
+
+	return cc_ring_newMode(capacity, 0);
+}
+
+cc_ring_t* cc_ring_newMPSC(int capacity)
+{
+	ASSERT(capacity > 0);
+
+	return cc_ring_newMode(capacity, 1);
+}
+
+void cc_ring_delete(cc_ring_t** _self)
+{
+	ASSERT(_self);
+
+	cc_ring_t* self = *_self;
+	if(self)
+	{
+		FREE(self->slots);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int cc_ring_capacity(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	return (int) (self->mask + 1);
+}
+
+int cc_ring_size(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	// the size is approximate when called concurrently
+	// and includes MPSC slots which are not yet published
+	uint32_t head = __atomic_load_n(&self->head,
+	                                __ATOMIC_ACQUIRE);
+	uint32_t tail = __atomic_load_n(&self->tail,
+	                                __ATOMIC_ACQUIRE);
+	return (int) (tail - head);
+}
+
+int cc_ring_push(cc_ring_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	int ret;
+	if(self->mpsc)
+	{
+		ret = cc_ring_pushMPSC(self, data);
+	}
+	else
+	{
+		ret = cc_ring_pushSPSC(self, data);
+	}
+
+	if(ret)
+	{
+		cc_ring_wakeSleep(&self->sleep_pop);
+	}
+
+	return ret;
+}
+
+int cc_ring_pushWait(cc_ring_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	int spin = 0;
+	while(cc_ring_push(self, data) == 0)
+	{
+		if(cc_ring_backoff(&spin))
+		{
+			continue;
+		}
+
+		// sleep must be set before the ring is checked again
+		__atomic_store_n(&self->sleep_push, 1,
+		                 __ATOMIC_SEQ_CST);
+		if(cc_ring_push(self, data))
+		{
+			break;
+		}
+		cc_ring_sleep(&self->sleep_push);
+	}
+
+	return 1;
+}
+
+const void* cc_ring_pop(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	const void* data;
+	if(self->mpsc)
+	{
+		data = cc_ring_popMPSC(self);
+	}
+	else
+	{
+		data = cc_ring_popSPSC(self);
+	}
+
+	if(data)
+	{
+		cc_ring_wakeSleep(&self->sleep_push);
+	}
+
+	return data;
+}
+
+const void* cc_ring_popWait(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	const void* data;
+	int spin = 0;
+	while(1)
+	{
+		data = cc_ring_pop(self);
+		if(data)
+		{
+			return data;
+		}
+		else if(cc_ring_backoff(&spin))
+		{
+			continue;
+		}
+
+		// sleep must be set before the ring and interrupt are
+		// checked again
+		__atomic_store_n(&self->sleep_pop, 1,
+		                 __ATOMIC_SEQ_CST);
+		data = cc_ring_pop(self);
+		if(data)
+		{
+			return data;
+		}
+		else if(__atomic_exchange_n(&self->interrupt, 0,
+		                            __ATOMIC_SEQ_CST))
+		{
+			// interrupted by cc_ring_wake so the consumer may
+			// check its exit condition
+			return NULL;
+		}
+		cc_ring_sleep(&self->sleep_pop);
+	}
+}
+
+void cc_ring_wake(cc_ring_t* self)
+{
+	ASSERT(self);
+
+	// the interrupt is consumed by the current or next call
+	// to cc_ring_popWait
+	__atomic_store_n(&self->interrupt, 1, __ATOMIC_SEQ_CST);
+	cc_ring_wakeSleep(&self->sleep_pop);
+}
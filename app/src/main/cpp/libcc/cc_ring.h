@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_ring_H
+#define cc_ring_H
+
+#include <stdint.h>
+
+#define CC_RING_CACHELINE 64
+
+// slots are published by seq in MPSC mode
+typedef struct
+{
+	uint32_t    seq;
+	const void* data;
+} cc_ringSlot_t;
+
+// bounded lock-free ring buffer for a single consumer and
+// either a single producer (SPSC) or multiple producers
+// (MPSC) where the capacity is a power of two
+typedef struct
+{
+	int            mpsc;
+	uint32_t       mask;
+	cc_ringSlot_t* slots;
+
+	// blocking state
+	// sleep_pop and sleep_push are futex words which are set
+	// by waiters and cleared by the thread which wakes them
+	uint32_t sleep_pop;
+	uint32_t sleep_push;
+	int      interrupt;
+
+	// producer state
+	char     pad_tail[CC_RING_CACHELINE];
+	uint32_t tail;
+	uint32_t cache_head;
+
+	// consumer state
+	char     pad_head[CC_RING_CACHELINE];
+	uint32_t head;
+	uint32_t cache_tail;
+	char     pad_end[CC_RING_CACHELINE];
+} cc_ring_t;
+
+cc_ring_t*  cc_ring_new(int capacity);
+cc_ring_t*  cc_ring_newMPSC(int capacity);
+void        cc_ring_delete(cc_ring_t** _self);
+int         cc_ring_capacity(cc_ring_t* self);
+int         cc_ring_size(cc_ring_t* self);
+int         cc_ring_push(cc_ring_t* self, const void* data);
+int         cc_ring_pushWait(cc_ring_t* self,
+                             const void* data);
+const void* cc_ring_pop(cc_ring_t* self);
+const void* cc_ring_popWait(cc_ring_t* self);
+void        cc_ring_wake(cc_ring_t* self);
+
+#endif
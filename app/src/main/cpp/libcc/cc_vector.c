@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "cc_log.h"
+#include "cc_memory.h"
+#include "cc_vector.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+#define CC_VECTOR_CAPACITY 8
+
+static void*
+cc_vector_elem(const cc_vector_t* self, int idx)
+{
+	ASSERT(self);
+
+	return (void*) (((unsigned char*) self->data) +
+	                ((size_t) idx)*self->elem_size);
+}
+
+static int cc_vector_grow(cc_vector_t* self, int size)
+{
+	ASSERT(self);
+
+	if(size <= self->capacity)
+	{
+		return 1;
+	}
+
+	// double the capacity for amortized appends
+	int capacity = 2*self->capacity;
+	if(capacity < CC_VECTOR_CAPACITY)
+	{
+		capacity = CC_VECTOR_CAPACITY;
+	}
+	if(capacity < size)
+	{
+		capacity = size;
+	}
+
+	return cc_vector_reserve(self, capacity);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_vector_t* cc_vector_new(size_t elem_size)
+{
+	return cc_vector_newArena(elem_size, NULL);
+}
+
+cc_vector_t*
+cc_vector_newArena(size_t elem_size, cc_arena_t* arena)
+{
+	// arena may be NULL
+	ASSERT(elem_size > 0);
+
+	cc_vector_t* self;
+	self = (cc_vector_t*) CALLOC(1, sizeof(cc_vector_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->elem_size = elem_size;
+	self->arena     = arena;
+
+	return self;
+}
+
+void cc_vector_delete(cc_vector_t** _self)
+{
+	ASSERT(_self);
+
+	cc_vector_t* self = *_self;
+	if(self)
+	{
+		// arena data is released by the arena
+		if(self->arena == NULL)
+		{
+			FREE(self->data);
+		}
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void cc_vector_clear(cc_vector_t* self)
+{
+	ASSERT(self);
+
+	self->size = 0;
+}
+
+int cc_vector_size(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	return self->size;
+}
+
+size_t cc_vector_sizeof(const cc_vector_t* self)
+{
+	ASSERT(self);
+
+	size_t size = sizeof(cc_vector_t);
+	if(self->arena == NULL)
+	{
+		size += MEMSIZEPTR(self->data);
+	}
+	return size;
+}
+
+int cc_vector_reserve(cc_vector_t* self, int capacity)
+{
+	ASSERT(self);
+
+	if(capacity <= self->capacity)
+	{
+		return 1;
+	}
+
+	void*  data;
+	size_t size = ((size_t) capacity)*self->elem_size;
+	if(self->arena)
+	{
+		data = cc_arena_alloc(self->arena, size);
+		if(data == NULL)
+		{
+			return 0;
+		}
+
+		if(self->size)
+		{
+			memcpy(data, self->data,
+			       ((size_t) self->size)*self->elem_size);
+		}
+	}
+	else
+	{
+		data = REALLOC(self->data, size);
+		if(data == NULL)
+		{
+			LOGE("REALLOC failed");
+			return 0;
+		}
+	}
+
+	self->data     = data;
+	self->capacity = capacity;
+	return 1;
+}
+
+int cc_vector_resize(cc_vector_t* self, int size)
+{
+	ASSERT(self);
+	ASSERT(size >= 0);
+
+	if(cc_vector_grow(self, size) == 0)
+	{
+		return 0;
+	}
+
+	// new elements are zeroed
+	if(size > self->size)
+	{
+		memset(cc_vector_elem(self, self->size), 0,
+		       ((size_t) (size - self->size))*self->elem_size);
+	}
+	self->size = size;
+
+	return 1;
+}
+
+void* cc_vector_get(const cc_vector_t* self, int idx)
+{
+	ASSERT(self);
+
+	if((idx < 0) || (idx >= self->size))
+	{
+		return NULL;
+	}
+
+	return cc_vector_elem(self, idx);
+}
+
+void* cc_vector_push(cc_vector_t* self, const void* elem)
+{
+	// elem may be NULL
+	ASSERT(self);
+
+	return cc_vector_insert(self, self->size, elem);
+}
+
+int cc_vector_pop(cc_vector_t* self, void* elem)
+{
+	// elem may be NULL
+	ASSERT(self);
+
+	if(self->size == 0)
+	{
+		return 0;
+	}
+
+	--self->size;
+	if(elem)
+	{
+		memcpy(elem, cc_vector_elem(self, self->size),
+		       self->elem_size);
+	}
+
+	return 1;
+}
+
+void* cc_vector_insert(cc_vector_t* self, int idx,
+                       const void* elem)
+{
+	// elem may be NULL
+	ASSERT(self);
+	ASSERT((idx >= 0) && (idx <= self->size));
+
+	// elem may reference the vector which is moved by grow
+	if(self->size == self->capacity)
+	{
+		unsigned char* data = (unsigned char*) self->data;
+		unsigned char* e    = (unsigned char*) elem;
+		size_t         size = ((size_t) self->size)*
+		                      self->elem_size;
+		if(e && data && (e >= data) && (e < data + size))
+		{
+			size_t offset = e - data;
+			if(cc_vector_grow(self, self->size + 1) == 0)
+			{
+				return NULL;
+			}
+			elem = ((unsigned char*) self->data) + offset;
+		}
+		else if(cc_vector_grow(self, self->size + 1) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	void* dst = cc_vector_elem(self, idx);
+	if(idx < self->size)
+	{
+		// elem is shifted along with the tail
+		if(elem && (elem >= dst) &&
+		   (elem < cc_vector_elem(self, self->size)))
+		{
+			elem = ((unsigned char*) elem) + self->elem_size;
+		}
+
+		memmove(cc_vector_elem(self, idx + 1), dst,
+		        ((size_t) (self->size - idx))*self->elem_size);
+	}
+
+	if(elem)
+	{
+		memcpy(dst, elem, self->elem_size);
+	}
+	else
+	{
+		memset(dst, 0, self->elem_size);
+	}
+	++self->size;
+
+	return dst;
+}
+
+void cc_vector_erase(cc_vector_t* self, int idx, int count)
+{
+	ASSERT(self);
+	ASSERT((idx >= 0) && (count >= 0) &&
+	       (idx + count <= self->size));
+
+	int tail = self->size - idx - count;
+	if(tail > 0)
+	{
+		memmove(cc_vector_elem(self, idx),
+		        cc_vector_elem(self, idx + count),
+		        ((size_t) tail)*self->elem_size);
+	}
+	self->size -= count;
+}
+
+void cc_vector_sort(cc_vector_t* self,
+                    cc_vectorcmp_fn compare)
+{
+	ASSERT(self);
+	ASSERT(compare);
+
+	if(self->size > 1)
+	{
+		qsort(self->data, self->size, self->elem_size,
+		      compare);
+	}
+}
+
+int cc_vector_findSorted(const cc_vector_t* self,
+                         const void* elem,
+                         cc_vectorcmp_fn compare)
+{
+	ASSERT(self);
+	ASSERT(elem);
+	ASSERT(compare);
+
+	// returns the index of a matching element or -1
+	int lo = 0;
+	int hi = self->size - 1;
+	int mid;
+	int cmp;
+	while(lo <= hi)
+	{
+		mid = lo + (hi - lo)/2;
+		cmp = (*compare)(cc_vector_elem(self, mid), elem);
+		if(cmp == 0)
+		{
+			return mid;
+		}
+		else if(cmp < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+
+	return -1;
+}
+
+void* cc_vector_insertSorted(cc_vector_t* self,
+                             cc_vectorcmp_fn compare,
+                             const void* elem)
+{
+	ASSERT(self);
+	ASSERT(compare);
+	ASSERT(elem);
+
+	// insert after equal elements to keep the order stable
+	int lo = 0;
+	int hi = self->size;
+	int mid;
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo)/2;
+		if((*compare)(cc_vector_elem(self, mid), elem) <= 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return cc_vector_insert(self, lo, elem);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_vector_H
+#define cc_vector_H
+
+#include <stddef.h>
+
+#include "cc_arena.h"
+
+typedef int (*cc_vectorcmp_fn)(const void* a, const void* b);
+
+// contiguous array of fixed size elements
+// element pointers are invalidated when the vector grows
+typedef struct
+{
+	size_t elem_size;
+	int    size;
+	int    capacity;
+	void*  data;
+
+	// optional arena which backs data where the old data
+	// is released when the arena is reset
+	cc_arena_t* arena;
+} cc_vector_t;
+
+cc_vector_t* cc_vector_new(size_t elem_size);
+cc_vector_t* cc_vector_newArena(size_t elem_size,
+                                cc_arena_t* arena);
+void         cc_vector_delete(cc_vector_t** _self);
+void         cc_vector_clear(cc_vector_t* self);
+int          cc_vector_size(const cc_vector_t* self);
+size_t       cc_vector_sizeof(const cc_vector_t* self);
+int          cc_vector_reserve(cc_vector_t* self,
+                               int capacity);
+int          cc_vector_resize(cc_vector_t* self, int size);
+void*        cc_vector_get(const cc_vector_t* self, int idx);
+void*        cc_vector_push(cc_vector_t* self,
+                            const void* elem);
+int          cc_vector_pop(cc_vector_t* self, void* elem);
+void*        cc_vector_insert(cc_vector_t* self, int idx,
+                              const void* elem);
+void         cc_vector_erase(cc_vector_t* self, int idx,
+                             int count);
+void         cc_vector_sort(cc_vector_t* self,
+                            cc_vectorcmp_fn compare);
+int          cc_vector_findSorted(const cc_vector_t* self,
+                                  const void* elem,
+                                  cc_vectorcmp_fn compare);
+void*        cc_vector_insertSorted(cc_vector_t* self,
+                                    cc_vectorcmp_fn compare,
+                                    const void* elem);
+
+#endif
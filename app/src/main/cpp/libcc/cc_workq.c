@@ -41,40 +41,425 @@ const int CC_WORKQ_STATE_STOP    = 1;
 // force purge a task or workq
 const int CC_WORKQ_PURGE = -1;
 
+#define CC_WORKQ_FLAG_STEAL 1
+
 static cc_workqNode_t*
-cc_workqNode_new(void* task, int purge_id, int priority)
+cc_workqNode_new(cc_pool_t* pool, void* task, int purge_id,
+                 int priority, uint64_t seq)
 {
+	ASSERT(pool);
 	ASSERT(task);
 	ASSERT((purge_id == 0) || (purge_id == 1));
 
 	cc_workqNode_t* self;
-	self = (cc_workqNode_t*) MALLOC(sizeof(cc_workqNode_t));
+	self = (cc_workqNode_t*) cc_pool_alloc(pool);
 	if(!self)
 	{
-		LOGE("MALLOC failed");
+		LOGE("cc_pool_alloc failed");
 		return NULL;
 	}
 
 	self->status   = CC_WORKQ_STATUS_PENDING;
 	self->priority = priority;
 	self->purge_id = purge_id;
-	self->task     = task;
+	self->task       = task;
+	self->seq        = seq;
+	self->iter       = NULL;
+	self->heap_index = -1;
+	self->deque      = NULL;
 
 	return self;
 }
 
-static void cc_workqNode_delete(cc_workqNode_t** _self)
+static void
+cc_workqNode_delete(cc_pool_t* pool, cc_workqNode_t** _self)
 {
+	ASSERT(pool);
 	ASSERT(_self);
 
 	cc_workqNode_t* self = *_self;
 	if(self)
 	{
-		FREE(self);
+		cc_pool_free(pool, self);
 		*_self = NULL;
 	}
 }
 
+static void
+cc_workqNode_setDeque(cc_workqNode_t* self,
+                      cc_workqDeque_t* deque)
+{
+	ASSERT(self);
+
+	__atomic_store_n(&self->deque, deque, __ATOMIC_RELEASE);
+}
+
+static int
+cc_workqHeap_before(cc_workqNode_t* a, cc_workqNode_t* b)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	if(a->priority == b->priority)
+	{
+		return a->seq < b->seq;
+	}
+	return a->priority > b->priority;
+}
+
+static void
+cc_workqHeap_set(cc_workqHeap_t* self, int idx,
+                 cc_workqNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	self->nodes[idx] = node;
+	node->heap_index = idx;
+}
+
+static void cc_workqHeap_up(cc_workqHeap_t* self, int idx)
+{
+	ASSERT(self);
+
+	cc_workqNode_t* node = self->nodes[idx];
+	cc_workqNode_t* parent;
+	while(idx > 0)
+	{
+		parent = self->nodes[(idx - 1)/2];
+		if(cc_workqHeap_before(node, parent) == 0)
+		{
+			break;
+		}
+		cc_workqHeap_set(self, idx, parent);
+		idx = (idx - 1)/2;
+	}
+	cc_workqHeap_set(self, idx, node);
+}
+
+static void cc_workqHeap_down(cc_workqHeap_t* self, int idx)
+{
+	ASSERT(self);
+
+	cc_workqNode_t* node = self->nodes[idx];
+	cc_workqNode_t* child;
+	int c;
+	while(1)
+	{
+		// select the child which runs first
+		c = 2*idx + 1;
+		if(c >= self->count)
+		{
+			break;
+		}
+		else if((c + 1 < self->count) &&
+		        cc_workqHeap_before(self->nodes[c + 1],
+		                            self->nodes[c]))
+		{
+			++c;
+		}
+
+		child = self->nodes[c];
+		if(cc_workqHeap_before(child, node) == 0)
+		{
+			break;
+		}
+		cc_workqHeap_set(self, idx, child);
+		idx = c;
+	}
+	cc_workqHeap_set(self, idx, node);
+}
+
+static void cc_workqHeap_init(cc_workqHeap_t* self)
+{
+	ASSERT(self);
+
+	self->count    = 0;
+	self->capacity = 0;
+	self->nodes    = NULL;
+}
+
+static void cc_workqHeap_destroy(cc_workqHeap_t* self)
+{
+	ASSERT(self);
+
+	FREE(self->nodes);
+	cc_workqHeap_init(self);
+}
+
+static int
+cc_workqHeap_reserve(cc_workqHeap_t* self, int count)
+{
+	ASSERT(self);
+
+	if(count <= self->capacity)
+	{
+		return 1;
+	}
+
+	int capacity = self->capacity ? 2*self->capacity : 64;
+	while(capacity < count)
+	{
+		capacity *= 2;
+	}
+
+	cc_workqNode_t** nodes;
+	nodes = (cc_workqNode_t**)
+	        REALLOC(self->nodes,
+	                capacity*sizeof(cc_workqNode_t*));
+	if(nodes == NULL)
+	{
+		LOGE("REALLOC failed");
+		return 0;
+	}
+
+	self->capacity = capacity;
+	self->nodes    = nodes;
+
+	return 1;
+}
+
+static void
+cc_workqHeap_push(cc_workqHeap_t* self, cc_workqNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	// capacity must be reserved by the caller so that the
+	// push cannot fail after a node changes queues
+	ASSERT(self->count < self->capacity);
+
+	cc_workqHeap_set(self, self->count, node);
+	++self->count;
+	cc_workqHeap_up(self, self->count - 1);
+}
+
+static void
+cc_workqHeap_remove(cc_workqHeap_t* self,
+                    cc_workqNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	int idx = node->heap_index;
+	ASSERT((idx >= 0) && (idx < self->count));
+	ASSERT(self->nodes[idx] == node);
+
+	// replace the node with the last node and restore the
+	// heap order in whichever direction it was violated
+	--self->count;
+	if(idx < self->count)
+	{
+		cc_workqHeap_set(self, idx, self->nodes[self->count]);
+		cc_workqHeap_up(self, idx);
+		cc_workqHeap_down(self, idx);
+	}
+	node->heap_index = -1;
+}
+
+static cc_workqNode_t* cc_workqHeap_pop(cc_workqHeap_t* self)
+{
+	ASSERT(self);
+
+	if(self->count == 0)
+	{
+		return NULL;
+	}
+
+	cc_workqNode_t* node = self->nodes[0];
+	cc_workqHeap_remove(self, node);
+	return node;
+}
+
+static void
+cc_workqHeap_update(cc_workqHeap_t* self,
+                    cc_workqNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	// the node priority or seq has changed
+	cc_workqHeap_up(self, node->heap_index);
+	cc_workqHeap_down(self, node->heap_index);
+}
+
+static int cc_workqDeque_init(cc_workqDeque_t* self)
+{
+	ASSERT(self);
+
+	if(pthread_mutex_init(&self->mutex, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		return 0;
+	}
+
+	cc_workqHeap_init(&self->heap_pending);
+
+	self->queue_pending = cc_list_new();
+	if(self->queue_pending == NULL)
+	{
+		goto fail_queue_pending;
+	}
+
+	self->queue_active = cc_list_new();
+	if(self->queue_active == NULL)
+	{
+		goto fail_queue_active;
+	}
+
+	self->queue_complete = cc_list_new();
+	if(self->queue_complete == NULL)
+	{
+		goto fail_queue_complete;
+	}
+
+	// success
+	return 1;
+
+	// failure
+	fail_queue_complete:
+		cc_list_delete(&self->queue_active);
+	fail_queue_active:
+		cc_list_delete(&self->queue_pending);
+	fail_queue_pending:
+		pthread_mutex_destroy(&self->mutex);
+	return 0;
+}
+
+static void cc_workqDeque_destroy(cc_workqDeque_t* self)
+{
+	ASSERT(self);
+
+	cc_list_delete(&self->queue_complete);
+	cc_list_delete(&self->queue_active);
+	cc_list_delete(&self->queue_pending);
+	cc_workqHeap_destroy(&self->heap_pending);
+	pthread_mutex_destroy(&self->mutex);
+}
+
+static cc_workqDeque_t*
+cc_workq_lockNode(cc_workq_t* self, cc_workqNode_t* node)
+{
+	ASSERT(self);
+	ASSERT(node);
+
+	// the workq mutex must be locked and the node may be
+	// stolen by another deque until the deque is locked
+	cc_workqDeque_t* deque;
+	while(1)
+	{
+		deque = __atomic_load_n(&node->deque, __ATOMIC_ACQUIRE);
+		if(deque == NULL)
+		{
+			return NULL;
+		}
+
+		pthread_mutex_lock(&deque->mutex);
+		if(node->deque == deque)
+		{
+			return deque;
+		}
+		pthread_mutex_unlock(&deque->mutex);
+	}
+}
+
+static void cc_workq_unlockNode(cc_workqDeque_t* deque)
+{
+	// deque may be NULL
+
+	if(deque)
+	{
+		pthread_mutex_unlock(&deque->mutex);
+	}
+}
+
+static cc_list_t*
+cc_workq_queue(cc_workq_t* self, cc_workqDeque_t* deque,
+               int status)
+{
+	// deque may be NULL
+	ASSERT(self);
+
+	if(deque)
+	{
+		if(status == CC_WORKQ_STATUS_PENDING)
+		{
+			return deque->queue_pending;
+		}
+		else if(status == CC_WORKQ_STATUS_ACTIVE)
+		{
+			return deque->queue_active;
+		}
+		return deque->queue_complete;
+	}
+
+	if(status == CC_WORKQ_STATUS_PENDING)
+	{
+		return self->queue_pending;
+	}
+	else if(status == CC_WORKQ_STATUS_ACTIVE)
+	{
+		return self->queue_active;
+	}
+	return self->queue_complete;
+}
+
+static cc_workqHeap_t*
+cc_workq_heap(cc_workq_t* self, cc_workqDeque_t* deque)
+{
+	// deque may be NULL
+	ASSERT(self);
+
+	if(deque)
+	{
+		return &deque->heap_pending;
+	}
+	return &self->heap_pending;
+}
+
+static void cc_workq_waiters(cc_workq_t* self, int delta)
+{
+	ASSERT(self);
+
+	// workers only signal cond_complete when a thread may be
+	// waiting in work-stealing mode
+	if(self->deques)
+	{
+		__atomic_add_fetch(&self->waiters, delta,
+		                   __ATOMIC_SEQ_CST);
+	}
+}
+
+static void cc_workq_wakeLocked(cc_workq_t* self, int count)
+{
+	ASSERT(self);
+
+	if(count == 0)
+	{
+		return;
+	}
+	else if(self->deques == NULL)
+	{
+		pthread_cond_broadcast(&self->cond_pending);
+		return;
+	}
+
+	// wake idle threads which may steal the tasks
+	if(__atomic_load_n(&self->idle, __ATOMIC_SEQ_CST))
+	{
+		pthread_mutex_lock(&self->mutex_idle);
+		if(count == 1)
+		{
+			pthread_cond_signal(&self->cond_pending);
+		}
+		else
+		{
+			pthread_cond_broadcast(&self->cond_pending);
+		}
+		pthread_mutex_unlock(&self->mutex_idle);
+	}
+}
+
 static void
 cc_workq_removeLocked(cc_workq_t* self, int finish,
                       cc_list_t* queue,
@@ -96,14 +481,70 @@ cc_workq_removeLocked(cc_workq_t* self, int finish,
 		(*self->finish_fn)(self->owner, node->task, node->status);
 	}
 
-	cc_workqNode_delete(&node);
+	cc_workqNode_delete(self->pool_node, &node);
 }
 
-static void* cc_workq_thread(void* arg)
+static void
+cc_workq_collectDequeLocked(cc_workq_t* self,
+                            cc_workqDeque_t* deque)
 {
-	ASSERT(arg);
+	ASSERT(self);
+	ASSERT(deque);
 
-	cc_workq_t* self = (cc_workq_t*) arg;
+	// move the complete queue from the locked deque to the
+	// workq where it is protected by the workq mutex
+	cc_listIter_t*  iter;
+	cc_workqNode_t* node;
+	iter = cc_list_head(deque->queue_complete);
+	while(iter)
+	{
+		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		cc_workqNode_setDeque(node, NULL);
+		iter = cc_list_next(iter);
+	}
+	cc_list_appendList(self->queue_complete,
+	                   deque->queue_complete);
+}
+
+static void cc_workq_collectLocked(cc_workq_t* self)
+{
+	ASSERT(self);
+
+	cc_workqDeque_t* deque;
+	int i;
+	for(i = 0; self->deques && (i < self->thread_count); ++i)
+	{
+		deque = &self->deques[i];
+		pthread_mutex_lock(&deque->mutex);
+		cc_workq_collectDequeLocked(self, deque);
+		pthread_mutex_unlock(&deque->mutex);
+	}
+}
+
+static int cc_workq_countLocked(cc_workq_t* self, int status)
+{
+	ASSERT(self);
+
+	int count = cc_list_size(cc_workq_queue(self, NULL,
+	                                        status));
+
+	cc_workqDeque_t* deque;
+	int i;
+	for(i = 0; self->deques && (i < self->thread_count); ++i)
+	{
+		deque = &self->deques[i];
+		pthread_mutex_lock(&deque->mutex);
+		count += cc_list_size(cc_workq_queue(self, deque,
+		                                     status));
+		pthread_mutex_unlock(&deque->mutex);
+	}
+
+	return count;
+}
+
+static void cc_workq_threadPriority(cc_workq_t* self)
+{
+	ASSERT(self);
 
 	// override the thread priority
 	if(self->thread_priority == CC_WORKQ_THREAD_PRIORITY_DEFAULT)
@@ -111,6 +552,15 @@ static void* cc_workq_thread(void* arg)
 		int priority = getpriority(PRIO_PROCESS, 0);
 		setpriority(PRIO_PROCESS, 0, priority+5);
 	}
+}
+
+static void* cc_workq_thread(void* arg)
+{
+	ASSERT(arg);
+
+	cc_workq_t* self = (cc_workq_t*) arg;
+
+	cc_workq_threadPriority(self);
 
 	pthread_mutex_lock(&self->mutex);
 
@@ -133,35 +583,335 @@ static void* cc_workq_thread(void* arg)
 			return NULL;
 		}
 
-		// get the task
+		// get the highest priority task
 		cc_listIter_t*  iter;
 		cc_workqNode_t* node;
-		iter = cc_list_head(self->queue_pending);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		node = cc_workqHeap_pop(&self->heap_pending);
+		iter = node->iter;
 		cc_list_swapn(self->queue_pending,
 		              self->queue_active, iter, NULL);
 		node->status = CC_WORKQ_STATUS_ACTIVE;
 
-		pthread_mutex_unlock(&self->mutex);
+		pthread_mutex_unlock(&self->mutex);
+
+		// run the task
+		int ret = (*self->run_fn)(tid, self->owner,
+		                          node->task);
+
+		pthread_mutex_lock(&self->mutex);
+
+		// put the task on the complete queue
+		node->status = ret ? CC_WORKQ_STATUS_COMPLETE :
+		                     CC_WORKQ_STATUS_FAILURE;
+		cc_list_swapn(self->queue_active,
+		              self->queue_complete, iter, NULL);
+		pthread_cond_broadcast(&self->cond_complete);
+	}
+}
+
+static int
+cc_workq_steal(cc_workq_t* self, cc_workqDeque_t* deque)
+{
+	ASSERT(self);
+	ASSERT(deque);
+
+	// steal half of the pending tasks from the first victim
+	// which has pending tasks starting with the neighbor
+	int idx = (int) (deque - self->deques);
+	int i;
+	for(i = 1; i < self->thread_count; ++i)
+	{
+		cc_workqDeque_t* victim;
+		victim = &self->deques[(idx + i)%self->thread_count];
+
+		// lock the deques in order to avoid deadlock
+		if(victim < deque)
+		{
+			pthread_mutex_lock(&victim->mutex);
+			pthread_mutex_lock(&deque->mutex);
+		}
+		else
+		{
+			pthread_mutex_lock(&deque->mutex);
+			pthread_mutex_lock(&victim->mutex);
+		}
+
+		// steal the highest priority tasks which are
+		// at the top of the victim pending heap
+		int count = (victim->heap_pending.count + 1)/2;
+		if(cc_workqHeap_reserve(&deque->heap_pending,
+		                        deque->heap_pending.count +
+		                        count) == 0)
+		{
+			count = 0;
+		}
+
+		int j;
+		for(j = 0; j < count; ++j)
+		{
+			cc_workqNode_t* node;
+			node = victim->heap_pending.nodes[0];
+			cc_workqHeap_remove(&victim->heap_pending, node);
+			cc_workqNode_setDeque(node, deque);
+			cc_list_swapn(victim->queue_pending,
+			              deque->queue_pending, node->iter,
+			              NULL);
+			cc_workqHeap_push(&deque->heap_pending, node);
+		}
+
+		pthread_mutex_unlock(&victim->mutex);
+		pthread_mutex_unlock(&deque->mutex);
+
+		if(count)
+		{
+			return count;
+		}
+	}
+
+	return 0;
+}
+
+static void cc_workq_idle(cc_workq_t* self)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex_idle);
+
+	// the idle count must be incremented before checking the
+	// deques so that cc_workq_run cannot miss the idle thread
+	__atomic_add_fetch(&self->idle, 1, __ATOMIC_SEQ_CST);
+
+	cc_workqDeque_t* deque;
+	int pending = 0;
+	int i;
+	for(i = 0; i < self->thread_count; ++i)
+	{
+		deque = &self->deques[i];
+		pthread_mutex_lock(&deque->mutex);
+		pending += cc_list_size(deque->queue_pending);
+		pthread_mutex_unlock(&deque->mutex);
+	}
+
+	if((pending == 0) &&
+	   (self->state == CC_WORKQ_STATE_RUNNING))
+	{
+		pthread_cond_wait(&self->cond_pending,
+		                  &self->mutex_idle);
+	}
+
+	__atomic_sub_fetch(&self->idle, 1, __ATOMIC_SEQ_CST);
+
+	pthread_mutex_unlock(&self->mutex_idle);
+}
+
+static void* cc_workq_threadSteal(void* arg)
+{
+	ASSERT(arg);
+
+	cc_workq_t* self = (cc_workq_t*) arg;
+
+	cc_workq_threadPriority(self);
+
+	// checkout the next available thread id
+	pthread_mutex_lock(&self->mutex);
+	int tid = self->next_tid++;
+	pthread_mutex_unlock(&self->mutex);
+
+	cc_workqDeque_t* deque = &self->deques[tid];
+	cc_listIter_t*   iter;
+	cc_workqNode_t*  node;
+	while(__atomic_load_n(&self->state, __ATOMIC_ACQUIRE) ==
+	      CC_WORKQ_STATE_RUNNING)
+	{
+		// get the highest priority task from the local deque
+		pthread_mutex_lock(&deque->mutex);
+		node = cc_workqHeap_pop(&deque->heap_pending);
+		if(node == NULL)
+		{
+			pthread_mutex_unlock(&deque->mutex);
+
+			// steal tasks or pending for an event
+			if(cc_workq_steal(self, deque) == 0)
+			{
+				cc_workq_idle(self);
+			}
+			continue;
+		}
+
+		// active tasks are never stolen
+		iter = node->iter;
+		cc_list_swapn(deque->queue_pending,
+		              deque->queue_active, iter, NULL);
+		node->status = CC_WORKQ_STATUS_ACTIVE;
+
+		pthread_mutex_unlock(&deque->mutex);
+
+		// run the task
+		int ret = (*self->run_fn)(tid, self->owner,
+		                          node->task);
+
+		pthread_mutex_lock(&deque->mutex);
+
+		// put the task on the complete queue
+		node->status = ret ? CC_WORKQ_STATUS_COMPLETE :
+		                     CC_WORKQ_STATUS_FAILURE;
+		cc_list_swapn(deque->queue_active,
+		              deque->queue_complete, iter, NULL);
+
+		pthread_mutex_unlock(&deque->mutex);
+
+		// waiters is incremented before the deque is checked
+		// so the broadcast cannot be missed
+		if(__atomic_load_n(&self->waiters, __ATOMIC_SEQ_CST))
+		{
+			pthread_mutex_lock(&self->mutex);
+			pthread_cond_broadcast(&self->cond_complete);
+			pthread_mutex_unlock(&self->mutex);
+		}
+	}
+
+	return NULL;
+}
+
+static void
+cc_workq_reprioritizeLocked(cc_workq_t* self,
+                            cc_workqDeque_t* deque,
+                            cc_workqNode_t* node,
+                            int priority)
+{
+	// deque may be NULL
+	ASSERT(self);
+	ASSERT(node);
+	ASSERT(node->status == CC_WORKQ_STATUS_PENDING);
+
+	if(priority == node->priority)
+	{
+		return;
+	}
+
+	// the reprioritized task runs after pending tasks which
+	// already have the same priority
+	node->priority = priority;
+	node->seq      = self->seq++;
+	cc_workqHeap_update(cc_workq_heap(self, deque), node);
+}
+
+static int
+cc_workq_runLocked(cc_workq_t* self, void* task,
+                   int priority, int* _wake)
+{
+	ASSERT(self);
+	ASSERT(task);
+	ASSERT(_wake);
+
+	int status = CC_WORKQ_STATUS_ERROR;
+
+	// find the node containing the task or create a new one
+	cc_listIter_t*   iter;
+	cc_mapIter_t*    miter;
+	cc_workqNode_t*  node;
+	cc_workqDeque_t* deque;
+	cc_workqHeap_t*  heap;
+	cc_list_t*       queue;
+	miter = cc_map_findp(self->map_task, 0, task);
+	if(miter == NULL)
+	{
+		// create new node
+		node = cc_workqNode_new(self->pool_node, task,
+		                        self->purge_id, priority,
+		                        self->seq++);
+		if(node == NULL)
+		{
+			goto fail_node;
+		}
+
+		// distribute new tasks across the deques
+		deque = NULL;
+		if(self->deques)
+		{
+			deque = &self->deques[self->next_deque];
+			self->next_deque = (self->next_deque + 1)%
+			                   self->thread_count;
+			node->deque = deque;
+			pthread_mutex_lock(&deque->mutex);
+		}
+		queue = cc_workq_queue(self, deque, node->status);
+		heap  = cc_workq_heap(self, deque);
+
+		// reserve the heap so the push cannot fail
+		if(cc_workqHeap_reserve(heap, heap->count + 1) == 0)
+		{
+			goto fail_queue;
+		}
+
+		// the pending list is unordered
+		iter = cc_list_append(queue, NULL, (const void*) node);
+		if(iter == NULL)
+		{
+			goto fail_queue;
+		}
+		node->iter = iter;
+
+		if(cc_map_addp(self->map_task, (const void*) iter,
+		               0, task) == NULL)
+		{
+			goto fail_map_add;
+		}
+
+		cc_workqHeap_push(heap, node);
+
+		status = node->status;
+
+		// wake up workq thread
+		*_wake += 1;
+	}
+	else
+	{
+		iter  = (cc_listIter_t*)  cc_map_val(miter);
+		node  = (cc_workqNode_t*) cc_list_peekIter(iter);
+		deque = cc_workq_lockNode(self, node);
+		queue = cc_workq_queue(self, deque, node->status);
+	}
+
+	if(node->status == CC_WORKQ_STATUS_ACTIVE)
+	{
+		node->purge_id = self->purge_id;
+		status = node->status;
+	}
+	else if(node->status == CC_WORKQ_STATUS_PENDING)
+	{
+		node->purge_id = self->purge_id;
+		cc_workq_reprioritizeLocked(self, deque, node,
+		                            priority);
+		status = node->status;
+	}
+	else
+	{
+		status = node->status;
+		cc_workq_removeLocked(self, 0, queue, &iter);
+	}
 
-		// run the task
-		int ret = (*self->run_fn)(tid, self->owner,
-		                          node->task);
+	cc_workq_unlockNode(deque);
 
-		pthread_mutex_lock(&self->mutex);
+	// success
+	return status;
 
-		// put the task on the complete queue
-		node->status = ret ? CC_WORKQ_STATUS_COMPLETE :
-		                     CC_WORKQ_STATUS_FAILURE;
-		cc_list_swapn(self->queue_active,
-		              self->queue_complete, iter, NULL);
-		pthread_cond_broadcast(&self->cond_complete);
-	}
+	// failure
+	fail_map_add:
+		cc_list_remove(queue, &iter);
+	fail_queue:
+		cc_workq_unlockNode(deque);
+		cc_workqNode_delete(self->pool_node, &node);
+	fail_node:
+	return CC_WORKQ_STATUS_ERROR;
 }
+
 static void cc_workq_flushLocked(cc_workq_t* self)
 {
 	ASSERT(self);
 
+	cc_workq_collectLocked(self);
+
 	cc_listIter_t* iter;
 	iter = cc_list_head(self->queue_complete);
 	while(iter)
@@ -171,15 +921,12 @@ static void cc_workq_flushLocked(cc_workq_t* self)
 	}
 }
 
-/***********************************************************
-* public                                                   *
-***********************************************************/
-
-cc_workq_t*
-cc_workq_new(void* owner, int thread_count,
-             int thread_priority,
-             cc_workqRun_fn run_fn,
-             cc_workqFinish_fn finish_fn)
+static cc_workq_t*
+cc_workq_newFlags(void* owner, int thread_count,
+                  int thread_priority,
+                  cc_workqRun_fn run_fn,
+                  cc_workqFinish_fn finish_fn,
+                  int flags)
 {
 	// owner may be NULL
 	ASSERT(run_fn);
@@ -201,6 +948,10 @@ cc_workq_new(void* owner, int thread_count,
 	self->next_tid        = 0;
 	self->run_fn          = run_fn;
 	self->finish_fn       = finish_fn;
+	self->deques          = NULL;
+	self->next_deque      = 0;
+	self->idle            = 0;
+	self->waiters         = 0;
 
 	// PTHREAD_MUTEX_DEFAULT is not re-entrant
 	if(pthread_mutex_init(&self->mutex, NULL) != 0)
@@ -209,6 +960,12 @@ cc_workq_new(void* owner, int thread_count,
 		goto fail_mutex_init;
 	}
 
+	if(pthread_mutex_init(&self->mutex_idle, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		goto fail_mutex_idle;
+	}
+
 	if(pthread_cond_init(&self->cond_pending, NULL) != 0)
 	{
 		LOGE("pthread_cond_init failed");
@@ -221,12 +978,22 @@ cc_workq_new(void* owner, int thread_count,
 		goto fail_cond_complete;
 	}
 
-	self->map_task = cc_map_new();
+	// nodes are allocated and freed with the mutex locked
+	self->pool_node = cc_pool_new(sizeof(cc_workqNode_t), 64);
+	if(self->pool_node == NULL)
+	{
+		goto fail_pool_node;
+	}
+
+	self->map_task = cc_map_newFlat();
 	if(self->map_task == NULL)
 	{
 		goto fail_map_task;
 	}
 
+	self->seq = 0;
+	cc_workqHeap_init(&self->heap_pending);
+
 	self->queue_pending = cc_list_new();
 	if(self->queue_pending == NULL)
 	{
@@ -245,6 +1012,28 @@ cc_workq_new(void* owner, int thread_count,
 		goto fail_queue_active;
 	}
 
+	// alloc deques
+	int d = 0;
+	if(flags & CC_WORKQ_FLAG_STEAL)
+	{
+		self->deques = (cc_workqDeque_t*)
+		               CALLOC(thread_count,
+		                      sizeof(cc_workqDeque_t));
+		if(self->deques == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_deques;
+		}
+
+		for(d = 0; d < thread_count; ++d)
+		{
+			if(cc_workqDeque_init(&self->deques[d]) == 0)
+			{
+				goto fail_deque_init;
+			}
+		}
+	}
+
 	// alloc threads
 	int sz = thread_count*sizeof(pthread_t);
 	self->threads = (pthread_t*) MALLOC(sz);
@@ -260,7 +1049,8 @@ cc_workq_new(void* owner, int thread_count,
 	for(i = 0; i < thread_count; ++i)
 	{
 		if(pthread_create(&(self->threads[i]), NULL,
-		                  cc_workq_thread,
+		                  self->deques ? cc_workq_threadSteal :
+		                                 cc_workq_thread,
 		                  (void*) self) != 0)
 		{
 			LOGE("pthread_create failed");
@@ -274,7 +1064,11 @@ cc_workq_new(void* owner, int thread_count,
 
 	// fail
 	fail_pthread_create:
-		self->state = CC_WORKQ_STATE_STOP;
+		pthread_mutex_lock(&self->mutex_idle);
+		__atomic_store_n(&self->state, CC_WORKQ_STATE_STOP,
+		                 __ATOMIC_RELEASE);
+		pthread_cond_broadcast(&self->cond_pending);
+		pthread_mutex_unlock(&self->mutex_idle);
 		pthread_mutex_unlock(&self->mutex);
 
 		int j;
@@ -284,24 +1078,74 @@ cc_workq_new(void* owner, int thread_count,
 		}
 		FREE(self->threads);
 	fail_threads:
+	fail_deque_init:
+		if(self->deques)
+		{
+			int k;
+			for(k = 0; k < d; ++k)
+			{
+				cc_workqDeque_destroy(&self->deques[k]);
+			}
+			FREE(self->deques);
+		}
+	fail_deques:
 		cc_list_delete(&self->queue_active);
 	fail_queue_active:
 		cc_list_delete(&self->queue_complete);
 	fail_queue_complete:
 		cc_list_delete(&self->queue_pending);
 	fail_queue_pending:
+		cc_workqHeap_destroy(&self->heap_pending);
 		cc_map_delete(&self->map_task);
 	fail_map_task:
+		cc_pool_delete(&self->pool_node);
+	fail_pool_node:
 		pthread_cond_destroy(&self->cond_complete);
 	fail_cond_complete:
 		pthread_cond_destroy(&self->cond_pending);
 	fail_cond_pending:
+		pthread_mutex_destroy(&self->mutex_idle);
+	fail_mutex_idle:
 		pthread_mutex_destroy(&self->mutex);
 	fail_mutex_init:
 		FREE(self);
 	return NULL;
 }
 
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_workq_t*
+cc_workq_new(void* owner, int thread_count,
+             int thread_priority,
+             cc_workqRun_fn run_fn,
+             cc_workqFinish_fn finish_fn)
+{
+	// owner may be NULL
+	ASSERT(run_fn);
+	ASSERT(finish_fn);
+
+	return cc_workq_newFlags(owner, thread_count,
+	                         thread_priority, run_fn,
+	                         finish_fn, 0);
+}
+
+cc_workq_t*
+cc_workq_newSteal(void* owner, int thread_count,
+                  int thread_priority,
+                  cc_workqRun_fn run_fn,
+                  cc_workqFinish_fn finish_fn)
+{
+	// owner may be NULL
+	ASSERT(run_fn);
+	ASSERT(finish_fn);
+
+	return cc_workq_newFlags(owner, thread_count,
+	                         thread_priority, run_fn,
+	                         finish_fn, CC_WORKQ_FLAG_STEAL);
+}
+
 void cc_workq_delete(cc_workq_t** _self)
 {
 	// *_self can be null
@@ -313,8 +1157,12 @@ void cc_workq_delete(cc_workq_t** _self)
 		pthread_mutex_lock(&self->mutex);
 
 		// stop the workq thread
-		self->state = CC_WORKQ_STATE_STOP;
+		// idle work-stealing threads wait with mutex_idle
+		pthread_mutex_lock(&self->mutex_idle);
+		__atomic_store_n(&self->state, CC_WORKQ_STATE_STOP,
+		                 __ATOMIC_RELEASE);
 		pthread_cond_broadcast(&self->cond_pending);
+		pthread_mutex_unlock(&self->mutex_idle);
 		pthread_mutex_unlock(&self->mutex);
 		int i;
 		for(i = 0; i < self->thread_count; ++i)
@@ -328,14 +1176,25 @@ void cc_workq_delete(cc_workq_t** _self)
 		// stopped
 		self->purge_id = CC_WORKQ_PURGE;
 		cc_workq_purge(self);
+		if(self->deques)
+		{
+			for(i = 0; i < self->thread_count; ++i)
+			{
+				cc_workqDeque_destroy(&self->deques[i]);
+			}
+			FREE(self->deques);
+		}
 		cc_list_delete(&self->queue_active);
 		cc_list_delete(&self->queue_complete);
 		cc_list_delete(&self->queue_pending);
+		cc_workqHeap_destroy(&self->heap_pending);
 		cc_map_delete(&self->map_task);
+		cc_pool_delete(&self->pool_node);
 
 		// destroy the thread state
 		pthread_cond_destroy(&self->cond_complete);
 		pthread_cond_destroy(&self->cond_pending);
+		pthread_mutex_destroy(&self->mutex_idle);
 		pthread_mutex_destroy(&self->mutex);
 
 		FREE(self);
@@ -359,12 +1218,15 @@ void cc_workq_reset(cc_workq_t* self, int blocking)
 	{
 		// blocking wait for the active queue
 		pthread_mutex_lock(&self->mutex);
-		while(cc_list_size(self->queue_active) > 0)
+		cc_workq_waiters(self, 1);
+		while(cc_workq_countLocked(self,
+		                           CC_WORKQ_STATUS_ACTIVE) > 0)
 		{
 			// must wait for active task to complete
 			pthread_cond_wait(&self->cond_complete,
 			                  &self->mutex);
 		}
+		cc_workq_waiters(self, -1);
 		pthread_mutex_unlock(&self->mutex);
 
 		// purge the complete queue
@@ -381,15 +1243,63 @@ void cc_workq_purge(cc_workq_t* self)
 
 	pthread_mutex_lock(&self->mutex);
 
+	cc_listIter_t*  iter;
+	cc_listIter_t*  next;
+	cc_workqNode_t* node;
+
+	// move the purged pending tasks and complete tasks from
+	// the deques to the workq queues and purge the deque
+	// active queues (non-blocking)
+	cc_workqDeque_t* deque;
+	int i;
+	for(i = 0; self->deques && (i < self->thread_count); ++i)
+	{
+		deque = &self->deques[i];
+		pthread_mutex_lock(&deque->mutex);
+
+		cc_workq_collectDequeLocked(self, deque);
+
+		iter = cc_list_head(deque->queue_pending);
+		while(iter)
+		{
+			next = cc_list_next(iter);
+			node = (cc_workqNode_t*) cc_list_peekIter(iter);
+			if(node->purge_id != self->purge_id)
+			{
+				cc_workqHeap_remove(&deque->heap_pending, node);
+				cc_workqNode_setDeque(node, NULL);
+				cc_list_swapn(deque->queue_pending,
+				              self->queue_pending, iter, NULL);
+			}
+			iter = next;
+		}
+
+		iter = cc_list_head(deque->queue_active);
+		while(iter)
+		{
+			node = (cc_workqNode_t*) cc_list_peekIter(iter);
+			if(node->purge_id != self->purge_id)
+			{
+				node->purge_id = CC_WORKQ_PURGE;
+			}
+			iter = cc_list_next(iter);
+		}
+
+		pthread_mutex_unlock(&deque->mutex);
+	}
+
 	// purge the pending queue
-	cc_listIter_t* iter;
+	// nodes purged from the deques are not held by the heap
 	iter = cc_list_head(self->queue_pending);
 	while(iter)
 	{
-		cc_workqNode_t* node;
 		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		if(node->purge_id != self->purge_id)
 		{
+			if(node->heap_index >= 0)
+			{
+				cc_workqHeap_remove(&self->heap_pending, node);
+			}
 			cc_workq_removeLocked(self, 1, self->queue_pending,
 			                      &iter);
 		}
@@ -403,7 +1313,6 @@ void cc_workq_purge(cc_workq_t* self)
 	iter = cc_list_head(self->queue_active);
 	while(iter)
 	{
-		cc_workqNode_t* node;
 		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		if(node->purge_id != self->purge_id)
 		{
@@ -416,7 +1325,6 @@ void cc_workq_purge(cc_workq_t* self)
 	iter = cc_list_head(self->queue_complete);
 	while(iter)
 	{
-		cc_workqNode_t* node;
 		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		if((node->purge_id != self->purge_id) ||
 		   (node->purge_id == CC_WORKQ_PURGE))
@@ -448,22 +1356,55 @@ void cc_workq_flush(cc_workq_t* self)
 	pthread_mutex_unlock(&self->mutex);
 }
 
+int cc_workq_drain(cc_workq_t* self, int count,
+                   void** tasks, int* status)
+{
+	ASSERT(self);
+	ASSERT(tasks);
+	ASSERT(status);
+
+	pthread_mutex_lock(&self->mutex);
+
+	cc_workq_collectLocked(self);
+
+	// remove the completed tasks without calling finish_fn
+	// so the caller may process them outside of the lock
+	int i = 0;
+	cc_listIter_t*  iter;
+	cc_workqNode_t* node;
+	iter = cc_list_head(self->queue_complete);
+	while(iter && (i < count))
+	{
+		node      = (cc_workqNode_t*) cc_list_peekIter(iter);
+		tasks[i]  = node->task;
+		status[i] = node->status;
+		cc_workq_removeLocked(self, 0, self->queue_complete,
+		                      &iter);
+		++i;
+	}
+
+	pthread_mutex_unlock(&self->mutex);
+
+	return i;
+}
+
 void cc_workq_finish(cc_workq_t* self)
 {
 	ASSERT(self);
 
 	pthread_mutex_lock(&self->mutex);
+	cc_workq_waiters(self, 1);
 
 	while(1)
 	{
-		if(cc_list_size(self->queue_complete))
-		{
-			// flush any tasks which have completed
-			cc_workq_flushLocked(self);
-		}
-
-		if(cc_list_size(self->queue_pending) ||
-		   cc_list_size(self->queue_active))
+		// flush any tasks which have completed
+		cc_workq_flushLocked(self);
+
+		// tasks which completed after the flush are counted
+		// since their broadcast is still pending
+		if(cc_workq_countLocked(self, CC_WORKQ_STATUS_PENDING) ||
+		   cc_workq_countLocked(self, CC_WORKQ_STATUS_ACTIVE)  ||
+		   cc_workq_countLocked(self, CC_WORKQ_STATUS_COMPLETE))
 		{
 			// wait for pending/active tasks to complete
 			pthread_cond_wait(&self->cond_complete,
@@ -475,6 +1416,7 @@ void cc_workq_finish(cc_workq_t* self)
 		}
 	}
 
+	cc_workq_waiters(self, -1);
 	pthread_mutex_unlock(&self->mutex);
 }
 
@@ -486,167 +1428,87 @@ int cc_workq_run(cc_workq_t* self, void* task,
 
 	pthread_mutex_lock(&self->mutex);
 
-	int status = CC_WORKQ_STATUS_ERROR;
+	int wake   = 0;
+	int status = cc_workq_runLocked(self, task, priority,
+	                                &wake);
+	cc_workq_wakeLocked(self, wake);
 
-	// find the node containing the task or create a new one
-	cc_listIter_t*  iter;
-	cc_mapIter_t*   miter;
-	cc_workqNode_t* node;
-	cc_listIter_t*  pos;
-	cc_workqNode_t* tmp;
-	miter = cc_map_findp(self->map_task, 0, task);
-	if(miter == NULL)
+	pthread_mutex_unlock(&self->mutex);
+
+	return status;
+}
+
+int cc_workq_runBatch(cc_workq_t* self, int count,
+                      void** tasks, const int* priority,
+                      int* status)
+{
+	// priority and status may be NULL
+	ASSERT(self);
+	ASSERT(tasks);
+
+	pthread_mutex_lock(&self->mutex);
+
+	// run each task under a single lock and wake the workq
+	// threads once for all new tasks
+	int ret  = 1;
+	int wake = 0;
+	int i;
+	int s;
+	for(i = 0; i < count; ++i)
 	{
-		// create new node
-		node = cc_workqNode_new(task, self->purge_id,
-		                        priority);
-		if(node == NULL)
+		s = cc_workq_runLocked(self, tasks[i],
+		                       priority ? priority[i] : 0,
+		                       &wake);
+		if(s == CC_WORKQ_STATUS_ERROR)
 		{
-			goto fail_node;
+			ret = 0;
 		}
 
-		// find the insert position
-		pos = cc_list_tail(self->queue_pending);
-		while(pos)
+		if(status)
 		{
-			tmp = (cc_workqNode_t*)
-			      cc_list_peekIter(pos);
-			if(tmp->priority >= node->priority)
-			{
-				break;
-			}
-			pos = cc_list_prev(pos);
+			status[i] = s;
 		}
+	}
+	cc_workq_wakeLocked(self, wake);
 
-		if(pos)
-		{
-			// append after pos
-			iter = cc_list_append(self->queue_pending, pos,
-			                      (const void*) node);
-			if(iter == NULL)
-			{
-				goto fail_queue;
-			}
-		}
-		else
-		{
-			// insert at head of queue
-			// first item or highest priority
-			iter = cc_list_insert(self->queue_pending, NULL,
-			                      (const void*) node);
-			if(iter == NULL)
-			{
-				goto fail_queue;
-			}
-		}
+	pthread_mutex_unlock(&self->mutex);
 
-		if(cc_map_addp(self->map_task, (const void*) iter,
-		               0, task) == NULL)
-		{
-			goto fail_map_add;
-		}
+	return ret;
+}
 
-		status = node->status;
+int cc_workq_reprioritize(cc_workq_t* self, void* task,
+                          int priority)
+{
+	ASSERT(self);
+	ASSERT(task);
 
-		// wake up workq thread
-		pthread_cond_broadcast(&self->cond_pending);
-	}
-	else
-	{
-		iter = (cc_listIter_t*)  cc_map_val(miter);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
-	}
+	int status = CC_WORKQ_STATUS_ERROR;
 
-	if(node->status == CC_WORKQ_STATUS_ACTIVE)
-	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
-		node->purge_id = self->purge_id;
-		status = node->status;
-	}
-	else if(node->status == CC_WORKQ_STATUS_PENDING)
-	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
-		node->purge_id = self->purge_id;
-		if(priority > node->priority)
-		{
-			// move up
-			pos = cc_list_prev(iter);
-			while(pos)
-			{
-				tmp = (cc_workqNode_t*)
-				      cc_list_peekIter(pos);
-				if(tmp->priority >= node->priority)
-				{
-					break;
-				}
-				pos = cc_list_prev(pos);
-			}
+	pthread_mutex_lock(&self->mutex);
 
-			if(pos)
-			{
-				// move after pos
-				cc_list_moven(self->queue_pending, iter,
-				              pos);
-			}
-			else
-			{
-				// move to head of list
-				cc_list_move(self->queue_pending, iter,
-				             NULL);
-			}
-		}
-		else if(priority < node->priority)
+	// find task in map
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self->map_task, 0, task);
+	if(miter)
+	{
+		// unlike cc_workq_run the purge_id is unchanged
+		cc_listIter_t*   iter;
+		cc_workqNode_t*  node;
+		cc_workqDeque_t* deque;
+		iter  = (cc_listIter_t*)  cc_map_val(miter);
+		node  = (cc_workqNode_t*) cc_list_peekIter(iter);
+		deque = cc_workq_lockNode(self, node);
+		if(node->status == CC_WORKQ_STATUS_PENDING)
 		{
-			// move down
-			pos = cc_list_next(iter);
-			while(pos)
-			{
-				tmp = (cc_workqNode_t*)
-				      cc_list_peekIter(pos);
-				if(tmp->priority < node->priority)
-				{
-					break;
-				}
-				pos = cc_list_next(pos);
-			}
-
-			if(pos)
-			{
-				// move before pos
-				cc_list_move(self->queue_pending, iter,
-				             pos);
-			}
-			else
-			{
-				// move to tail of list
-				cc_list_moven(self->queue_pending, iter,
-				              NULL);
-			}
+			cc_workq_reprioritizeLocked(self, deque, node,
+			                            priority);
 		}
-		node->priority = priority;
-		status = node->status;
-	}
-	else
-	{
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
 		status = node->status;
-		cc_workq_removeLocked(self, 0, self->queue_complete,
-		                      &iter);
+		cc_workq_unlockNode(deque);
 	}
 
 	pthread_mutex_unlock(&self->mutex);
-
-	// success
 	return status;
-
-	// failure
-	fail_map_add:
-		cc_list_remove(self->queue_pending, &iter);
-	fail_queue:
-		cc_workqNode_delete(&node);
-	fail_node:
-		pthread_mutex_unlock(&self->mutex);
-	return CC_WORKQ_STATUS_ERROR;
 }
 
 int cc_workq_wait(cc_workq_t* self, void* task,
@@ -670,27 +1532,39 @@ int cc_workq_wait(cc_workq_t* self, void* task,
 	}
 	iter = (cc_listIter_t*) cc_map_val(miter);
 
-	cc_workqNode_t* node;
-	node = (cc_workqNode_t*) cc_list_peekIter(iter);
+	cc_workq_waiters(self, 1);
+
+	cc_workqNode_t*  node;
+	cc_workqDeque_t* deque;
+	node  = (cc_workqNode_t*) cc_list_peekIter(iter);
+	deque = cc_workq_lockNode(self, node);
 	while((node->status == CC_WORKQ_STATUS_PENDING) ||
 	      (node->status == CC_WORKQ_STATUS_ACTIVE))
 	{
 		if(blocking == 0)
 		{
+			status = node->status;
+			cc_workq_unlockNode(deque);
+			cc_workq_waiters(self, -1);
 			pthread_mutex_unlock(&self->mutex);
-			return node->status;
+			return status;
 		}
 
 		// must wait for pending/active task to complete
+		cc_workq_unlockNode(deque);
 		pthread_cond_wait(&self->cond_complete, &self->mutex);
+		deque = cc_workq_lockNode(self, node);
 	}
 
 	status = node->status;
 
 	// cancel completed task
-	cc_workq_removeLocked(self, 0, self->queue_complete,
+	cc_workq_removeLocked(self, 0,
+	                      cc_workq_queue(self, deque, status),
 	                      &iter);
 
+	cc_workq_unlockNode(deque);
+	cc_workq_waiters(self, -1);
 	pthread_mutex_unlock(&self->mutex);
 	return status;
 }
@@ -716,34 +1590,41 @@ int cc_workq_cancel(cc_workq_t* self, void* task,
 	}
 	iter = (cc_listIter_t*) cc_map_val(miter);
 
-	cc_workqNode_t* node;
-	node = (cc_workqNode_t*) cc_list_peekIter(iter);
+	cc_workq_waiters(self, 1);
+
+	cc_workqNode_t*  node;
+	cc_workqDeque_t* deque;
+	node  = (cc_workqNode_t*) cc_list_peekIter(iter);
+	deque = cc_workq_lockNode(self, node);
 	while(node->status == CC_WORKQ_STATUS_ACTIVE)
 	{
 		if(blocking == 0)
 		{
+			status = node->status;
+			cc_workq_unlockNode(deque);
+			cc_workq_waiters(self, -1);
 			pthread_mutex_unlock(&self->mutex);
-			return node->status;
+			return status;
 		}
 
 		// must wait for active task to complete
+		cc_workq_unlockNode(deque);
 		pthread_cond_wait(&self->cond_complete, &self->mutex);
+		deque = cc_workq_lockNode(self, node);
 	}
 
+	// cancel pending or completed task
 	status = node->status;
 	if(status == CC_WORKQ_STATUS_PENDING)
 	{
-		// cancel pending task
-		cc_workq_removeLocked(self, 0, self->queue_pending,
-		                      &iter);
-	}
-	else
-	{
-		// cancel completed task
-		cc_workq_removeLocked(self, 0, self->queue_complete,
-		                      &iter);
+		cc_workqHeap_remove(cc_workq_heap(self, deque), node);
 	}
+	cc_workq_removeLocked(self, 0,
+	                      cc_workq_queue(self, deque, status),
+	                      &iter);
 
+	cc_workq_unlockNode(deque);
+	cc_workq_waiters(self, -1);
 	pthread_mutex_unlock(&self->mutex);
 	return status;
 }
@@ -762,10 +1643,13 @@ int cc_workq_status(cc_workq_t* self, void* task)
 	miter = cc_map_findp(self->map_task, 0, task);
 	if(miter)
 	{
-		cc_workqNode_t* node;
-		iter = (cc_listIter_t*)  cc_map_val(miter);
-		node = (cc_workqNode_t*) cc_list_peekIter(iter);
+		cc_workqNode_t*  node;
+		cc_workqDeque_t* deque;
+		iter   = (cc_listIter_t*)  cc_map_val(miter);
+		node   = (cc_workqNode_t*) cc_list_peekIter(iter);
+		deque  = cc_workq_lockNode(self, node);
 		status = node->status;
+		cc_workq_unlockNode(deque);
 	}
 
 	pthread_mutex_unlock(&self->mutex);
@@ -778,8 +1662,8 @@ int cc_workq_pending(cc_workq_t* self)
 
 	int size;
 	pthread_mutex_lock(&self->mutex);
-	size = cc_list_size(self->queue_pending);
-	size += cc_list_size(self->queue_active);
+	size = cc_workq_countLocked(self, CC_WORKQ_STATUS_PENDING);
+	size += cc_workq_countLocked(self, CC_WORKQ_STATUS_ACTIVE);
 	pthread_mutex_unlock(&self->mutex);
 	return size;
 }
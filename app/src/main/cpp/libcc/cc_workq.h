@@ -25,9 +25,11 @@
 #define cc_workq_H
 
 #include <pthread.h>
+#include <stdint.h>
 
 #include "cc_list.h"
 #include "cc_map.h"
+#include "cc_pool.h"
 
 // workq status
 #define CC_WORKQ_STATUS_ERROR    0
@@ -50,14 +52,47 @@ typedef void (*cc_workqFinish_fn)(void* owner,
                                   void* task,
                                   int status);
 
+typedef struct cc_workqDeque_s cc_workqDeque_t;
+
 typedef struct
 {
-	int   status;
-	int   priority;
-	int   purge_id;
-	void* task;
+	int      status;
+	int      priority;
+	int      purge_id;
+	void*    task;
+	uint64_t seq;
+
+	// position in the pending queue list and heap
+	// heap_index is -1 unless the node is held by a heap
+	cc_listIter_t* iter;
+	int            heap_index;
+
+	// work-stealing deque which holds the node or NULL when
+	// the node is held by the workq queues
+	cc_workqDeque_t* deque;
 } cc_workqNode_t;
 
+// binary max-heap of pending nodes ordered by priority
+// and then by seq so equal priorities run in FIFO order
+typedef struct
+{
+	int              count;
+	int              capacity;
+	cc_workqNode_t** nodes;
+} cc_workqHeap_t;
+
+// work-stealing deque (one per thread)
+// the deque mutex protects the deque queues and the status
+// of nodes held by the deque
+typedef struct cc_workqDeque_s
+{
+	pthread_mutex_t mutex;
+	cc_workqHeap_t  heap_pending;
+	cc_list_t*      queue_pending;
+	cc_list_t*      queue_active;
+	cc_list_t*      queue_complete;
+} cc_workqDeque_t;
+
 typedef struct
 {
 	// queue state
@@ -68,10 +103,17 @@ typedef struct
 	// maps from task to listIter
 	cc_map_t* map_task;
 
+	// node allocator
+	cc_pool_t* pool_node;
+
 	// queues
-	cc_list_t* queue_pending;
-	cc_list_t* queue_complete;
-	cc_list_t* queue_active;
+	// the pending queue list holds the nodes while the heap
+	// determines the order in which they are run
+	uint64_t       seq;
+	cc_workqHeap_t heap_pending;
+	cc_list_t*     queue_pending;
+	cc_list_t*     queue_complete;
+	cc_list_t*     queue_active;
 
 	// callbacks
 	cc_workqRun_fn    run_fn;
@@ -85,19 +127,40 @@ typedef struct
 	pthread_mutex_t mutex;
 	pthread_cond_t  cond_pending;
 	pthread_cond_t  cond_complete;
+
+	// work-stealing state
+	// deques is NULL unless created by cc_workq_newSteal
+	// idle threads wait on cond_pending with mutex_idle
+	cc_workqDeque_t* deques;
+	int              next_deque;
+	int              idle;
+	int              waiters;
+	pthread_mutex_t  mutex_idle;
 } cc_workq_t;
 
 cc_workq_t* cc_workq_new(void* owner, int thread_count,
                          int thread_priority,
                          cc_workqRun_fn run_fn,
                          cc_workqFinish_fn finish_fn);
+cc_workq_t* cc_workq_newSteal(void* owner, int thread_count,
+                              int thread_priority,
+                              cc_workqRun_fn run_fn,
+                              cc_workqFinish_fn finish_fn);
 void        cc_workq_delete(cc_workq_t** _self);
 void        cc_workq_reset(cc_workq_t* self, int blocking);
 void        cc_workq_purge(cc_workq_t* self);
 void        cc_workq_flush(cc_workq_t* self);
+int         cc_workq_drain(cc_workq_t* self, int count,
+                           void** tasks, int* status);
 void        cc_workq_finish(cc_workq_t* self);
 int         cc_workq_run(cc_workq_t* self, void* task,
                          int priority);
+int         cc_workq_runBatch(cc_workq_t* self, int count,
+                              void** tasks,
+                              const int* priority,
+                              int* status);
+int         cc_workq_reprioritize(cc_workq_t* self,
+                                  void* task, int priority);
 int         cc_workq_wait(cc_workq_t* self, void* task,
                           int blocking);
 int         cc_workq_cancel(cc_workq_t* self, void* task,
@@ -26,6 +26,7 @@
 #define LOG_TAG "cc"
 #include "../cc_log.h"
 #include "cc_doubleSingle.h"
+#include "cc_simd.h"
 
 /***********************************************************
 * public                                                   *
@@ -58,7 +59,7 @@ void cc_doubleSingle_add(cc_vec2f_t* a,
 	ASSERT(c);
 
 	float t1 = a->x + b->x;
-	float e  = t1 + a->x;
+	float e  = t1 - a->x;
 	float t2 = ((b->x - e) + (a->x - (t1 - e))) + a->y + b->y;
 
 	c->x = t1 + t2;
@@ -81,11 +82,11 @@ void cc_doubleSingle_mul(cc_vec2f_t* a,
 	float b1   = conb - (conb - b->x);
 	float a2   = a->x - a1;
 	float b2   = b->x - b1;
-	float c11  = a->x - b->x;
+	float c11  = a->x*b->x;
 	float c21  = a2*b2 + (a2*b1 + (a1*b2 + (a1*b1 - c11)));
 	float c2   = a->x*b->y + a->y*b->x;
 	float t1   = c11 + c2;
-	float e    = t1 + c11;
+	float e    = t1 - c11;
 	float t2   = a->y*b->y + ((c2 - e) + (c11 - (t1 - e))) + c21;
 
 	c->x = t1 + t2;
@@ -144,9 +145,9 @@ void cc_doubleSingle_add3(cc_vec3f_t* aH,
 
 	cc_vec3f_t e =
 	{
-		.x = t1.x + aH->x,
-		.y = t1.y + aH->y,
-		.z = t1.z + aH->z,
+		.x = t1.x - aH->x,
+		.y = t1.y - aH->y,
+		.z = t1.z - aH->z,
 	};
 
 	cc_vec3f_t t2 =
@@ -230,9 +231,9 @@ void cc_doubleSingle_mul3(cc_vec3f_t* aH,
 
 	cc_vec3f_t c11 =
 	{
-		.x = aH->x - bH->x,
-		.y = aH->y - bH->y,
-		.z = aH->z - bH->z,
+		.x = aH->x*bH->x,
+		.y = aH->y*bH->y,
+		.z = aH->z*bH->z,
 	};
 
 	cc_vec3f_t c21 =
@@ -258,9 +259,9 @@ void cc_doubleSingle_mul3(cc_vec3f_t* aH,
 
 	cc_vec3f_t e =
 	{
-		.x = t1.x + c11.x,
-		.y = t1.y + c11.y,
-		.z = t1.z + c11.z,
+		.x = t1.x - c11.x,
+		.y = t1.y - c11.y,
+		.z = t1.z - c11.z,
 	};
 
 	cc_vec3f_t t2 =
@@ -277,3 +278,115 @@ void cc_doubleSingle_mul3(cc_vec3f_t* aH,
 	cL->y = t2.y - (cH->y - t1.y);
 	cL->z = t2.z - (cH->z - t1.z);
 }
+
+void cc_doubleSingle_set3Array(int count,
+                               const cc_vec3d_t* in,
+                               cc_vec3f_t* high,
+                               cc_vec3f_t* low)
+{
+	ASSERT(in || (count == 0));
+	ASSERT(high || (count == 0));
+	ASSERT(low || (count == 0));
+
+	// the vertices are processed as flat arrays which the
+	// compiler may vectorize with packed conversions
+	const double* d = (const double*) in;
+	float*        h = (float*) high;
+	float*        l = (float*) low;
+
+	int i;
+	for(i = 0; i < 3*count; ++i)
+	{
+		h[i] = (float) d[i];
+		l[i] = (float) (d[i] - ((double) h[i]));
+	}
+}
+
+void cc_doubleSingle_rte3Array(int count,
+                               const cc_vec3f_t* high,
+                               const cc_vec3f_t* low,
+                               const cc_vec3d_t* eye,
+                               cc_vec3f_t* out)
+{
+	ASSERT(high || (count == 0));
+	ASSERT(low || (count == 0));
+	ASSERT(eye);
+	ASSERT(out || (count == 0));
+
+	cc_vec3f_t eyeH;
+	cc_vec3f_t eyeL;
+	cc_doubleSingle_set3((cc_vec3d_t*) eye, &eyeH, &eyeL);
+
+	// the eye components repeat with a period of 3 across
+	// the flat vertex arrays so 12 floats (4 vertices) are
+	// processed per SIMD block
+	float eh[12] =
+	{
+		eyeH.x, eyeH.y, eyeH.z, eyeH.x,
+		eyeH.y, eyeH.z, eyeH.x, eyeH.y,
+		eyeH.z, eyeH.x, eyeH.y, eyeH.z,
+	};
+
+	float el[12] =
+	{
+		eyeL.x, eyeL.y, eyeL.z, eyeL.x,
+		eyeL.y, eyeL.z, eyeL.x, eyeL.y,
+		eyeL.z, eyeL.x, eyeL.y, eyeL.z,
+	};
+
+	const float* h = (const float*) high;
+	const float* l = (const float*) low;
+	float*       o = (float*) out;
+	int          n = 3*count;
+
+	// t1 + t2 = (h - eh) + (l - el) using the two-sum of
+	// h and -eh
+	int i = 0;
+	#ifdef CC_SIMD
+	int          j;
+	cc_simd4f_t  veh[3];
+	cc_simd4f_t  vel[3];
+	cc_simd4f_t  vh;
+	cc_simd4f_t  t1;
+	cc_simd4f_t  t2;
+	cc_simd4f_t  e;
+	for(j = 0; j < 3; ++j)
+	{
+		veh[j] = CC_SIMD_LOAD(&eh[4*j]);
+		vel[j] = CC_SIMD_LOAD(&el[4*j]);
+	}
+
+	for(; i + 12 <= n; i += 12)
+	{
+		for(j = 0; j < 3; ++j)
+		{
+			vh = CC_SIMD_LOAD(&h[i + 4*j]);
+			t1 = CC_SIMD_SUB(vh, veh[j]);
+			e  = CC_SIMD_SUB(t1, vh);
+			t2 = CC_SIMD_SUB(CC_SIMD_SUB(vh, CC_SIMD_SUB(t1, e)),
+			                 CC_SIMD_ADD(veh[j], e));
+			t2 = CC_SIMD_ADD(t2,
+			                 CC_SIMD_SUB(CC_SIMD_LOAD(&l[i + 4*j]),
+			                             vel[j]));
+			CC_SIMD_STORE(&o[i + 4*j], CC_SIMD_ADD(t1, t2));
+		}
+	}
+	#endif
+
+	// i is a multiple of 3 so k selects the eye component
+	int   k;
+	float t1s;
+	float t2s;
+	float es;
+	for(; i < n; i += 3)
+	{
+		for(k = 0; k < 3; ++k)
+		{
+			t1s = h[i + k] - eh[k];
+			es  = t1s - h[i + k];
+			t2s = (h[i + k] - (t1s - es)) - (eh[k] + es);
+			t2s = t2s + (l[i + k] - el[k]);
+			o[i + k] = t1s + t2s;
+		}
+	}
+}
@@ -60,4 +60,18 @@ void cc_doubleSingle_mul3(cc_vec3f_t* aH,
                           cc_vec3f_t* cH,
                           cc_vec3f_t* cL);
 
+// array operations
+// rte3Array computes the relative-to-eye positions
+// out = (high + low) - eye of count vertices where the
+// difference is evaluated in double-single precision
+void cc_doubleSingle_set3Array(int count,
+                               const cc_vec3d_t* in,
+                               cc_vec3f_t* high,
+                               cc_vec3f_t* low);
+void cc_doubleSingle_rte3Array(int count,
+                               const cc_vec3f_t* high,
+                               const cc_vec3f_t* low,
+                               const cc_vec3d_t* eye,
+                               cc_vec3f_t* out);
+
 #endif
@@ -21,9 +21,56 @@
  *
  */
 
+#include <math.h>
+#include <string.h>
+
 #define LOG_TAG "cc"
 #include "../cc_log.h"
 #include "cc_fplane.h"
+#include "cc_simd.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// plane a*x + b*y + c*z + w >= 0 from the rows of an MVP
+static void
+cc_fplane_loadPlane(cc_plane_t* self,
+                    float a, float b, float c, float w)
+{
+	ASSERT(self);
+
+	float s = 1.0f/sqrtf(a*a + b*b + c*c);
+	cc_plane_load(self, s*a, s*b, s*c, -s*w);
+}
+
+static void
+cc_fplane_planes(const cc_fplane_t* self,
+                 const cc_plane_t** planes)
+{
+	ASSERT(self);
+	ASSERT(planes);
+
+	planes[0] = &self->near;
+	planes[1] = &self->farx;
+	planes[2] = &self->left;
+	planes[3] = &self->right;
+	planes[4] = &self->top;
+	planes[5] = &self->bottom;
+}
+
+static int cc_fplane_count(int count, uint32_t* mask)
+{
+	ASSERT(mask || (count == 0));
+
+	int i;
+	int visible = 0;
+	for(i = 0; i < (count + 31)/32; ++i)
+	{
+		visible += __builtin_popcount(mask[i]);
+	}
+	return visible;
+}
 
 /***********************************************************
 * public                                                   *
@@ -66,3 +113,178 @@ int cc_fplane_clippoint(const cc_fplane_t* self,
 
 	return 0;
 }
+
+void cc_fplane_load(cc_fplane_t* self,
+                    const cc_mat4f_t* mvp)
+{
+	ASSERT(self);
+	ASSERT(mvp);
+
+	// Gribb/Hartmann plane extraction where the names of the
+	// planes refer to clip space
+	// the near plane assumes a depth range of [-w,w] which is
+	// conservative for Vulkan projections with [0,w]
+	const cc_mat4f_t* m = mvp;
+	cc_fplane_loadPlane(&self->near,
+	                    m->m30 + m->m20, m->m31 + m->m21,
+	                    m->m32 + m->m22, m->m33 + m->m23);
+	cc_fplane_loadPlane(&self->farx,
+	                    m->m30 - m->m20, m->m31 - m->m21,
+	                    m->m32 - m->m22, m->m33 - m->m23);
+	cc_fplane_loadPlane(&self->left,
+	                    m->m30 + m->m00, m->m31 + m->m01,
+	                    m->m32 + m->m02, m->m33 + m->m03);
+	cc_fplane_loadPlane(&self->right,
+	                    m->m30 - m->m00, m->m31 - m->m01,
+	                    m->m32 - m->m02, m->m33 - m->m03);
+	cc_fplane_loadPlane(&self->top,
+	                    m->m30 - m->m10, m->m31 - m->m11,
+	                    m->m32 - m->m12, m->m33 - m->m13);
+	cc_fplane_loadPlane(&self->bottom,
+	                    m->m30 + m->m10, m->m31 + m->m11,
+	                    m->m32 + m->m12, m->m33 + m->m13);
+}
+
+int cc_fplane_visiblespheres(const cc_fplane_t* self,
+                             const cc_vec3fArray_t* c,
+                             const float* r,
+                             uint32_t* mask)
+{
+	ASSERT(self);
+	ASSERT(c);
+	ASSERT(r || (c->count == 0));
+	ASSERT(mask || (c->count == 0));
+
+	int count = c->count;
+	memset(mask, 0, ((count + 31)/32)*sizeof(uint32_t));
+
+	// a sphere is clipped when it is completely outside
+	// of any plane
+	const cc_plane_t* planes[6];
+	cc_fplane_planes(self, planes);
+
+	int i = 0;
+	int j;
+	int clip;
+	const cc_plane_t* p;
+	#ifdef CC_SIMD
+	cc_simd4f_t zero = CC_SIMD_SPLAT(0.0f);
+	cc_simd4f_t cx;
+	cc_simd4f_t cy;
+	cc_simd4f_t cz;
+	cc_simd4f_t cr;
+	cc_simd4f_t d;
+	for(; i + 4 <= count; i += 4)
+	{
+		cx   = CC_SIMD_LOAD(&c->x[i]);
+		cy   = CC_SIMD_LOAD(&c->y[i]);
+		cz   = CC_SIMD_LOAD(&c->z[i]);
+		cr   = CC_SIMD_LOAD(&r[i]);
+		clip = 0;
+		for(j = 0; j < 6; ++j)
+		{
+			p = planes[j];
+			d = CC_SIMD_SUB(cr, CC_SIMD_SPLAT(p->d));
+			d = CC_SIMD_MADD(d, cx, CC_SIMD_SPLAT(p->n.x));
+			d = CC_SIMD_MADD(d, cy, CC_SIMD_SPLAT(p->n.y));
+			d = CC_SIMD_MADD(d, cz, CC_SIMD_SPLAT(p->n.z));
+			clip |= CC_SIMD_LTMASK(d, zero);
+		}
+		mask[i >> 5] |= ((uint32_t) (~clip & 0xF)) << (i & 31);
+	}
+	#endif
+
+	float dist;
+	for(; i < count; ++i)
+	{
+		clip = 0;
+		for(j = 0; j < 6; ++j)
+		{
+			p    = planes[j];
+			dist = p->n.x*c->x[i] + p->n.y*c->y[i] +
+			       p->n.z*c->z[i] - p->d + r[i];
+			clip |= (dist < 0.0f);
+		}
+		if(clip == 0)
+		{
+			mask[i >> 5] |= ((uint32_t) 1) << (i & 31);
+		}
+	}
+
+	return cc_fplane_count(count, mask);
+}
+
+int cc_fplane_visibleboxes(const cc_fplane_t* self,
+                           const cc_vec3fArray_t* min,
+                           const cc_vec3fArray_t* max,
+                           uint32_t* mask)
+{
+	ASSERT(self);
+	ASSERT(min);
+	ASSERT(max);
+	ASSERT(min->count == max->count);
+	ASSERT(mask || (min->count == 0));
+
+	int count = min->count;
+	memset(mask, 0, ((count + 31)/32)*sizeof(uint32_t));
+
+	// a box is clipped when the corner furthest along the
+	// plane normal is outside of any plane
+	const cc_plane_t* planes[6];
+	cc_fplane_planes(self, planes);
+	const float*      px[6];
+	const float*      py[6];
+	const float*      pz[6];
+
+	int j;
+	for(j = 0; j < 6; ++j)
+	{
+		px[j] = (planes[j]->n.x >= 0.0f) ? max->x : min->x;
+		py[j] = (planes[j]->n.y >= 0.0f) ? max->y : min->y;
+		pz[j] = (planes[j]->n.z >= 0.0f) ? max->z : min->z;
+	}
+
+	int i = 0;
+	int clip;
+	const cc_plane_t* p;
+	#ifdef CC_SIMD
+	cc_simd4f_t zero = CC_SIMD_SPLAT(0.0f);
+	cc_simd4f_t d;
+	for(; i + 4 <= count; i += 4)
+	{
+		clip = 0;
+		for(j = 0; j < 6; ++j)
+		{
+			p = planes[j];
+			d = CC_SIMD_SPLAT(-p->d);
+			d = CC_SIMD_MADD(d, CC_SIMD_LOAD(&px[j][i]),
+			                 CC_SIMD_SPLAT(p->n.x));
+			d = CC_SIMD_MADD(d, CC_SIMD_LOAD(&py[j][i]),
+			                 CC_SIMD_SPLAT(p->n.y));
+			d = CC_SIMD_MADD(d, CC_SIMD_LOAD(&pz[j][i]),
+			                 CC_SIMD_SPLAT(p->n.z));
+			clip |= CC_SIMD_LTMASK(d, zero);
+		}
+		mask[i >> 5] |= ((uint32_t) (~clip & 0xF)) << (i & 31);
+	}
+	#endif
+
+	float dist;
+	for(; i < count; ++i)
+	{
+		clip = 0;
+		for(j = 0; j < 6; ++j)
+		{
+			p    = planes[j];
+			dist = p->n.x*px[j][i] + p->n.y*py[j][i] +
+			       p->n.z*pz[j][i] - p->d;
+			clip |= (dist < 0.0f);
+		}
+		if(clip == 0)
+		{
+			mask[i >> 5] |= ((uint32_t) 1) << (i & 31);
+		}
+	}
+
+	return cc_fplane_count(count, mask);
+}
@@ -24,7 +24,11 @@
 #ifndef cc_fplane_H
 #define cc_fplane_H
 
+#include <stdint.h>
+
+#include "cc_mat4f.h"
 #include "cc_plane.h"
+#include "cc_vec3fArray.h"
 
 typedef struct
 {
@@ -41,4 +45,22 @@ int cc_fplane_clipsphere(const cc_fplane_t* self,
 int cc_fplane_clippoint(const cc_fplane_t* self,
                         const cc_vec3f_t* pt);
 
+// extract the frustum planes from an MVP matrix
+void cc_fplane_load(cc_fplane_t* self,
+                    const cc_mat4f_t* mvp);
+
+// batch culling
+// unlike the clip functions which return 1 when clipped
+// the visible functions set bit i of the mask (of
+// (count + 31)/32 words) when element i is not clipped and
+// return the number of visible elements
+int cc_fplane_visiblespheres(const cc_fplane_t* self,
+                             const cc_vec3fArray_t* c,
+                             const float* r,
+                             uint32_t* mask);
+int cc_fplane_visibleboxes(const cc_fplane_t* self,
+                           const cc_vec3fArray_t* min,
+                           const cc_vec3fArray_t* max,
+                           uint32_t* mask);
+
 #endif
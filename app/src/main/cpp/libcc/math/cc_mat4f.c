@@ -27,11 +27,67 @@
 #define LOG_TAG "cc"
 #include "../cc_log.h"
 #include "cc_mat4f.h"
+#include "cc_simd.h"
 
 /***********************************************************
 * private                                                  *
 ***********************************************************/
 
+#ifdef CC_SIMD
+
+// c = a*v where a is given by its columns
+static inline cc_simd4f_t
+cc_mat4f_mulvCols(const cc_simd4f_t* a, const float* v)
+{
+	ASSERT(a);
+	ASSERT(v);
+
+	cc_simd4f_t c;
+	c = CC_SIMD_MUL(a[0], CC_SIMD_SPLAT(v[0]));
+	c = CC_SIMD_MADD(c, a[1], CC_SIMD_SPLAT(v[1]));
+	c = CC_SIMD_MADD(c, a[2], CC_SIMD_SPLAT(v[2]));
+	c = CC_SIMD_MADD(c, a[3], CC_SIMD_SPLAT(v[3]));
+	return c;
+}
+
+static inline void
+cc_mat4f_loadCols(const cc_mat4f_t* self, cc_simd4f_t* a)
+{
+	ASSERT(self);
+	ASSERT(a);
+
+	const float* p = (const float*) self;
+	a[0] = CC_SIMD_LOAD(&p[0]);
+	a[1] = CC_SIMD_LOAD(&p[4]);
+	a[2] = CC_SIMD_LOAD(&p[8]);
+	a[3] = CC_SIMD_LOAD(&p[12]);
+}
+
+// c = a*m where the columns of m are loaded before the
+// columns of c are stored so m may alias c
+static inline void
+cc_mat4f_mulmCols(const cc_simd4f_t* a,
+                  const cc_mat4f_t* m, cc_mat4f_t* copy)
+{
+	ASSERT(a);
+	ASSERT(m);
+	ASSERT(copy);
+
+	const float* mp = (const float*) m;
+	float*       cp = (float*) copy;
+
+	cc_simd4f_t c0 = cc_mat4f_mulvCols(a, &mp[0]);
+	cc_simd4f_t c1 = cc_mat4f_mulvCols(a, &mp[4]);
+	cc_simd4f_t c2 = cc_mat4f_mulvCols(a, &mp[8]);
+	cc_simd4f_t c3 = cc_mat4f_mulvCols(a, &mp[12]);
+	CC_SIMD_STORE(&cp[0],  c0);
+	CC_SIMD_STORE(&cp[4],  c1);
+	CC_SIMD_STORE(&cp[8],  c2);
+	CC_SIMD_STORE(&cp[12], c3);
+}
+
+#endif
+
 static void
 cc_mat4f_projuv(cc_vec4f_t* u, cc_vec4f_t* v,
                 cc_vec4f_t* projuv)
@@ -144,103 +200,88 @@ void cc_mat4f_inverse_copy(const cc_mat4f_t* self,
 	ASSERT(self);
 	ASSERT(copy);
 
-	// augmented matrix [a|I]
-	// copy is initialized to I but will contain a^-1
-	cc_mat4f_t a;
-	cc_mat4f_copy(self, &a);
-	cc_mat4f_identity(copy);
-
-	// make shortcuts to access a and inverse-v (aka copy)
-	float* aref = (float*) &a;
-	float* vref = (float*) copy;
-	#define A(row, col) aref[(row) + 4*(col)]
-	#define V(row, col) vref[(row) + 4*(col)]
-
-	// perform gauss-jordan elimination to determine
-	// inverse of a
-	int i;   // rows
-	int j;   // pivotal entry
-	int l;   // largest magnitude pivotal entry
-	int k;   // columns
-	float x[4];
-	float s;
-	for(j = 0; j < 4; ++j)
-	{
-		// find largest magnitude element in column-j
-		// where i >= j
-		l = j;
-		for(i = j + 1; i < 4; ++i)
-		{
-			if(fabs(A(i,j)) > fabs(A(l,j)))
-			{
-				l = i;
-			}
-		}
-
-		// interchange row-l and row-j of a and v
-		if(l != j)
-		{
-			for(k = 0; k < 4; ++k)
-			{
-				x[k]   = A(j,k);
-				A(j,k) = A(l,k);
-				A(l,k) = x[k];
-			}
-			for(k = 0; k < 4; ++k)
-			{
-				x[k]   = V(j,k);
-				V(j,k) = V(l,k);
-				V(l,k) = x[k];
-			}
-		}
-
-		// use the row sum operation to ensure zeros appear
-		// below the pivotal entry
-		// skip j=3
-		for(i = j + 1; i < 4; ++i)
-		{
-			s = A(i,j)/A(j,j);
-			for(k = j + 1; k < 4; ++k)
-			{
-				A(i,k) -= s*A(j,k);
-			}
-			for(k = 0; k < 4; ++k)
-			{
-				V(i,k) -= s*V(j,k);
-			}
-			A(i,j) = 0.0f;
-		}
-
-		// force the pivotal entry to be one
-		s = 1.0f/A(j,j);
-		for(k = j + 1; k < 4; ++k)
-		{
-			A(j,k) *= s;
-		}
-		for(k = 0; k < 4; ++k)
-		{
-			V(j,k) *= s;
-		}
-		A(j,j) = 1.0f;
-	}
-
-	// force zeros above all leading coefficients
-	// skip j=0
-	for(j = 3; j > 0; --j)
-	{
-		for(i = j - 1; i >= 0; --i)
-		{
-			s = A(i,j);   // A(j,j) is 1.0f in this case
-			for(k = j; k < 4; ++k)
-			{
-				A(i,k) -= s*A(j,k);
-			}
-			for(k = 0; k < 4; ++k)
-			{
-				V(i,k) -= s*V(j,k);
-			}
-		}
-	}
+	// compute the inverse from the adjugate using the
+	// columns a, b, c, d of self which avoids the pivoting
+	// branches of gauss-jordan elimination
+	//
+	// s = a.xyz x b.xyz
+	// t = c.xyz x d.xyz
+	// u = b.w*a.xyz - a.w*b.xyz
+	// v = d.w*c.xyz - c.w*d.xyz
+	// det = s.v + t.u
+	const cc_mat4f_t* m = self;
+
+	float sx = m->m10*m->m21 - m->m20*m->m11;
+	float sy = m->m20*m->m01 - m->m00*m->m21;
+	float sz = m->m00*m->m11 - m->m10*m->m01;
+	float tx = m->m12*m->m23 - m->m22*m->m13;
+	float ty = m->m22*m->m03 - m->m02*m->m23;
+	float tz = m->m02*m->m13 - m->m12*m->m03;
+	float ux = m->m31*m->m00 - m->m30*m->m01;
+	float uy = m->m31*m->m10 - m->m30*m->m11;
+	float uz = m->m31*m->m20 - m->m30*m->m21;
+	float vx = m->m33*m->m02 - m->m32*m->m03;
+	float vy = m->m33*m->m12 - m->m32*m->m13;
+	float vz = m->m33*m->m22 - m->m32*m->m23;
+
+	float det = sx*vx + sy*vy + sz*vz +
+	            tx*ux + ty*uy + tz*uz;
+	float r   = 1.0f/det;
+
+	// scale s, t, u, v by 1/det
+	sx *= r;
+	sy *= r;
+	sz *= r;
+	tx *= r;
+	ty *= r;
+	tz *= r;
+	ux *= r;
+	uy *= r;
+	uz *= r;
+	vx *= r;
+	vy *= r;
+	vz *= r;
+
+	// the rows of the inverse are
+	// row0 = (b.xyz x v + b.w*t, -b.xyz.t)
+	// row1 = (v x a.xyz - a.w*t,  a.xyz.t)
+	// row2 = (d.xyz x u + d.w*s, -d.xyz.s)
+	// row3 = (u x c.xyz - c.w*s,  c.xyz.s)
+	// the results are stored in temporaries so that copy
+	// may alias self
+	float m00 = m->m11*vz - m->m21*vy + m->m31*tx;
+	float m01 = m->m21*vx - m->m01*vz + m->m31*ty;
+	float m02 = m->m01*vy - m->m11*vx + m->m31*tz;
+	float m03 = -(m->m01*tx + m->m11*ty + m->m21*tz);
+	float m10 = vy*m->m20 - vz*m->m10 - m->m30*tx;
+	float m11 = vz*m->m00 - vx*m->m20 - m->m30*ty;
+	float m12 = vx*m->m10 - vy*m->m00 - m->m30*tz;
+	float m13 = m->m00*tx + m->m10*ty + m->m20*tz;
+	float m20 = m->m13*uz - m->m23*uy + m->m33*sx;
+	float m21 = m->m23*ux - m->m03*uz + m->m33*sy;
+	float m22 = m->m03*uy - m->m13*ux + m->m33*sz;
+	float m23 = -(m->m03*sx + m->m13*sy + m->m23*sz);
+	float m30 = uy*m->m22 - uz*m->m12 - m->m32*sx;
+	float m31 = uz*m->m02 - ux*m->m22 - m->m32*sy;
+	float m32 = ux*m->m12 - uy*m->m02 - m->m32*sz;
+	float m33 = m->m02*sx + m->m12*sy + m->m22*sz;
+
+	copy->m00 = m00;
+	copy->m01 = m01;
+	copy->m02 = m02;
+	copy->m03 = m03;
+	copy->m10 = m10;
+	copy->m11 = m11;
+	copy->m12 = m12;
+	copy->m13 = m13;
+	copy->m20 = m20;
+	copy->m21 = m21;
+	copy->m22 = m22;
+	copy->m23 = m23;
+	copy->m30 = m30;
+	copy->m31 = m31;
+	copy->m32 = m32;
+	copy->m33 = m33;
 }
 
 void cc_mat4f_mulm(cc_mat4f_t* self, const cc_mat4f_t* m)
@@ -261,6 +302,11 @@ void cc_mat4f_mulm_copy(const cc_mat4f_t* self,
 	ASSERT(m);
 	ASSERT(copy);
 
+	#ifdef CC_SIMD
+	cc_simd4f_t a[4];
+	cc_mat4f_loadCols(self, a);
+	cc_mat4f_mulmCols(a, m, copy);
+	#else
 	const cc_mat4f_t* a = self;
 	cc_mat4f_t*       c = copy;
 	c->m00 = a->m00*m->m00 + a->m01*m->m10 + a->m02*m->m20 + a->m03*m->m30;
@@ -279,6 +325,34 @@ void cc_mat4f_mulm_copy(const cc_mat4f_t* self,
 	c->m31 = a->m30*m->m01 + a->m31*m->m11 + a->m32*m->m21 + a->m33*m->m31;
 	c->m32 = a->m30*m->m02 + a->m31*m->m12 + a->m32*m->m22 + a->m33*m->m32;
 	c->m33 = a->m30*m->m03 + a->m31*m->m13 + a->m32*m->m23 + a->m33*m->m33;
+	#endif
+}
+
+void cc_mat4f_mulmArray(const cc_mat4f_t* self, int count,
+                        const cc_mat4f_t* m,
+                        cc_mat4f_t* copy)
+{
+	ASSERT(self);
+	ASSERT(m || (count == 0));
+	ASSERT(copy || (count == 0));
+
+	// copy[i] = self*m[i] where m may alias copy
+	int i;
+	#ifdef CC_SIMD
+	cc_simd4f_t a[4];
+	cc_mat4f_loadCols(self, a);
+	for(i = 0; i < count; ++i)
+	{
+		cc_mat4f_mulmCols(a, &m[i], &copy[i]);
+	}
+	#else
+	cc_mat4f_t tmp;
+	for(i = 0; i < count; ++i)
+	{
+		cc_mat4f_mulm_copy(self, &m[i], &tmp);
+		cc_mat4f_copy(&tmp, &copy[i]);
+	}
+	#endif
 }
 
 void cc_mat4f_mulv(const cc_mat4f_t* self, cc_vec4f_t* v)
@@ -299,12 +373,57 @@ void cc_mat4f_mulv_copy(const cc_mat4f_t* self,
 	ASSERT(v);
 	ASSERT(copy);
 
+	#ifdef CC_SIMD
+	cc_simd4f_t a[4];
+	cc_mat4f_loadCols(self, a);
+	CC_SIMD_STORE((float*) copy,
+	               cc_mat4f_mulvCols(a, (const float*) v));
+	#else
 	const cc_mat4f_t* a = self;
 	cc_vec4f_t*       c = copy;
 	c->x = a->m00*v->x + a->m01*v->y + a->m02*v->z + a->m03*v->w;
 	c->y = a->m10*v->x + a->m11*v->y + a->m12*v->z + a->m13*v->w;
 	c->z = a->m20*v->x + a->m21*v->y + a->m22*v->z + a->m23*v->w;
 	c->w = a->m30*v->x + a->m31*v->y + a->m32*v->z + a->m33*v->w;
+	#endif
+}
+
+void cc_mat4f_mulvArray(const cc_mat4f_t* self, int count,
+                        const cc_vec4f_t* v,
+                        cc_vec4f_t* copy)
+{
+	ASSERT(self);
+	ASSERT(v || (count == 0));
+	ASSERT(copy || (count == 0));
+
+	// copy[i] = self*v[i] where v may alias copy
+	int i;
+	#ifdef CC_SIMD
+	cc_simd4f_t a[4];
+	cc_mat4f_loadCols(self, a);
+	for(i = 0; i < count; ++i)
+	{
+		CC_SIMD_STORE((float*) &copy[i],
+		               cc_mat4f_mulvCols(a, (const float*) &v[i]));
+	}
+	#else
+	const cc_mat4f_t* a = self;
+	float x;
+	float y;
+	float z;
+	float w;
+	for(i = 0; i < count; ++i)
+	{
+		x = v[i].x;
+		y = v[i].y;
+		z = v[i].z;
+		w = v[i].w;
+		copy[i].x = a->m00*x + a->m01*y + a->m02*z + a->m03*w;
+		copy[i].y = a->m10*x + a->m11*y + a->m12*z + a->m13*w;
+		copy[i].z = a->m20*x + a->m21*y + a->m22*z + a->m23*w;
+		copy[i].w = a->m30*x + a->m31*y + a->m32*z + a->m33*w;
+	}
+	#endif
 }
 
 void cc_mat4f_muls(cc_mat4f_t* self, float s)
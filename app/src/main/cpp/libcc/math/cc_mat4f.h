@@ -65,11 +65,17 @@ void cc_mat4f_mulm(cc_mat4f_t* self,
 void cc_mat4f_mulm_copy(const cc_mat4f_t* self,
                         const cc_mat4f_t* m,
                         cc_mat4f_t* copy);
+void cc_mat4f_mulmArray(const cc_mat4f_t* self, int count,
+                        const cc_mat4f_t* m,
+                        cc_mat4f_t* copy);
 void cc_mat4f_mulv(const cc_mat4f_t* self,
                    cc_vec4f_t* v);
 void cc_mat4f_mulv_copy(const cc_mat4f_t* self,
                         const cc_vec4f_t* v,
                         cc_vec4f_t* copy);
+void cc_mat4f_mulvArray(const cc_mat4f_t* self, int count,
+                        const cc_vec4f_t* v,
+                        cc_vec4f_t* copy);
 void cc_mat4f_muls(cc_mat4f_t* self, float s);
 void cc_mat4f_muls_copy(const cc_mat4f_t* self, float s,
                         cc_mat4f_t* copy);
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_simd_H
+#define cc_simd_H
+
+// compile time selection of 4-wide float SIMD operations
+// for the math kernels
+//
+// CC_SIMD is defined when SSE2 or NEON is available and
+// CC_SIMD_DIV is defined when the target also supports
+// vector division and square root
+//
+// CC_SIMD_LTMASK returns a 4-bit lane mask of a < b
+//
+// loads and stores are unaligned since the math types are
+// only 4-byte aligned
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+	#define CC_SIMD
+	#define CC_SIMD_DIV
+	typedef __m128 cc_simd4f_t;
+	#define CC_SIMD_LOAD(p)       _mm_loadu_ps(p)
+	#define CC_SIMD_STORE(p, a)   _mm_storeu_ps(p, a)
+	#define CC_SIMD_SPLAT(s)      _mm_set1_ps(s)
+	#define CC_SIMD_ADD(a, b)     _mm_add_ps(a, b)
+	#define CC_SIMD_SUB(a, b)     _mm_sub_ps(a, b)
+	#define CC_SIMD_MUL(a, b)     _mm_mul_ps(a, b)
+	#define CC_SIMD_MADD(c, a, b) _mm_add_ps(c, _mm_mul_ps(a, b))
+	#define CC_SIMD_MSUB(c, a, b) _mm_sub_ps(c, _mm_mul_ps(a, b))
+	#define CC_SIMD_DIVV(a, b)    _mm_div_ps(a, b)
+	#define CC_SIMD_SQRT(a)       _mm_sqrt_ps(a)
+	#define CC_SIMD_LTMASK(a, b)  _mm_movemask_ps(_mm_cmplt_ps(a, b))
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define CC_SIMD
+	typedef float32x4_t cc_simd4f_t;
+	#define CC_SIMD_LOAD(p)       vld1q_f32(p)
+	#define CC_SIMD_STORE(p, a)   vst1q_f32(p, a)
+	#define CC_SIMD_SPLAT(s)      vdupq_n_f32(s)
+	#define CC_SIMD_ADD(a, b)     vaddq_f32(a, b)
+	#define CC_SIMD_SUB(a, b)     vsubq_f32(a, b)
+	#define CC_SIMD_MUL(a, b)     vmulq_f32(a, b)
+	#define CC_SIMD_MADD(c, a, b) vmlaq_f32(c, a, b)
+	#define CC_SIMD_MSUB(c, a, b) vmlsq_f32(c, a, b)
+	#define CC_SIMD_LTMASK(a, b)  cc_simd_ltmask(a, b)
+	#ifdef __aarch64__
+		#define CC_SIMD_DIV
+		#define CC_SIMD_DIVV(a, b) vdivq_f32(a, b)
+		#define CC_SIMD_SQRT(a)    vsqrtq_f32(a)
+	#endif
+
+	// bit i is set when a[i] < b[i]
+	static inline int
+	cc_simd_ltmask(float32x4_t a, float32x4_t b)
+	{
+		static const uint32_t bits[4] = { 1, 2, 4, 8 };
+		uint32x4_t m = vandq_u32(vcltq_f32(a, b),
+		                         vld1q_u32(bits));
+		uint32x2_t s = vadd_u32(vget_low_u32(m),
+		                        vget_high_u32(m));
+		return (int) vget_lane_u32(vpadd_u32(s, s), 0);
+	}
+#endif
+
+#endif
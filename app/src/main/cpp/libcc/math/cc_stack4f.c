@@ -29,12 +29,53 @@
 #include "../cc_memory.h"
 #include "cc_stack4f.h"
 
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int cc_stack4f_grow(cc_stack4f_t* self)
+{
+	ASSERT(self);
+
+	if(self->depth < self->capacity)
+	{
+		return 1;
+	}
+
+	int capacity = 2*self->capacity;
+	if(capacity < CC_STACK4F_DEPTH)
+	{
+		capacity = CC_STACK4F_DEPTH;
+	}
+
+	cc_mat4f_t* matrix_stack;
+	matrix_stack = (cc_mat4f_t*)
+	               REALLOC(self->matrix_stack,
+	                       capacity*sizeof(cc_mat4f_t));
+	if(matrix_stack == NULL)
+	{
+		LOGE("REALLOC failed");
+		return 0;
+	}
+
+	self->capacity     = capacity;
+	self->matrix_stack = matrix_stack;
+	return 1;
+}
+
 /***********************************************************
 * public                                                   *
 ***********************************************************/
 
 cc_stack4f_t* cc_stack4f_new(void)
 {
+	return cc_stack4f_newDepth(CC_STACK4F_DEPTH);
+}
+
+cc_stack4f_t* cc_stack4f_newDepth(int depth)
+{
+	ASSERT(depth > 0);
+
 	cc_stack4f_t* self = (cc_stack4f_t*) CALLOC(1, sizeof(cc_stack4f_t));
 	if(self == NULL)
 	{
@@ -42,11 +83,16 @@ cc_stack4f_t* cc_stack4f_new(void)
 		return NULL;
 	}
 
-	self->matrix_stack = cc_list_new();
+	// preallocate the expected depth so that push does not
+	// allocate in the common case
+	self->matrix_stack = (cc_mat4f_t*)
+	                     CALLOC(depth, sizeof(cc_mat4f_t));
 	if(self->matrix_stack == NULL)
 	{
+		LOGE("CALLOC failed");
 		goto fail_matrix_stack;
 	}
+	self->capacity = depth;
 
 	// success
 	return self;
@@ -65,15 +111,7 @@ void cc_stack4f_delete(cc_stack4f_t** _self)
 	cc_stack4f_t* self = *_self;
 	if(self)
 	{
-		cc_listIter_t* iter = cc_list_head(self->matrix_stack);
-		while(iter)
-		{
-			cc_mat4f_t* m;
-			m = (cc_mat4f_t*)
-			    cc_list_remove(self->matrix_stack, &iter);
-			FREE(m);
-		}
-		cc_list_delete(&self->matrix_stack);
+		FREE(self->matrix_stack);
 		FREE(self);
 		*_self = NULL;
 	}
@@ -84,14 +122,55 @@ void cc_stack4f_push(cc_stack4f_t* self, const cc_mat4f_t* m)
 	ASSERT(self);
 	ASSERT(m);
 
-	cc_mat4f_t* c = (cc_mat4f_t*) CALLOC(1, sizeof(cc_mat4f_t));
-	if(c == NULL)
+	// m may reference the stack which is moved by grow
+	cc_mat4f_t tmp;
+	if(self->depth == self->capacity)
+	{
+		cc_mat4f_copy(m, &tmp);
+		m = &tmp;
+	}
+
+	if(cc_stack4f_grow(self) == 0)
 	{
-		LOGE("CALLOC failed");
 		return;
 	}
-	cc_mat4f_copy(m, c);
-	cc_list_insert(self->matrix_stack, NULL, (const void*) c);
+
+	cc_mat4f_copy(m, &self->matrix_stack[self->depth]);
+	++self->depth;
+}
+
+cc_mat4f_t*
+cc_stack4f_pushMulm(cc_stack4f_t* self,
+                    const cc_mat4f_t* parent,
+                    const cc_mat4f_t* child)
+{
+	ASSERT(self);
+	ASSERT(parent);
+	ASSERT(child);
+
+	// parent and child may reference the stack which is
+	// moved by grow
+	cc_mat4f_t tmp_parent;
+	cc_mat4f_t tmp_child;
+	if(self->depth == self->capacity)
+	{
+		cc_mat4f_copy(parent, &tmp_parent);
+		cc_mat4f_copy(child, &tmp_child);
+		parent = &tmp_parent;
+		child  = &tmp_child;
+	}
+
+	if(cc_stack4f_grow(self) == 0)
+	{
+		return NULL;
+	}
+
+	// the product is written directly into the new top
+	cc_mat4f_t* top = &self->matrix_stack[self->depth];
+	cc_mat4f_mulm_copy(parent, child, top);
+	++self->depth;
+
+	return top;
 }
 
 void cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m)
@@ -99,13 +178,20 @@ void cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m)
 	ASSERT(self);
 	ASSERT(m);
 
-	cc_listIter_t* iter = cc_list_head(self->matrix_stack);
-	if(iter)
+	if(self->depth > 0)
+	{
+		--self->depth;
+		cc_mat4f_copy(&self->matrix_stack[self->depth], m);
+	}
+}
+
+const cc_mat4f_t* cc_stack4f_top(cc_stack4f_t* self)
+{
+	ASSERT(self);
+
+	if(self->depth > 0)
 	{
-		cc_mat4f_t* c;
-		c = (cc_mat4f_t*)
-		    cc_list_remove(self->matrix_stack, &iter);
-		cc_mat4f_copy(c, m);
-		FREE(c);
+		return &self->matrix_stack[self->depth - 1];
 	}
+	return NULL;
 }
@@ -24,17 +24,25 @@
 #ifndef cc_stack4f_H
 #define cc_stack4f_H
 
-#include "../cc_list.h"
 #include "cc_mat4f.h"
 
+#define CC_STACK4F_DEPTH 16
+
 typedef struct
 {
-	cc_list_t* matrix_stack;
+	int         depth;
+	int         capacity;
+	cc_mat4f_t* matrix_stack;
 } cc_stack4f_t;
 
-cc_stack4f_t* cc_stack4f_new(void);
-void          cc_stack4f_delete(cc_stack4f_t** _self);
-void          cc_stack4f_push(cc_stack4f_t* self, const cc_mat4f_t* m);
-void          cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m);
+cc_stack4f_t*     cc_stack4f_new(void);
+cc_stack4f_t*     cc_stack4f_newDepth(int depth);
+void              cc_stack4f_delete(cc_stack4f_t** _self);
+void              cc_stack4f_push(cc_stack4f_t* self, const cc_mat4f_t* m);
+cc_mat4f_t*       cc_stack4f_pushMulm(cc_stack4f_t* self,
+                                      const cc_mat4f_t* parent,
+                                      const cc_mat4f_t* child);
+void              cc_stack4f_pop(cc_stack4f_t* self, cc_mat4f_t* m);
+const cc_mat4f_t* cc_stack4f_top(cc_stack4f_t* self);
 
 #endif
@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "../cc_log.h"
+#include "../cc_memory.h"
+#include "cc_simd.h"
+#include "cc_vec3fArray.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// c = a + b
+static void
+cc_vec3fArray_add(int count, const float* a, const float* b,
+                  float* c)
+{
+	ASSERT(a);
+	ASSERT(b);
+	ASSERT(c);
+
+	int i = 0;
+	#ifdef CC_SIMD
+	for(; i + 4 <= count; i += 4)
+	{
+		CC_SIMD_STORE(&c[i], CC_SIMD_ADD(CC_SIMD_LOAD(&a[i]),
+		                                 CC_SIMD_LOAD(&b[i])));
+	}
+	#endif
+
+	for(; i < count; ++i)
+	{
+		c[i] = a[i] + b[i];
+	}
+}
+
+// c = a - b
+static void
+cc_vec3fArray_sub(int count, const float* a, const float* b,
+                  float* c)
+{
+	ASSERT(a);
+	ASSERT(b);
+	ASSERT(c);
+
+	int i = 0;
+	#ifdef CC_SIMD
+	for(; i + 4 <= count; i += 4)
+	{
+		CC_SIMD_STORE(&c[i], CC_SIMD_SUB(CC_SIMD_LOAD(&a[i]),
+		                                 CC_SIMD_LOAD(&b[i])));
+	}
+	#endif
+
+	for(; i < count; ++i)
+	{
+		c[i] = a[i] - b[i];
+	}
+}
+
+// c = s*a
+static void
+cc_vec3fArray_mul(int count, const float* a, float s,
+                  float* c)
+{
+	ASSERT(a);
+	ASSERT(c);
+
+	int i = 0;
+	#ifdef CC_SIMD
+	cc_simd4f_t ss = CC_SIMD_SPLAT(s);
+	for(; i + 4 <= count; i += 4)
+	{
+		CC_SIMD_STORE(&c[i], CC_SIMD_MUL(CC_SIMD_LOAD(&a[i]),
+		                                 ss));
+	}
+	#endif
+
+	for(; i < count; ++i)
+	{
+		c[i] = s*a[i];
+	}
+}
+
+// c = a + s*(b - a)
+static void
+cc_vec3fArray_mix(int count, const float* a, const float* b,
+                  float s, float* c)
+{
+	ASSERT(a);
+	ASSERT(b);
+	ASSERT(c);
+
+	int i = 0;
+	#ifdef CC_SIMD
+	cc_simd4f_t ss = CC_SIMD_SPLAT(s);
+	cc_simd4f_t aa;
+	cc_simd4f_t bb;
+	for(; i + 4 <= count; i += 4)
+	{
+		aa = CC_SIMD_LOAD(&a[i]);
+		bb = CC_SIMD_LOAD(&b[i]);
+		CC_SIMD_STORE(&c[i],
+		              CC_SIMD_MADD(aa, ss, CC_SIMD_SUB(bb, aa)));
+	}
+	#endif
+
+	for(; i < count; ++i)
+	{
+		c[i] = a[i] + s*(b[i] - a[i]);
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+cc_vec3fArray_t* cc_vec3fArray_new(int count)
+{
+	ASSERT(count >= 0);
+
+	cc_vec3fArray_t* self;
+	self = (cc_vec3fArray_t*)
+	       CALLOC(1, sizeof(cc_vec3fArray_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	if(cc_vec3fArray_resize(self, count) == 0)
+	{
+		goto fail_resize;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_resize:
+		FREE(self);
+	return NULL;
+}
+
+void cc_vec3fArray_delete(cc_vec3fArray_t** _self)
+{
+	ASSERT(_self);
+
+	cc_vec3fArray_t* self = *_self;
+	if(self)
+	{
+		FREE(self->x);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+int cc_vec3fArray_resize(cc_vec3fArray_t* self, int count)
+{
+	ASSERT(self);
+	ASSERT(count >= 0);
+
+	if(count <= self->capacity)
+	{
+		self->count = count;
+		return 1;
+	}
+
+	// the components share one buffer and the capacity is
+	// a multiple of 4 to keep whole SIMD blocks together
+	int capacity = 2*self->capacity;
+	if(capacity < count)
+	{
+		capacity = count;
+	}
+	capacity = (capacity + 3) & ~3;
+
+	float* x = (float*)
+	           MALLOC(3*capacity*sizeof(float));
+	if(x == NULL)
+	{
+		LOGE("MALLOC failed");
+		return 0;
+	}
+	float* y = &x[capacity];
+	float* z = &x[2*capacity];
+
+	if(self->count)
+	{
+		size_t size = self->count*sizeof(float);
+		memcpy(x, self->x, size);
+		memcpy(y, self->y, size);
+		memcpy(z, self->z, size);
+	}
+	FREE(self->x);
+
+	self->count    = count;
+	self->capacity = capacity;
+	self->x        = x;
+	self->y        = y;
+	self->z        = z;
+	return 1;
+}
+
+void cc_vec3fArray_set(cc_vec3fArray_t* self, int i,
+                       const cc_vec3f_t* v)
+{
+	ASSERT(self);
+	ASSERT((i >= 0) && (i < self->count));
+	ASSERT(v);
+
+	self->x[i] = v->x;
+	self->y[i] = v->y;
+	self->z[i] = v->z;
+}
+
+void cc_vec3fArray_get(const cc_vec3fArray_t* self, int i,
+                       cc_vec3f_t* v)
+{
+	ASSERT(self);
+	ASSERT((i >= 0) && (i < self->count));
+	ASSERT(v);
+
+	v->x = self->x[i];
+	v->y = self->y[i];
+	v->z = self->z[i];
+}
+
+void cc_vec3fArray_load(cc_vec3fArray_t* self,
+                        const cc_vec3f_t* v)
+{
+	ASSERT(self);
+	ASSERT(v || (self->count == 0));
+
+	int i;
+	for(i = 0; i < self->count; ++i)
+	{
+		self->x[i] = v[i].x;
+		self->y[i] = v[i].y;
+		self->z[i] = v[i].z;
+	}
+}
+
+void cc_vec3fArray_store(const cc_vec3fArray_t* self,
+                         cc_vec3f_t* v)
+{
+	ASSERT(self);
+	ASSERT(v || (self->count == 0));
+
+	int i;
+	for(i = 0; i < self->count; ++i)
+	{
+		v[i].x = self->x[i];
+		v[i].y = self->y[i];
+		v[i].z = self->z[i];
+	}
+}
+
+void cc_vec3fArray_addv(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v)
+{
+	cc_vec3fArray_addv_copy(self, v, self);
+}
+
+void cc_vec3fArray_addv_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(v);
+	ASSERT(copy);
+	ASSERT(self->count == v->count);
+	ASSERT(self->count == copy->count);
+
+	int n = self->count;
+	cc_vec3fArray_add(n, self->x, v->x, copy->x);
+	cc_vec3fArray_add(n, self->y, v->y, copy->y);
+	cc_vec3fArray_add(n, self->z, v->z, copy->z);
+}
+
+void cc_vec3fArray_subv(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v)
+{
+	cc_vec3fArray_subv_copy(self, v, self);
+}
+
+void cc_vec3fArray_subv_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(v);
+	ASSERT(copy);
+	ASSERT(self->count == v->count);
+	ASSERT(self->count == copy->count);
+
+	int n = self->count;
+	cc_vec3fArray_sub(n, self->x, v->x, copy->x);
+	cc_vec3fArray_sub(n, self->y, v->y, copy->y);
+	cc_vec3fArray_sub(n, self->z, v->z, copy->z);
+}
+
+void cc_vec3fArray_muls(cc_vec3fArray_t* self, float s)
+{
+	cc_vec3fArray_muls_copy(self, s, self);
+}
+
+void cc_vec3fArray_muls_copy(const cc_vec3fArray_t* self,
+                             float s,
+                             cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(copy);
+	ASSERT(self->count == copy->count);
+
+	int n = self->count;
+	cc_vec3fArray_mul(n, self->x, s, copy->x);
+	cc_vec3fArray_mul(n, self->y, s, copy->y);
+	cc_vec3fArray_mul(n, self->z, s, copy->z);
+}
+
+void cc_vec3fArray_normalize(cc_vec3fArray_t* self)
+{
+	cc_vec3fArray_normalize_copy(self, self);
+}
+
+void cc_vec3fArray_normalize_copy(const cc_vec3fArray_t* self,
+                                  cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(copy);
+	ASSERT(self->count == copy->count);
+
+	const float* x  = self->x;
+	const float* y  = self->y;
+	const float* z  = self->z;
+	float*       cx = copy->x;
+	float*       cy = copy->y;
+	float*       cz = copy->z;
+
+	int i = 0;
+	#ifdef CC_SIMD_DIV
+	cc_simd4f_t one = CC_SIMD_SPLAT(1.0f);
+	cc_simd4f_t vx;
+	cc_simd4f_t vy;
+	cc_simd4f_t vz;
+	cc_simd4f_t s;
+	for(; i + 4 <= self->count; i += 4)
+	{
+		vx = CC_SIMD_LOAD(&x[i]);
+		vy = CC_SIMD_LOAD(&y[i]);
+		vz = CC_SIMD_LOAD(&z[i]);
+		s  = CC_SIMD_MUL(vx, vx);
+		s  = CC_SIMD_MADD(s, vy, vy);
+		s  = CC_SIMD_MADD(s, vz, vz);
+		s  = CC_SIMD_DIVV(one, CC_SIMD_SQRT(s));
+		CC_SIMD_STORE(&cx[i], CC_SIMD_MUL(vx, s));
+		CC_SIMD_STORE(&cy[i], CC_SIMD_MUL(vy, s));
+		CC_SIMD_STORE(&cz[i], CC_SIMD_MUL(vz, s));
+	}
+	#endif
+
+	float s1;
+	for(; i < self->count; ++i)
+	{
+		s1    = 1.0f/sqrtf(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+		cx[i] = s1*x[i];
+		cy[i] = s1*y[i];
+		cz[i] = s1*z[i];
+	}
+}
+
+void cc_vec3fArray_dot(const cc_vec3fArray_t* a,
+                       const cc_vec3fArray_t* b,
+                       float* dot)
+{
+	ASSERT(a);
+	ASSERT(b);
+	ASSERT(dot || (a->count == 0));
+	ASSERT(a->count == b->count);
+
+	int i = 0;
+	#ifdef CC_SIMD
+	cc_simd4f_t d;
+	for(; i + 4 <= a->count; i += 4)
+	{
+		d = CC_SIMD_MUL(CC_SIMD_LOAD(&a->x[i]),
+		                CC_SIMD_LOAD(&b->x[i]));
+		d = CC_SIMD_MADD(d, CC_SIMD_LOAD(&a->y[i]),
+		                 CC_SIMD_LOAD(&b->y[i]));
+		d = CC_SIMD_MADD(d, CC_SIMD_LOAD(&a->z[i]),
+		                 CC_SIMD_LOAD(&b->z[i]));
+		CC_SIMD_STORE(&dot[i], d);
+	}
+	#endif
+
+	for(; i < a->count; ++i)
+	{
+		dot[i] = a->x[i]*b->x[i] + a->y[i]*b->y[i] +
+		         a->z[i]*b->z[i];
+	}
+}
+
+void cc_vec3fArray_cross(cc_vec3fArray_t* self,
+                         const cc_vec3fArray_t* v)
+{
+	cc_vec3fArray_cross_copy(self, v, self);
+}
+
+void cc_vec3fArray_cross_copy(const cc_vec3fArray_t* self,
+                              const cc_vec3fArray_t* v,
+                              cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(v);
+	ASSERT(copy);
+	ASSERT(self->count == v->count);
+	ASSERT(self->count == copy->count);
+
+	const float* ax = self->x;
+	const float* ay = self->y;
+	const float* az = self->z;
+	const float* bx = v->x;
+	const float* by = v->y;
+	const float* bz = v->z;
+
+	// all inputs of an element are loaded before the
+	// results are stored since copy may alias self or v
+	int i = 0;
+	#ifdef CC_SIMD
+	cc_simd4f_t vax;
+	cc_simd4f_t vay;
+	cc_simd4f_t vaz;
+	cc_simd4f_t vbx;
+	cc_simd4f_t vby;
+	cc_simd4f_t vbz;
+	for(; i + 4 <= self->count; i += 4)
+	{
+		vax = CC_SIMD_LOAD(&ax[i]);
+		vay = CC_SIMD_LOAD(&ay[i]);
+		vaz = CC_SIMD_LOAD(&az[i]);
+		vbx = CC_SIMD_LOAD(&bx[i]);
+		vby = CC_SIMD_LOAD(&by[i]);
+		vbz = CC_SIMD_LOAD(&bz[i]);
+		CC_SIMD_STORE(&copy->x[i],
+		              CC_SIMD_MSUB(CC_SIMD_MUL(vay, vbz), vaz, vby));
+		CC_SIMD_STORE(&copy->y[i],
+		              CC_SIMD_MSUB(CC_SIMD_MUL(vaz, vbx), vax, vbz));
+		CC_SIMD_STORE(&copy->z[i],
+		              CC_SIMD_MSUB(CC_SIMD_MUL(vax, vby), vay, vbx));
+	}
+	#endif
+
+	float x;
+	float y;
+	float z;
+	for(; i < self->count; ++i)
+	{
+		x = ay[i]*bz[i] - az[i]*by[i];
+		y = az[i]*bx[i] - ax[i]*bz[i];
+		z = ax[i]*by[i] - ay[i]*bx[i];
+		copy->x[i] = x;
+		copy->y[i] = y;
+		copy->z[i] = z;
+	}
+}
+
+void cc_vec3fArray_lerp(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v, float s)
+{
+	cc_vec3fArray_lerp_copy(self, v, s, self);
+}
+
+void cc_vec3fArray_lerp_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             float s,
+                             cc_vec3fArray_t* copy)
+{
+	ASSERT(self);
+	ASSERT(v);
+	ASSERT(copy);
+	ASSERT(self->count == v->count);
+	ASSERT(self->count == copy->count);
+
+	int n = self->count;
+	cc_vec3fArray_mix(n, self->x, v->x, s, copy->x);
+	cc_vec3fArray_mix(n, self->y, v->y, s, copy->y);
+	cc_vec3fArray_mix(n, self->z, v->z, s, copy->z);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_vec3fArray_H
+#define cc_vec3fArray_H
+
+#include "cc_vec3f.h"
+
+// structure-of-arrays batch of cc_vec3f_t
+// the x, y and z components are stored in separate arrays
+// so that each operation processes count elements with
+// SIMD or auto-vectorizable loops
+// the operations require arrays with equal counts and the
+// copy variants may alias their inputs
+
+typedef struct
+{
+	int    count;
+	int    capacity;
+	float* x;
+	float* y;
+	float* z;
+} cc_vec3fArray_t;
+
+// dynamic constructor/destructor
+cc_vec3fArray_t* cc_vec3fArray_new(int count);
+void             cc_vec3fArray_delete(cc_vec3fArray_t** _self);
+
+// element operations
+int  cc_vec3fArray_resize(cc_vec3fArray_t* self, int count);
+void cc_vec3fArray_set(cc_vec3fArray_t* self, int i,
+                       const cc_vec3f_t* v);
+void cc_vec3fArray_get(const cc_vec3fArray_t* self, int i,
+                       cc_vec3f_t* v);
+void cc_vec3fArray_load(cc_vec3fArray_t* self,
+                        const cc_vec3f_t* v);
+void cc_vec3fArray_store(const cc_vec3fArray_t* self,
+                         cc_vec3f_t* v);
+
+// batch vector operations
+void cc_vec3fArray_addv(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v);
+void cc_vec3fArray_addv_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             cc_vec3fArray_t* copy);
+void cc_vec3fArray_subv(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v);
+void cc_vec3fArray_subv_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             cc_vec3fArray_t* copy);
+void cc_vec3fArray_muls(cc_vec3fArray_t* self, float s);
+void cc_vec3fArray_muls_copy(const cc_vec3fArray_t* self,
+                             float s,
+                             cc_vec3fArray_t* copy);
+void cc_vec3fArray_normalize(cc_vec3fArray_t* self);
+void cc_vec3fArray_normalize_copy(const cc_vec3fArray_t* self,
+                                  cc_vec3fArray_t* copy);
+void cc_vec3fArray_dot(const cc_vec3fArray_t* a,
+                       const cc_vec3fArray_t* b,
+                       float* dot);
+void cc_vec3fArray_cross(cc_vec3fArray_t* self,
+                         const cc_vec3fArray_t* v);
+void cc_vec3fArray_cross_copy(const cc_vec3fArray_t* self,
+                              const cc_vec3fArray_t* v,
+                              cc_vec3fArray_t* copy);
+void cc_vec3fArray_lerp(cc_vec3fArray_t* self,
+                        const cc_vec3fArray_t* v, float s);
+void cc_vec3fArray_lerp_copy(const cc_vec3fArray_t* self,
+                             const cc_vec3fArray_t* v,
+                             float s,
+                             cc_vec3fArray_t* copy);
+
+#endif
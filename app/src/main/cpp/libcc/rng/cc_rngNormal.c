@@ -23,8 +23,10 @@
 
 #include <float.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #define LOG_TAG "cc"
@@ -68,6 +70,125 @@ cc_rngNormal_boxMullerTransform(cc_rngNormal_t* self)
 	return z0;
 }
 
+// Ziggurat tables
+// Marsaglia and Tsang, The Ziggurat Method for Generating
+// Random Variables, 2000
+#define CC_RNGNORMAL_ZIGR 3.442619855899
+
+static pthread_once_t cc_rngNormal_zigOnce = PTHREAD_ONCE_INIT;
+static uint32_t       cc_rngNormal_zigK[128];
+static float          cc_rngNormal_zigW[128];
+static float          cc_rngNormal_zigF[128];
+
+static void cc_rngNormal_zigInit(void)
+{
+	const double m1 = 2147483648.0;
+	const double vn = 9.91256303526217e-3;
+
+	double dn = CC_RNGNORMAL_ZIGR;
+	double tn = dn;
+	double q  = vn/exp(-0.5*dn*dn);
+
+	cc_rngNormal_zigK[0]   = (uint32_t) ((dn/q)*m1);
+	cc_rngNormal_zigK[1]   = 0;
+	cc_rngNormal_zigW[0]   = (float) (q/m1);
+	cc_rngNormal_zigW[127] = (float) (dn/m1);
+	cc_rngNormal_zigF[0]   = 1.0f;
+	cc_rngNormal_zigF[127] = (float) exp(-0.5*dn*dn);
+
+	int i;
+	for(i = 126; i >= 1; --i)
+	{
+		dn = sqrt(-2.0*log(vn/dn + exp(-0.5*dn*dn)));
+		cc_rngNormal_zigK[i + 1] = (uint32_t) ((dn/tn)*m1);
+		tn = dn;
+		cc_rngNormal_zigF[i] = (float) exp(-0.5*dn*dn);
+		cc_rngNormal_zigW[i] = (float) (dn/m1);
+	}
+}
+
+// source of extra random words for the Ziggurat slow path
+typedef struct
+{
+	cc_rngXoshiro_t* xrng;
+	int              idx;
+	uint32_t         buf[CC_RNGXOSHIRO_LANES];
+} cc_rngNormalSrc_t;
+
+static uint32_t cc_rngNormal_srcU(cc_rngNormalSrc_t* src)
+{
+	ASSERT(src);
+
+	if(src->idx == CC_RNGXOSHIRO_LANES)
+	{
+		cc_rngXoshiro_next(src->xrng, src->buf);
+		src->idx = 0;
+	}
+	return src->buf[src->idx++];
+}
+
+// (0.0f, 1.0f)
+static float cc_rngNormal_srcF(cc_rngNormalSrc_t* src)
+{
+	ASSERT(src);
+
+	uint32_t u = cc_rngNormal_srcU(src);
+	return (((float) (u >> 8)) + 0.5f)/16777216.0f;
+}
+
+static float
+cc_rngNormal_zigSample(cc_rngNormalSrc_t* src, uint32_t u)
+{
+	ASSERT(src);
+
+	// the layer is selected by the low 7 bits and the
+	// value by the upper 25 bits so they are independent
+	int32_t  hz;
+	int      iz;
+	uint32_t ahz;
+	float    x;
+	float    y;
+	while(1)
+	{
+		iz  = (int) (u & 127);
+		hz  = (int32_t) (u & 0xFFFFFF80);
+		ahz = (hz < 0) ? (uint32_t) (-(int64_t) hz) :
+		                 (uint32_t) hz;
+		x   = ((float) hz)*cc_rngNormal_zigW[iz];
+
+		// fast path
+		if(ahz < cc_rngNormal_zigK[iz])
+		{
+			return x;
+		}
+
+		// base strip
+		if(iz == 0)
+		{
+			do
+			{
+				x = -logf(cc_rngNormal_srcF(src))*
+				    (float) (1.0/CC_RNGNORMAL_ZIGR);
+				y = -logf(cc_rngNormal_srcF(src));
+			} while(y + y < x*x);
+
+			return (hz > 0) ? (float) CC_RNGNORMAL_ZIGR + x :
+			                  -(float) CC_RNGNORMAL_ZIGR - x;
+		}
+
+		// wedge
+		if(cc_rngNormal_zigF[iz] +
+		   cc_rngNormal_srcF(src)*(cc_rngNormal_zigF[iz - 1] -
+		                           cc_rngNormal_zigF[iz]) <
+		   expf(-0.5f*x*x))
+		{
+			return x;
+		}
+
+		u = cc_rngNormal_srcU(src);
+	}
+}
+
 /***********************************************************
 * public                                                   *
 ***********************************************************/
@@ -94,8 +215,10 @@ void cc_rngNormal_initSeed(cc_rngNormal_t* self,
 
 	#ifdef CC_RNG_DEBUG
 	pcg32_srandom_r(&self->rng, 42u, 54u);
+	cc_rngXoshiro_initSeed(&self->xrng, 42u, 54u);
 	#else
 	pcg32_srandom_r(&self->rng, initstate, initseq);
+	cc_rngXoshiro_initSeed(&self->xrng, initstate, initseq);
 	#endif
 
 	self->mu    = mu;
@@ -139,3 +262,60 @@ double cc_rngNormal_rand1D(cc_rngNormal_t* self)
 
 	return cc_rngNormal_boxMullerTransform(self);
 }
+
+void cc_rngNormal_jump(cc_rngNormal_t* self)
+{
+	ASSERT(self);
+
+	// reseed the single value generator from the jumped
+	// stream so that both generators diverge from the copy
+	uint32_t u[4];
+	cc_rngXoshiro_jump(&self->xrng);
+	cc_rngXoshiro_fillU(&self->xrng, 4, u);
+	pcg32_srandom_r(&self->rng,
+	                (((uint64_t) u[0]) << 32) | u[1],
+	                (((uint64_t) u[2]) << 32) | u[3]);
+	self->phase = 0;
+}
+
+void cc_rngNormal_fillF(cc_rngNormal_t* self,
+                        int count, float* out)
+{
+	ASSERT(self);
+	ASSERT(out || (count == 0));
+
+	pthread_once(&cc_rngNormal_zigOnce, cc_rngNormal_zigInit);
+
+	cc_rngNormalSrc_t src =
+	{
+		.xrng = &self->xrng,
+		.idx  = CC_RNGXOSHIRO_LANES,
+	};
+
+	// generate the random words in blocks and transform
+	// them into out
+	uint32_t u[CC_RNGXOSHIRO_LANES];
+	float    mu    = (float) self->mu;
+	float    sigma = (float) self->sigma;
+
+	int i = 0;
+	int j;
+	int n;
+	while(i < count)
+	{
+		cc_rngXoshiro_next(&self->xrng, u);
+
+		n = count - i;
+		if(n > CC_RNGXOSHIRO_LANES)
+		{
+			n = CC_RNGXOSHIRO_LANES;
+		}
+
+		for(j = 0; j < n; ++j)
+		{
+			out[i + j] = sigma*cc_rngNormal_zigSample(&src, u[j]) +
+			             mu;
+		}
+		i += n;
+	}
+}
@@ -25,15 +25,20 @@
 #define cc_rngNormal_H
 
 #include "../../pcg-c-basic/pcg_basic.h"
+#include "cc_rngXoshiro.h"
 
 // normal/gaussian distribution of random numbers
+// the fill function uses the Ziggurat method with the bulk
+// xoshiro generator and jump creates a non-overlapping
+// stream for a copy of self
 typedef struct
 {
-	pcg32_random_t rng;
-	double         mu;
-	double         sigma;
-	int            phase;
-	double         rand;
+	pcg32_random_t  rng;
+	cc_rngXoshiro_t xrng;
+	double          mu;
+	double          sigma;
+	int             phase;
+	double          rand;
 } cc_rngNormal_t;
 
 void   cc_rngNormal_init(cc_rngNormal_t* self,
@@ -49,5 +54,8 @@ void   cc_rngNormal_reset(cc_rngNormal_t* self,
                           double sigma);
 float  cc_rngNormal_rand1F(cc_rngNormal_t* self);
 double cc_rngNormal_rand1D(cc_rngNormal_t* self);
+void   cc_rngNormal_jump(cc_rngNormal_t* self);
+void   cc_rngNormal_fillF(cc_rngNormal_t* self,
+                          int count, float* out);
 
 #endif
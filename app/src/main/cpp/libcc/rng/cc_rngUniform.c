@@ -51,8 +51,10 @@ void cc_rngUniform_initSeed(cc_rngUniform_t* self,
 
 	#ifdef CC_RNG_DEBUG
 	pcg32_srandom_r(&self->rng, 42u, 54u);
+	cc_rngXoshiro_initSeed(&self->xrng, 42u, 54u);
 	#else
 	pcg32_srandom_r(&self->rng, initstate, initseq);
+	cc_rngXoshiro_initSeed(&self->xrng, initstate, initseq);
 	#endif
 }
 
@@ -120,3 +122,37 @@ double cc_rngUniform_rand2D(cc_rngUniform_t* self,
 	rand = ldexp(pcg32_random_r(&self->rng), -32);
 	return rand*(max - min) + min;
 }
+
+void cc_rngUniform_jump(cc_rngUniform_t* self)
+{
+	ASSERT(self);
+
+	// reseed the single value generator from the jumped
+	// stream so that both generators diverge from the copy
+	uint32_t u[4];
+	cc_rngXoshiro_jump(&self->xrng);
+	cc_rngXoshiro_fillU(&self->xrng, 4, u);
+	pcg32_srandom_r(&self->rng,
+	                (((uint64_t) u[0]) << 32) | u[1],
+	                (((uint64_t) u[2]) << 32) | u[3]);
+}
+
+void cc_rngUniform_fillU(cc_rngUniform_t* self,
+                         int count, uint32_t* out)
+{
+	ASSERT(self);
+	ASSERT(out || (count == 0));
+
+	cc_rngXoshiro_fillU(&self->xrng, count, out);
+}
+
+void cc_rngUniform_fillF(cc_rngUniform_t* self,
+                         int count, float* out,
+                         float min, float max)
+{
+	ASSERT(self);
+	ASSERT(out || (count == 0));
+
+	// [min, max)
+	cc_rngXoshiro_fillF(&self->xrng, count, out, min, max);
+}
@@ -25,11 +25,15 @@
 #define cc_rngUniform_H
 
 #include "../../pcg-c-basic/pcg_basic.h"
+#include "cc_rngXoshiro.h"
 
 // uniform distribution of random numbers
+// the fill functions use the bulk xoshiro generator and
+// jump creates a non-overlapping stream for a copy of self
 typedef struct
 {
-	pcg32_random_t rng;
+	pcg32_random_t  rng;
+	cc_rngXoshiro_t xrng;
 } cc_rngUniform_t;
 
 void     cc_rngUniform_init(cc_rngUniform_t* self);
@@ -47,5 +51,11 @@ float    cc_rngUniform_rand2F(cc_rngUniform_t* self,
 double   cc_rngUniform_rand1D(cc_rngUniform_t* self);
 double   cc_rngUniform_rand2D(cc_rngUniform_t* self,
                               double min, double max);
+void     cc_rngUniform_jump(cc_rngUniform_t* self);
+void     cc_rngUniform_fillU(cc_rngUniform_t* self,
+                             int count, uint32_t* out);
+void     cc_rngUniform_fillF(cc_rngUniform_t* self,
+                             int count, float* out,
+                             float min, float max);
 
 #endif
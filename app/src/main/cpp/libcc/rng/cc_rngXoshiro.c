@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "cc"
+#include "../cc_log.h"
+#include "cc_rngXoshiro.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static const uint32_t CC_RNGXOSHIRO_JUMP[4] =
+{
+	0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b
+};
+
+static const uint32_t CC_RNGXOSHIRO_LONGJUMP[4] =
+{
+	0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662
+};
+
+static uint64_t cc_rngXoshiro_splitmix64(uint64_t* x)
+{
+	ASSERT(x);
+
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static inline uint32_t cc_rngXoshiro_rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+static void cc_rngXoshiro_step1(uint32_t* s)
+{
+	ASSERT(s);
+
+	uint32_t t = s[1] << 9;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3]  = cc_rngXoshiro_rotl(s[3], 11);
+}
+
+// apply a jump polynomial to a single lane state
+static void
+cc_rngXoshiro_jump1(uint32_t* s, const uint32_t* poly)
+{
+	ASSERT(s);
+	ASSERT(poly);
+
+	uint32_t t[4] = { 0, 0, 0, 0 };
+
+	int i;
+	int b;
+	for(i = 0; i < 4; ++i)
+	{
+		for(b = 0; b < 32; ++b)
+		{
+			if(poly[i] & (((uint32_t) 1) << b))
+			{
+				t[0] ^= s[0];
+				t[1] ^= s[1];
+				t[2] ^= s[2];
+				t[3] ^= s[3];
+			}
+			cc_rngXoshiro_step1(s);
+		}
+	}
+
+	s[0] = t[0];
+	s[1] = t[1];
+	s[2] = t[2];
+	s[3] = t[3];
+}
+
+static void
+cc_rngXoshiro_getLane(cc_rngXoshiro_t* self, int lane,
+                      uint32_t* s)
+{
+	ASSERT(self);
+	ASSERT(s);
+
+	s[0] = self->s0[lane];
+	s[1] = self->s1[lane];
+	s[2] = self->s2[lane];
+	s[3] = self->s3[lane];
+}
+
+static void
+cc_rngXoshiro_setLane(cc_rngXoshiro_t* self, int lane,
+                      const uint32_t* s)
+{
+	ASSERT(self);
+	ASSERT(s);
+
+	self->s0[lane] = s[0];
+	self->s1[lane] = s[1];
+	self->s2[lane] = s[2];
+	self->s3[lane] = s[3];
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+void cc_rngXoshiro_initSeed(cc_rngXoshiro_t* self,
+                            uint64_t initstate,
+                            uint64_t initseq)
+{
+	ASSERT(self);
+
+	// seed the first lane with splitmix64 and derive the
+	// remaining lanes with the 2^64 jump
+	uint64_t x  = initstate ^
+	              (initseq*0xd1342543de82ef95ULL);
+	uint64_t a  = cc_rngXoshiro_splitmix64(&x);
+	uint64_t b  = cc_rngXoshiro_splitmix64(&x);
+	uint32_t s[4] =
+	{
+		(uint32_t) a, (uint32_t) (a >> 32),
+		(uint32_t) b, (uint32_t) (b >> 32),
+	};
+
+	// the all-zero state is invalid
+	if((s[0] | s[1] | s[2] | s[3]) == 0)
+	{
+		s[0] = 1;
+	}
+
+	int i;
+	for(i = 0; i < CC_RNGXOSHIRO_LANES; ++i)
+	{
+		cc_rngXoshiro_setLane(self, i, s);
+		cc_rngXoshiro_jump1(s, CC_RNGXOSHIRO_JUMP);
+	}
+}
+
+void cc_rngXoshiro_jump(cc_rngXoshiro_t* self)
+{
+	ASSERT(self);
+
+	uint32_t s[4];
+
+	int i;
+	for(i = 0; i < CC_RNGXOSHIRO_LANES; ++i)
+	{
+		cc_rngXoshiro_getLane(self, i, s);
+		cc_rngXoshiro_jump1(s, CC_RNGXOSHIRO_LONGJUMP);
+		cc_rngXoshiro_setLane(self, i, s);
+	}
+}
+
+void cc_rngXoshiro_next(cc_rngXoshiro_t* self,
+                        uint32_t* out)
+{
+	ASSERT(self);
+	ASSERT(out);
+
+	// the lane loops have no dependencies between lanes
+	uint32_t* s0 = self->s0;
+	uint32_t* s1 = self->s1;
+	uint32_t* s2 = self->s2;
+	uint32_t* s3 = self->s3;
+	uint32_t  t;
+
+	int i;
+	for(i = 0; i < CC_RNGXOSHIRO_LANES; ++i)
+	{
+		out[i] = cc_rngXoshiro_rotl(s1[i]*5, 7)*9;
+		t      = s1[i] << 9;
+		s2[i] ^= s0[i];
+		s3[i] ^= s1[i];
+		s1[i] ^= s2[i];
+		s0[i] ^= s3[i];
+		s2[i] ^= t;
+		s3[i]  = cc_rngXoshiro_rotl(s3[i], 11);
+	}
+}
+
+void cc_rngXoshiro_fillU(cc_rngXoshiro_t* self,
+                         int count, uint32_t* out)
+{
+	ASSERT(self);
+	ASSERT(out || (count == 0));
+
+	int i = 0;
+	for(; i + CC_RNGXOSHIRO_LANES <= count;
+	    i += CC_RNGXOSHIRO_LANES)
+	{
+		cc_rngXoshiro_next(self, &out[i]);
+	}
+
+	// the unused outputs of the last step are discarded
+	if(i < count)
+	{
+		uint32_t tmp[CC_RNGXOSHIRO_LANES];
+		cc_rngXoshiro_next(self, tmp);
+		memcpy(&out[i], tmp, (count - i)*sizeof(uint32_t));
+	}
+}
+
+void cc_rngXoshiro_fillF(cc_rngXoshiro_t* self,
+                         int count, float* out,
+                         float min, float max)
+{
+	ASSERT(self);
+	ASSERT(out || (count == 0));
+
+	// [min, max) from the upper 24 bits which are exactly
+	// representable as floats but the scale and offset may
+	// still round up to max so the result is clamped
+	uint32_t u[CC_RNGXOSHIRO_LANES];
+	float    scale = (max - min)/16777216.0f;
+	float    top   = nextafterf(max, min);
+	float    f;
+
+	int i = 0;
+	int j;
+	int n;
+	while(i < count)
+	{
+		cc_rngXoshiro_next(self, u);
+
+		n = count - i;
+		if(n > CC_RNGXOSHIRO_LANES)
+		{
+			n = CC_RNGXOSHIRO_LANES;
+		}
+
+		for(j = 0; j < n; ++j)
+		{
+			f = ((float) (u[j] >> 8))*scale + min;
+			out[i + j] = (f > top) ? top : f;
+		}
+		i += n;
+	}
+}
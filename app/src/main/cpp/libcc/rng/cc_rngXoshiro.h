@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef cc_rngXoshiro_H
+#define cc_rngXoshiro_H
+
+#include <stdint.h>
+
+// multi-lane xoshiro128** generator for bulk random numbers
+// https://prng.di.unimi.it/
+//
+// the lanes are stored as structure-of-arrays so that one
+// step of all lanes may be vectorized by the compiler and
+// each lane is 2^64 steps ahead of the previous lane
+//
+// jump advances all lanes by 2^96 steps which may be used
+// to create non-overlapping per-thread streams by copying
+// a generator and jumping the copy
+
+#define CC_RNGXOSHIRO_LANES 8
+
+typedef struct
+{
+	uint32_t s0[CC_RNGXOSHIRO_LANES];
+	uint32_t s1[CC_RNGXOSHIRO_LANES];
+	uint32_t s2[CC_RNGXOSHIRO_LANES];
+	uint32_t s3[CC_RNGXOSHIRO_LANES];
+} cc_rngXoshiro_t;
+
+void cc_rngXoshiro_initSeed(cc_rngXoshiro_t* self,
+                            uint64_t initstate,
+                            uint64_t initseq);
+void cc_rngXoshiro_jump(cc_rngXoshiro_t* self);
+void cc_rngXoshiro_next(cc_rngXoshiro_t* self,
+                        uint32_t* out);
+void cc_rngXoshiro_fillU(cc_rngXoshiro_t* self,
+                         int count, uint32_t* out);
+void cc_rngXoshiro_fillF(cc_rngXoshiro_t* self,
+                         int count, float* out,
+                         float min, float max);
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#define LOG_TAG "list-test"
+#include "libcc/cc_list.h"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+
+#define TEST_LIST_THREADS 64
+#define TEST_LIST_LISTS   8
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+typedef struct
+{
+	int iterations;
+	int length;
+	int errors;
+} test_thread_t;
+
+static void* test_thread(void* arg)
+{
+	ASSERT(arg);
+
+	test_thread_t* self = (test_thread_t*) arg;
+
+	// thread-private lists which are created, filled,
+	// drained and deleted to exercise the listIter pool
+	int i;
+	int j;
+	int k;
+	cc_listIter_t* iter;
+	cc_list_t*     lists[TEST_LIST_LISTS];
+	for(i = 0; i < self->iterations; ++i)
+	{
+		for(k = 0; k < TEST_LIST_LISTS; ++k)
+		{
+			lists[k] = cc_list_new();
+			if(lists[k] == NULL)
+			{
+				++self->errors;
+				return NULL;
+			}
+
+			for(j = 0; j < self->length; ++j)
+			{
+				if(cc_list_append(lists[k], NULL,
+				                  (const void*) self) == NULL)
+				{
+					++self->errors;
+				}
+			}
+		}
+
+		for(k = 0; k < TEST_LIST_LISTS; ++k)
+		{
+			if(cc_list_size(lists[k]) != self->length)
+			{
+				++self->errors;
+			}
+
+			iter = cc_list_head(lists[k]);
+			while(iter)
+			{
+				cc_list_remove(lists[k], &iter);
+			}
+			cc_list_delete(&lists[k]);
+		}
+	}
+
+	return NULL;
+}
+
+static double
+test_run(int thread_count, int iterations, int length,
+         int* errors)
+{
+	ASSERT(errors);
+
+	pthread_t     threads[TEST_LIST_THREADS];
+	test_thread_t state[TEST_LIST_THREADS];
+
+	double t0 = cc_timestamp();
+
+	int i;
+	for(i = 0; i < thread_count; ++i)
+	{
+		state[i].iterations = iterations;
+		state[i].length     = length;
+		state[i].errors     = 0;
+		if(pthread_create(&threads[i], NULL, test_thread,
+		                  (void*) &state[i]) != 0)
+		{
+			LOGE("pthread_create failed");
+			thread_count = i;
+			break;
+		}
+	}
+
+	for(i = 0; i < thread_count; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		*errors += state[i].errors;
+	}
+
+	double dt = cc_timestamp() - t0;
+
+	// count append and remove operations
+	return 2.0*((double) thread_count)*((double) iterations)*
+	       ((double) (TEST_LIST_LISTS*length))/dt;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int thread_count = 4;
+	int iterations   = 10000;
+	int length       = 100;
+	if(argc >= 2)
+	{
+		thread_count = (int) strtol(argv[1], NULL, 0);
+	}
+	if(argc >= 3)
+	{
+		iterations = (int) strtol(argv[2], NULL, 0);
+	}
+	if(argc >= 4)
+	{
+		length = (int) strtol(argv[3], NULL, 0);
+	}
+
+	if((argc > 4) || (thread_count < 1) ||
+	   (thread_count > TEST_LIST_THREADS) ||
+	   (iterations < 1) || (length < 1))
+	{
+		LOGE("usage: %s [threads] [iterations] [length]",
+		     argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	int n;
+	int errors = 0;
+	for(n = 1; n <= thread_count; n *= 2)
+	{
+		double ops = test_run(n, iterations, length, &errors);
+		LOGI("threads=%i, ops=%.1f Mops/s, ops/thread=%.1f Mops/s",
+		     n, ops/1.0e6, ops/(1.0e6*n));
+	}
+
+	// verify that all lists and blocks were released
+	if(errors || (cc_memcount() != 0) || (cc_memsize() != 0))
+	{
+		LOGE("errors=%i", errors);
+		MEMINFO();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
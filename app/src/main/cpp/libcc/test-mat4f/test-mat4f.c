@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#define LOG_TAG "mat4f-test"
+#include "libcc/cc_log.h"
+#include "libcc/cc_timestamp.h"
+#include "libcc/math/cc_mat4f.h"
+
+#define TEST_MAT4F_COUNT 1024
+
+/***********************************************************
+* private - reference implementation                       *
+***********************************************************/
+
+// the reference functions are not inlined so that they are
+// measured as out-of-line calls like the library functions
+
+static __attribute__((noinline)) void
+ref_mulm_copy(const cc_mat4f_t* a, const cc_mat4f_t* m,
+              cc_mat4f_t* c)
+{
+	c->m00 = a->m00*m->m00 + a->m01*m->m10 + a->m02*m->m20 + a->m03*m->m30;
+	c->m01 = a->m00*m->m01 + a->m01*m->m11 + a->m02*m->m21 + a->m03*m->m31;
+	c->m02 = a->m00*m->m02 + a->m01*m->m12 + a->m02*m->m22 + a->m03*m->m32;
+	c->m03 = a->m00*m->m03 + a->m01*m->m13 + a->m02*m->m23 + a->m03*m->m33;
+	c->m10 = a->m10*m->m00 + a->m11*m->m10 + a->m12*m->m20 + a->m13*m->m30;
+	c->m11 = a->m10*m->m01 + a->m11*m->m11 + a->m12*m->m21 + a->m13*m->m31;
+	c->m12 = a->m10*m->m02 + a->m11*m->m12 + a->m12*m->m22 + a->m13*m->m32;
+	c->m13 = a->m10*m->m03 + a->m11*m->m13 + a->m12*m->m23 + a->m13*m->m33;
+	c->m20 = a->m20*m->m00 + a->m21*m->m10 + a->m22*m->m20 + a->m23*m->m30;
+	c->m21 = a->m20*m->m01 + a->m21*m->m11 + a->m22*m->m21 + a->m23*m->m31;
+	c->m22 = a->m20*m->m02 + a->m21*m->m12 + a->m22*m->m22 + a->m23*m->m32;
+	c->m23 = a->m20*m->m03 + a->m21*m->m13 + a->m22*m->m23 + a->m23*m->m33;
+	c->m30 = a->m30*m->m00 + a->m31*m->m10 + a->m32*m->m20 + a->m33*m->m30;
+	c->m31 = a->m30*m->m01 + a->m31*m->m11 + a->m32*m->m21 + a->m33*m->m31;
+	c->m32 = a->m30*m->m02 + a->m31*m->m12 + a->m32*m->m22 + a->m33*m->m32;
+	c->m33 = a->m30*m->m03 + a->m31*m->m13 + a->m32*m->m23 + a->m33*m->m33;
+}
+
+static __attribute__((noinline)) void
+ref_mulv_copy(const cc_mat4f_t* a, const cc_vec4f_t* v,
+              cc_vec4f_t* c)
+{
+	c->x = a->m00*v->x + a->m01*v->y + a->m02*v->z + a->m03*v->w;
+	c->y = a->m10*v->x + a->m11*v->y + a->m12*v->z + a->m13*v->w;
+	c->z = a->m20*v->x + a->m21*v->y + a->m22*v->z + a->m23*v->w;
+	c->w = a->m30*v->x + a->m31*v->y + a->m32*v->z + a->m33*v->w;
+}
+
+// gauss-jordan elimination with partial pivoting
+static __attribute__((noinline)) void
+ref_inverse_copy(const cc_mat4f_t* self, cc_mat4f_t* copy)
+{
+	cc_mat4f_t a;
+	cc_mat4f_copy(self, &a);
+	cc_mat4f_identity(copy);
+
+	float* aref = (float*) &a;
+	float* vref = (float*) copy;
+	#define A(row, col) aref[(row) + 4*(col)]
+	#define V(row, col) vref[(row) + 4*(col)]
+
+	int   i;
+	int   j;
+	int   l;
+	int   k;
+	float x;
+	float s;
+	for(j = 0; j < 4; ++j)
+	{
+		l = j;
+		for(i = j + 1; i < 4; ++i)
+		{
+			if(fabs(A(i,j)) > fabs(A(l,j)))
+			{
+				l = i;
+			}
+		}
+
+		if(l != j)
+		{
+			for(k = 0; k < 4; ++k)
+			{
+				x      = A(j,k);
+				A(j,k) = A(l,k);
+				A(l,k) = x;
+				x      = V(j,k);
+				V(j,k) = V(l,k);
+				V(l,k) = x;
+			}
+		}
+
+		for(i = j + 1; i < 4; ++i)
+		{
+			s = A(i,j)/A(j,j);
+			for(k = j + 1; k < 4; ++k)
+			{
+				A(i,k) -= s*A(j,k);
+			}
+			for(k = 0; k < 4; ++k)
+			{
+				V(i,k) -= s*V(j,k);
+			}
+			A(i,j) = 0.0f;
+		}
+
+		s = 1.0f/A(j,j);
+		for(k = j + 1; k < 4; ++k)
+		{
+			A(j,k) *= s;
+		}
+		for(k = 0; k < 4; ++k)
+		{
+			V(j,k) *= s;
+		}
+		A(j,j) = 1.0f;
+	}
+
+	for(j = 3; j > 0; --j)
+	{
+		for(i = j - 1; i >= 0; --i)
+		{
+			s = A(i,j);
+			for(k = j; k < 4; ++k)
+			{
+				A(i,k) -= s*A(j,k);
+			}
+			for(k = 0; k < 4; ++k)
+			{
+				V(i,k) -= s*V(j,k);
+			}
+		}
+	}
+
+	#undef A
+	#undef V
+}
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static float test_random(void)
+{
+	return 2.0f*((float) rand())/((float) RAND_MAX) - 1.0f;
+}
+
+// model-view style transforms similar to gear/vg paths
+static void test_transform(cc_mat4f_t* self)
+{
+	ASSERT(self);
+
+	cc_mat4f_translate(self, 1, 10.0f*test_random(),
+	                   10.0f*test_random(),
+	                   10.0f*test_random());
+	cc_mat4f_rotate(self, 0, 180.0f*test_random(),
+	                test_random(), test_random(), 1.0f);
+	cc_mat4f_scale(self, 0, 1.5f + test_random(),
+	               1.5f + test_random(),
+	               1.5f + test_random());
+}
+
+static float
+test_error(const float* a, const float* b, int count)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	float e;
+	float err = 0.0f;
+	int   i;
+	for(i = 0; i < count; ++i)
+	{
+		e = fabsf(a[i] - b[i])/(1.0f + fabsf(b[i]));
+		if(e > err)
+		{
+			err = e;
+		}
+	}
+	return err;
+}
+
+static void
+test_log(const char* name, double t_ref, double t_new,
+         int iterations, float err)
+{
+	ASSERT(name);
+
+	double n = ((double) iterations)*TEST_MAT4F_COUNT;
+	LOGI("%s: ref=%.1f ns, new=%.1f ns, speedup=%.2f, err=%g",
+	     name, 1.0e9*t_ref/n, 1.0e9*t_new/n, t_ref/t_new,
+	     (double) err);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int iterations = 1000;
+	if(argc >= 2)
+	{
+		iterations = (int) strtol(argv[1], NULL, 0);
+	}
+
+	if((argc > 2) || (iterations < 1))
+	{
+		LOGE("usage: %s [iterations]", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	static cc_mat4f_t m[TEST_MAT4F_COUNT];
+	static cc_mat4f_t c_ref[TEST_MAT4F_COUNT];
+	static cc_mat4f_t c_new[TEST_MAT4F_COUNT];
+	static cc_vec4f_t v[TEST_MAT4F_COUNT];
+	static cc_vec4f_t v_ref[TEST_MAT4F_COUNT];
+	static cc_vec4f_t v_new[TEST_MAT4F_COUNT];
+
+	int i;
+	for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+	{
+		test_transform(&m[i]);
+		cc_vec4f_load(&v[i], 10.0f*test_random(),
+		              10.0f*test_random(),
+		              10.0f*test_random(), 1.0f);
+	}
+
+	cc_mat4f_t mvm;
+	test_transform(&mvm);
+
+	int    j;
+	int    ret = EXIT_SUCCESS;
+	float  err;
+	double t0;
+	double t_ref;
+	double t_new;
+	int    count = 16*TEST_MAT4F_COUNT;
+
+	// mulm
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			ref_mulm_copy(&mvm, &m[i], &c_ref[i]);
+		}
+	}
+	t_ref = cc_timestamp() - t0;
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			cc_mat4f_mulm_copy(&mvm, &m[i], &c_new[i]);
+		}
+	}
+	t_new = cc_timestamp() - t0;
+	err   = test_error((float*) c_new, (float*) c_ref, count);
+	test_log("mulm", t_ref, t_new, iterations, err);
+	ret   = (err > 1.0e-5f) ? EXIT_FAILURE : ret;
+
+	// mulmArray
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		cc_mat4f_mulmArray(&mvm, TEST_MAT4F_COUNT, m, c_new);
+	}
+	t_new = cc_timestamp() - t0;
+	err   = test_error((float*) c_new, (float*) c_ref, count);
+	test_log("mulmArray", t_ref, t_new, iterations, err);
+	ret   = (err > 1.0e-5f) ? EXIT_FAILURE : ret;
+
+	// mulv
+	count = 4*TEST_MAT4F_COUNT;
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			ref_mulv_copy(&mvm, &v[i], &v_ref[i]);
+		}
+	}
+	t_ref = cc_timestamp() - t0;
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			cc_mat4f_mulv_copy(&mvm, &v[i], &v_new[i]);
+		}
+	}
+	t_new = cc_timestamp() - t0;
+	err   = test_error((float*) v_new, (float*) v_ref, count);
+	test_log("mulv", t_ref, t_new, iterations, err);
+	ret   = (err > 1.0e-5f) ? EXIT_FAILURE : ret;
+
+	// mulvArray
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		cc_mat4f_mulvArray(&mvm, TEST_MAT4F_COUNT, v, v_new);
+	}
+	t_new = cc_timestamp() - t0;
+	err   = test_error((float*) v_new, (float*) v_ref, count);
+	test_log("mulvArray", t_ref, t_new, iterations, err);
+	ret   = (err > 1.0e-5f) ? EXIT_FAILURE : ret;
+
+	// inverse
+	count = 16*TEST_MAT4F_COUNT;
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			ref_inverse_copy(&m[i], &c_ref[i]);
+		}
+	}
+	t_ref = cc_timestamp() - t0;
+	t0 = cc_timestamp();
+	for(j = 0; j < iterations; ++j)
+	{
+		for(i = 0; i < TEST_MAT4F_COUNT; ++i)
+		{
+			cc_mat4f_inverse_copy(&m[i], &c_new[i]);
+		}
+	}
+	t_new = cc_timestamp() - t0;
+	err   = test_error((float*) c_new, (float*) c_ref, count);
+	test_log("inverse", t_ref, t_new, iterations, err);
+	ret   = (err > 1.0e-4f) ? EXIT_FAILURE : ret;
+
+	return ret;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "memory-test"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+
+#define TEST_MEMORY_SLOTS   256
+#define TEST_MEMORY_THREADS 64
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// the mutex mode reproduces the previous cc_malloc/cc_free
+// implementation which updated global counters under a
+// single mutex for every allocation
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t          g_count = 0;
+static size_t          g_size  = 0;
+
+typedef struct
+{
+	size_t size;
+} test_memory_t;
+
+static void* test_malloc(size_t size)
+{
+	test_memory_t* mem;
+	mem = (test_memory_t*)
+	      malloc(size + sizeof(test_memory_t));
+	if(mem == NULL)
+	{
+		return NULL;
+	}
+	mem->size = size;
+
+	pthread_mutex_lock(&g_mutex);
+	++g_count;
+	g_size += size;
+	pthread_mutex_unlock(&g_mutex);
+
+	return (void*) mem + sizeof(test_memory_t);
+}
+
+static void test_free(void* ptr)
+{
+	if(ptr)
+	{
+		test_memory_t* mem = ptr - sizeof(test_memory_t);
+
+		pthread_mutex_lock(&g_mutex);
+		--g_count;
+		g_size -= mem->size;
+		pthread_mutex_unlock(&g_mutex);
+
+		free(mem);
+	}
+}
+
+typedef struct
+{
+	int  mode;
+	int  iterations;
+	unsigned int seed;
+} test_thread_t;
+
+static void* test_thread(void* arg)
+{
+	ASSERT(arg);
+
+	test_thread_t* self = (test_thread_t*) arg;
+
+	// alloc/free random small sizes from a bounded
+	// working set to simulate typical node allocations
+	void* slots[TEST_MEMORY_SLOTS];
+	memset(slots, 0, sizeof(slots));
+
+	int i;
+	int idx;
+	size_t size;
+	for(i = 0; i < self->iterations; ++i)
+	{
+		idx  = rand_r(&self->seed)%TEST_MEMORY_SLOTS;
+		size = 8 + rand_r(&self->seed)%248;
+		if(self->mode)
+		{
+			FREE(slots[idx]);
+			slots[idx] = MALLOC(size);
+		}
+		else
+		{
+			test_free(slots[idx]);
+			slots[idx] = test_malloc(size);
+		}
+	}
+
+	for(i = 0; i < TEST_MEMORY_SLOTS; ++i)
+	{
+		if(self->mode)
+		{
+			FREE(slots[i]);
+		}
+		else
+		{
+			test_free(slots[i]);
+		}
+	}
+
+	return NULL;
+}
+
+static double
+test_run(int mode, int thread_count, int iterations)
+{
+	pthread_t     threads[TEST_MEMORY_THREADS];
+	test_thread_t state[TEST_MEMORY_THREADS];
+
+	double t0 = cc_timestamp();
+
+	int i;
+	for(i = 0; i < thread_count; ++i)
+	{
+		state[i].mode       = mode;
+		state[i].iterations = iterations;
+		state[i].seed       = (unsigned int) (i + 1);
+		if(pthread_create(&threads[i], NULL, test_thread,
+		                  (void*) &state[i]) != 0)
+		{
+			LOGE("pthread_create failed");
+			thread_count = i;
+			break;
+		}
+	}
+
+	for(i = 0; i < thread_count; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	double dt = cc_timestamp() - t0;
+	return ((double) thread_count)*((double) iterations)/dt;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int thread_count = 4;
+	int iterations   = 1000000;
+	if(argc >= 2)
+	{
+		thread_count = (int) strtol(argv[1], NULL, 0);
+	}
+	if(argc >= 3)
+	{
+		iterations = (int) strtol(argv[2], NULL, 0);
+	}
+
+	if((argc > 3) || (thread_count < 1) ||
+	   (thread_count > TEST_MEMORY_THREADS) ||
+	   (iterations < 1))
+	{
+		LOGE("usage: %s [threads] [iterations]", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	int n;
+	for(n = 1; n <= thread_count; n *= 2)
+	{
+		double ops_mutex = test_run(0, n, iterations);
+		double ops_cache = test_run(1, n, iterations);
+		LOGI("threads=%i, mutex=%.1f Mops/s, cache=%.1f Mops/s, speedup=%.2fx",
+		     n, ops_mutex/1.0e6, ops_cache/1.0e6,
+		     ops_cache/ops_mutex);
+	}
+
+	// verify that all memory was released
+	if((cc_memcount() != 0) || (cc_memsize() != 0))
+	{
+		LOGE("memory leak detected");
+		MEMINFO();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
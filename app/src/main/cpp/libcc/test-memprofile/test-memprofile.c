@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_TAG "memprofile-test"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+
+#define TEST_MEMPROFILE_SLOTS 64
+#define TEST_MEMPROFILE_PAIRS 8
+#define TEST_MEMPROFILE_SIZE  4096
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// blocks are allocated by the producer and passed to the
+// consumer which frees them on a different thread
+typedef struct
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	int             iterations;
+	int             head;
+	int             tail;
+	void*           slots[TEST_MEMPROFILE_SLOTS];
+} test_pair_t;
+
+static int g_done = 0;
+
+static void* test_producer(void* arg)
+{
+	ASSERT(arg);
+
+	test_pair_t* self = (test_pair_t*) arg;
+
+	int   i;
+	void* ptr;
+	for(i = 0; i < self->iterations; ++i)
+	{
+		ptr = MALLOC(TEST_MEMPROFILE_SIZE);
+
+		pthread_mutex_lock(&self->mutex);
+		while(self->head - self->tail >= TEST_MEMPROFILE_SLOTS)
+		{
+			pthread_cond_wait(&self->cond, &self->mutex);
+		}
+		self->slots[self->head%TEST_MEMPROFILE_SLOTS] = ptr;
+		++self->head;
+		pthread_cond_broadcast(&self->cond);
+		pthread_mutex_unlock(&self->mutex);
+	}
+
+	return NULL;
+}
+
+static void* test_consumer(void* arg)
+{
+	ASSERT(arg);
+
+	test_pair_t* self = (test_pair_t*) arg;
+
+	int   i;
+	void* ptr;
+	for(i = 0; i < self->iterations; ++i)
+	{
+		pthread_mutex_lock(&self->mutex);
+		while(self->head == self->tail)
+		{
+			pthread_cond_wait(&self->cond, &self->mutex);
+		}
+		ptr = self->slots[self->tail%TEST_MEMPROFILE_SLOTS];
+		++self->tail;
+		pthread_cond_broadcast(&self->cond);
+		pthread_mutex_unlock(&self->mutex);
+
+		FREE(ptr);
+	}
+
+	__atomic_add_fetch(&g_done, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+static int test_profileEmpty(const char* fname)
+{
+	ASSERT(fname);
+
+	if(MEMPROFILE(fname) == 0)
+	{
+		return 0;
+	}
+
+	FILE* f = fopen(fname, "r");
+	if(f == NULL)
+	{
+		LOGE("fopen %s failed", fname);
+		return 0;
+	}
+
+	int  empty = 1;
+	char line[256];
+	while(fgets(line, 256, f))
+	{
+		LOGE("live sample: %s", line);
+		empty = 0;
+	}
+	fclose(f);
+
+	return empty;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int iterations = 100000;
+	if(argc >= 2)
+	{
+		iterations = (int) strtol(argv[1], NULL, 0);
+	}
+
+	if((argc > 2) || (iterations < 1))
+	{
+		LOGE("usage: %s [iterations]", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const char* fname = "test-memprofile.txt";
+
+	pthread_t   producers[TEST_MEMPROFILE_PAIRS];
+	pthread_t   consumers[TEST_MEMPROFILE_PAIRS];
+	test_pair_t pairs[TEST_MEMPROFILE_PAIRS];
+
+	int i;
+	for(i = 0; i < TEST_MEMPROFILE_PAIRS; ++i)
+	{
+		pthread_mutex_init(&pairs[i].mutex, NULL);
+		pthread_cond_init(&pairs[i].cond, NULL);
+		pairs[i].iterations = iterations;
+		pairs[i].head       = 0;
+		pairs[i].tail       = 0;
+		if((pthread_create(&consumers[i], NULL, test_consumer,
+		                   (void*) &pairs[i]) != 0) ||
+		   (pthread_create(&producers[i], NULL, test_producer,
+		                   (void*) &pairs[i]) != 0))
+		{
+			LOGE("pthread_create failed");
+			return EXIT_FAILURE;
+		}
+	}
+
+	// drain the samples concurrently with the workers so
+	// frees may be drained before the matching allocs
+	while(__atomic_load_n(&g_done, __ATOMIC_ACQUIRE) <
+	      TEST_MEMPROFILE_PAIRS)
+	{
+		MEMPROFILE(fname);
+	}
+
+	for(i = 0; i < TEST_MEMPROFILE_PAIRS; ++i)
+	{
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+		pthread_mutex_destroy(&pairs[i].mutex);
+		pthread_cond_destroy(&pairs[i].cond);
+	}
+
+	// verify that no freed blocks remain in the profile
+	if(test_profileEmpty(fname) == 0)
+	{
+		LOGE("memprofile leak detected");
+		return EXIT_FAILURE;
+	}
+
+	LOGI("memprofile ok");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2026 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LOG_TAG "ring-test"
+#include "libcc/cc_list.h"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_ring.h"
+#include "libcc/cc_timestamp.h"
+
+#define TEST_RING_THREADS 16
+#define TEST_RING_SHIFT   24
+
+#define TEST_RING_MODE_LIST  0
+#define TEST_RING_MODE_SPIN  1
+#define TEST_RING_MODE_BLOCK 2
+
+static const char* TEST_RING_MODE_NAME[] =
+{
+	"list+mutex",
+	"ring+spin",
+	"ring+futex",
+};
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+// the baseline is the cc_list plus mutex/cond pattern used
+// for producer/consumer handoff throughout the codebase
+typedef struct
+{
+	int             mode;
+	cc_ring_t*      ring;
+	cc_list_t*      list;
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	int             count;
+} test_queue_t;
+
+typedef struct
+{
+	test_queue_t* queue;
+	int           id;
+	int           errors;
+} test_thread_t;
+
+static int
+test_queue_push(test_queue_t* self, const void* data)
+{
+	ASSERT(self);
+	ASSERT(data);
+
+	if(self->mode == TEST_RING_MODE_LIST)
+	{
+		pthread_mutex_lock(&self->mutex);
+		if(cc_list_append(self->list, NULL, data) == NULL)
+		{
+			pthread_mutex_unlock(&self->mutex);
+			return 0;
+		}
+		pthread_cond_signal(&self->cond);
+		pthread_mutex_unlock(&self->mutex);
+	}
+	else if(self->mode == TEST_RING_MODE_SPIN)
+	{
+		while(cc_ring_push(self->ring, data) == 0)
+		{
+			sched_yield();
+		}
+	}
+	else
+	{
+		cc_ring_pushWait(self->ring, data);
+	}
+
+	return 1;
+}
+
+static const void* test_queue_pop(test_queue_t* self)
+{
+	ASSERT(self);
+
+	const void* data = NULL;
+	if(self->mode == TEST_RING_MODE_LIST)
+	{
+		pthread_mutex_lock(&self->mutex);
+		while(cc_list_size(self->list) == 0)
+		{
+			pthread_cond_wait(&self->cond, &self->mutex);
+		}
+		cc_listIter_t* iter = cc_list_head(self->list);
+		data = cc_list_remove(self->list, &iter);
+		pthread_mutex_unlock(&self->mutex);
+	}
+	else if(self->mode == TEST_RING_MODE_SPIN)
+	{
+		while((data = cc_ring_pop(self->ring)) == NULL)
+		{
+			sched_yield();
+		}
+	}
+	else
+	{
+		while((data = cc_ring_popWait(self->ring)) == NULL)
+		{
+			// woken without data
+		}
+	}
+
+	return data;
+}
+
+static void* test_producer(void* arg)
+{
+	ASSERT(arg);
+
+	test_thread_t* self  = (test_thread_t*) arg;
+	test_queue_t*  queue = self->queue;
+
+	// items encode the producer id and sequence number so
+	// the consumer can verify the per-producer FIFO order
+	uintptr_t item;
+	int i;
+	for(i = 0; i < queue->count; ++i)
+	{
+		item = (((uintptr_t) self->id) << TEST_RING_SHIFT) |
+		       ((uintptr_t) (i + 1));
+		if(test_queue_push(queue, (const void*) item) == 0)
+		{
+			++self->errors;
+		}
+	}
+
+	return NULL;
+}
+
+static double
+test_run(int mode, int producers, int count, int capacity,
+         int* errors)
+{
+	ASSERT(errors);
+
+	pthread_t     threads[TEST_RING_THREADS];
+	test_thread_t state[TEST_RING_THREADS];
+	int           last[TEST_RING_THREADS];
+
+	test_queue_t queue =
+	{
+		.mode  = mode,
+		.count = count,
+	};
+
+	if(mode == TEST_RING_MODE_LIST)
+	{
+		queue.list = cc_list_new();
+		if(queue.list == NULL)
+		{
+			++(*errors);
+			return 0.0;
+		}
+		pthread_mutex_init(&queue.mutex, NULL);
+		pthread_cond_init(&queue.cond, NULL);
+	}
+	else
+	{
+		if(producers == 1)
+		{
+			queue.ring = cc_ring_new(capacity);
+		}
+		else
+		{
+			queue.ring = cc_ring_newMPSC(capacity);
+		}
+
+		if(queue.ring == NULL)
+		{
+			++(*errors);
+			return 0.0;
+		}
+	}
+
+	double t0 = cc_timestamp();
+
+	int i;
+	for(i = 0; i < producers; ++i)
+	{
+		state[i].queue  = &queue;
+		state[i].id     = i;
+		state[i].errors = 0;
+		last[i]         = 0;
+		if(pthread_create(&threads[i], NULL, test_producer,
+		                  (void*) &state[i]) != 0)
+		{
+			LOGE("pthread_create failed");
+			producers = i;
+			++(*errors);
+			break;
+		}
+	}
+
+	// consume on the main thread
+	uintptr_t item;
+	int id;
+	int seq;
+	int total = producers*count;
+	for(i = 0; i < total; ++i)
+	{
+		item = (uintptr_t) test_queue_pop(&queue);
+		id   = (int) (item >> TEST_RING_SHIFT);
+		seq  = (int) (item & ((1 << TEST_RING_SHIFT) - 1));
+		if((id >= producers) || (seq != last[id] + 1))
+		{
+			++(*errors);
+		}
+		else
+		{
+			last[id] = seq;
+		}
+	}
+
+	for(i = 0; i < producers; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		*errors += state[i].errors;
+	}
+
+	double dt = cc_timestamp() - t0;
+
+	if(mode == TEST_RING_MODE_LIST)
+	{
+		pthread_cond_destroy(&queue.cond);
+		pthread_mutex_destroy(&queue.mutex);
+		cc_list_delete(&queue.list);
+	}
+	else
+	{
+		cc_ring_delete(&queue.ring);
+	}
+
+	return ((double) total)/dt;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+int main(int argc, char** argv)
+{
+	int producers = 4;
+	int count     = 1000000;
+	int capacity  = 1024;
+	if(argc >= 2)
+	{
+		producers = (int) strtol(argv[1], NULL, 0);
+	}
+	if(argc >= 3)
+	{
+		count = (int) strtol(argv[2], NULL, 0);
+	}
+	if(argc >= 4)
+	{
+		capacity = (int) strtol(argv[3], NULL, 0);
+	}
+
+	if((argc > 4) || (producers < 1) ||
+	   (producers > TEST_RING_THREADS) || (count < 1) ||
+	   (count >= (1 << TEST_RING_SHIFT)) || (capacity < 1))
+	{
+		LOGE("usage: %s [producers] [count] [capacity]",
+		     argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	int n;
+	int mode;
+	int errors = 0;
+	double ops;
+	for(n = 1; n <= producers; n *= 2)
+	{
+		for(mode = TEST_RING_MODE_LIST;
+		    mode <= TEST_RING_MODE_BLOCK; ++mode)
+		{
+			ops = test_run(mode, n, count, capacity, &errors);
+			LOGI("producers=%i, mode=%s, ops=%.1f Mops/s",
+			     n, TEST_RING_MODE_NAME[mode], ops/1.0e6);
+		}
+	}
+
+	// verify that all queues were released
+	if(errors || (cc_memcount() != 0) || (cc_memsize() != 0))
+	{
+		LOGE("errors=%i", errors);
+		MEMINFO();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
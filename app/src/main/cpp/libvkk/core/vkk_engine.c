@@ -1622,13 +1622,13 @@ vkk_engine_t* vkk_engine_new(vkk_platform_t* platform,
 		goto fail_pipeline_cache;
 	}
 
-	self->shader_modules = cc_map_new();
+	self->shader_modules = cc_map_newFlat();
 	if(self->shader_modules == NULL)
 	{
 		goto fail_shader_modules;
 	}
 
-	self->samplers = cc_map_new();
+	self->samplers = cc_map_newFlat();
 	if(self->samplers == NULL)
 	{
 		goto fail_samplers;
@@ -689,7 +689,7 @@ vkk_uiScreen_new(size_t wsize,
 		goto fail_depth_dirty;
 	}
 
-	self->sprite_map = cc_map_new();
+	self->sprite_map = cc_map_newFlat();
 	if(self->sprite_map == NULL)
 	{
 		goto fail_sprite_map;
@@ -1970,9 +1970,10 @@ vkk_uiScreen_spriteImage(vkk_uiScreen_t* self,
 		return NULL;
 	}
 
-	size_t size = 0;
-	void*  data = NULL;
-	if(bfs_file_blobGet(bfs, 0, name,
+	// decode directly from the store
+	size_t      size = 0;
+	const void* data = NULL;
+	if(bfs_file_blobMap(bfs, 0, name,
 	                    &size, &data) == 0)
 	{
 		goto fail_get;
@@ -1982,6 +1983,7 @@ vkk_uiScreen_spriteImage(vkk_uiScreen_t* self,
 	if(size == 0)
 	{
 		LOGE("invalid %s", name);
+		bfs_file_blobUnmap(bfs, 0);
 		goto fail_empty;
 	}
 
@@ -1998,6 +2000,7 @@ vkk_uiScreen_spriteImage(vkk_uiScreen_t* self,
 	{
 		tex = texgz_tex_importd(size, data);
 	}
+	bfs_file_blobUnmap(bfs, 0);
 
 	if(tex == NULL)
 	{
@@ -2106,7 +2109,6 @@ vkk_uiScreen_spriteImage(vkk_uiScreen_t* self,
 		texgz_tex_delete(&tex);
 	}
 
-	FREE(data);
 	bfs_file_close(&bfs);
 
 	// success
@@ -2121,7 +2123,6 @@ vkk_uiScreen_spriteImage(vkk_uiScreen_t* self,
 		texgz_tex_delete(&tex);
 	fail_tex:
 	fail_empty:
-		FREE(data);
 	fail_get:
 		bfs_file_close(&bfs);
 	return NULL;